@@ -0,0 +1,9 @@
+#include "dense_physics.h"
+#include "dense_physics.tcc"
+
+// contains template instantiations for the 2-dimensional case
+//   to create pre-compiled object files
+
+template class BodyHandle<float, 2u>;
+template class DenseBodies<float, 2u>;
+template class DensePhysics<float, 2u>;
@@ -0,0 +1,193 @@
+#ifndef DENSE_PHYSICS_H
+#define DENSE_PHYSICS_H
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "math.h"
+#include "physics.h"
+#include "slot_map.h"
+#include "vector_array.h"
+
+// A data-oriented storage mode of the physics: instead of Body objects reached by pointers, all
+// circular bodies are stored in one DenseBodies, a structure of arrays with a dense array for each
+// component (position, velocity, radius, maximal velocity, angle, time to delete, type). DensePhysics
+// moves all bodies with one loop over these arrays and finds the collisions in copies of them
+// sorted along the x-axis, so both stream linearly through memory. The game logic reaches a body
+// through a BodyHandle, which offers the interface of Body.
+
+template<class FLOAT_TYPE, size_t N, class TYPE> class DenseBodies;
+
+// refers to a body of a DenseBodies by the SlotHandle of the body, which stays valid while other
+// bodies are removed and becomes stale when the body is removed, also if its slot is reused
+template<class FLOAT_TYPE, size_t N, class TYPE = int>
+class BodyHandle {
+  DenseBodies<FLOAT_TYPE, N, TYPE> * bodies = nullptr;
+  SlotHandle handle;
+
+  // returns the index of the body in the arrays of bodies
+  size_t get_index() const;
+public:
+  // creates an invalid handle
+  BodyHandle() = default;
+
+  BodyHandle(DenseBodies<FLOAT_TYPE, N, TYPE> * bodies, SlotHandle handle);
+
+  // returns false for handles created with the default constructor and after the body was removed
+  bool is_valid() const;
+
+  SlotHandle get_handle() const;
+
+  bool operator==(const BodyHandle & handle) const = default;
+
+  Vector<FLOAT_TYPE, N> get_position() const;
+
+  void set_position(Vector<FLOAT_TYPE, N> position);
+
+  Vector<FLOAT_TYPE, N> get_velocity() const;
+
+  // the length of velocity is limited to the maximal and minimal velocity of the body, like Body::set_velocity
+  void set_velocity(Vector<FLOAT_TYPE, N> velocity);
+
+  // accelerates the body in the direction of its angle (in the x/y-plane)
+  void accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE seconds = 1.0);
+
+  void bounce(size_t coordinate);
+
+  FLOAT_TYPE get_radius() const;
+
+  // turns the body in the x/y-plane, angle is measured in radians
+  void turn(FLOAT_TYPE angle, FLOAT_TYPE seconds = 1.0);
+
+  FLOAT_TYPE get_angle() const;
+
+  void mark_for_deletion();
+
+  // returns true if the body is removed in the next tick
+  bool is_marked_for_deletion() const;
+
+  void set_time_to_delete(FLOAT_TYPE time_to_delete);
+
+  FLOAT_TYPE get_time_to_delete() const;
+
+  TYPE get_type() const;
+};
+
+
+// the bodies as a structure of arrays: the j-th element of each array is a component of the j-th body.
+// Removing a body moves the last body to its index. The types are kept in a SlotMap, which moves its
+// values the same way and gives the bodies their handles, so the slots of removed bodies are reused.
+template<class FLOAT_TYPE, size_t N, class TYPE = int>
+class DenseBodies {
+public:
+  static constexpr size_t NONE = SlotMap<TYPE>::NONE;
+
+  // the components, the arrays may be changed in place but must keep their size
+  VectorArray<FLOAT_TYPE, N> positions;
+  VectorArray<FLOAT_TYPE, N> velocities;
+  std::vector<FLOAT_TYPE> radii;
+  std::vector<FLOAT_TYPE> max_velocities;
+  std::vector<FLOAT_TYPE> min_velocities;
+  std::vector<FLOAT_TYPE> angles;
+  std::vector<FLOAT_TYPE> times_to_delete; // infinity if the body is not to be deleted
+  SlotMap<TYPE> types; // the types in get_values()
+
+  // appends a body, the length of velocity is limited to max_velocity and min_velocity
+  BodyHandle<FLOAT_TYPE, N, TYPE> add(Vector<FLOAT_TYPE, N> position, FLOAT_TYPE radius,
+                                      Vector<FLOAT_TYPE, N> velocity = Vector<FLOAT_TYPE, N>(),
+                                      FLOAT_TYPE max_velocity = 1.0, FLOAT_TYPE min_velocity = 0.0,
+                                      FLOAT_TYPE angle = 0.0, TYPE type = TYPE());
+
+  size_t size() const;
+
+  // returns the index of the body of handle, NONE if it was removed
+  size_t get_index(SlotHandle handle) const;
+
+  BodyHandle<FLOAT_TYPE, N, TYPE> get_handle(size_t index);
+
+  // removes the body at index, the last body takes its place
+  void remove(size_t index);
+
+  // removes all bodies marked for deletion (see BodyHandle::is_marked_for_deletion)
+  void remove_marked();
+};
+
+
+// a physic engine for the bodies of a DenseBodies, with the same steps in tick() as Physics (see there):
+// the bodies marked for deletion are removed, all bodies move, and the colliding pairs are checked and
+// resolved with the callbacks. As in Physics the callbacks are functors of the types CHECK and RESOLVE,
+//   bool check_collision(BodyHandle, BodyHandle), void resolve_collision(BodyHandle, BodyHandle)
+// which are std::function by default. The world may repeat like in Physics::set_world_extent.
+template<class FLOAT_TYPE, size_t N, class TYPE = int,
+         class CHECK = std::function<bool(BodyHandle<FLOAT_TYPE, N, TYPE>, BodyHandle<FLOAT_TYPE, N, TYPE>)>,
+         class RESOLVE = std::function<void(BodyHandle<FLOAT_TYPE, N, TYPE>, BodyHandle<FLOAT_TYPE, N, TYPE>)>>
+class DensePhysics {
+  DenseBodies<FLOAT_TYPE, N, TYPE> bodies;
+
+  CHECK check_collision;
+  RESOLVE resolve_collision;
+
+  FLOAT_TYPE tick_time = 1.0;
+  Vector<FLOAT_TYPE, N> world_extent;
+
+  // the handles of the bodies sorted by the lower end of their x-interval in the last tick, the order
+  // is sorted again with insertion sort in each tick. Whether each body has a handle in it, a member
+  // to reuse its memory
+  std::vector<SlotHandle> sweep_handles;
+  std::vector<bool> is_swept;
+
+  // the bodies in the order of sweep_handles, gathered in each tick for the sweep. Members to reuse their memory
+  std::vector<FLOAT_TYPE> sweep_lower, sweep_upper, sweep_radii;
+  VectorArray<FLOAT_TYPE, N> sweep_centers;
+  std::vector<size_t> sweep_indices;
+
+  std::vector<std::pair<size_t, size_t>> colliding_pairs;
+  std::vector<std::pair<BodyHandle<FLOAT_TYPE, N, TYPE>, BodyHandle<FLOAT_TYPE, N, TYPE>>> pairs_to_resolve;
+
+  TickStatistics statistics;
+
+  // moves all bodies by tick_time, counts down their times to delete and wraps them into a repeating world
+  void move_bodies(FLOAT_TYPE tick_time);
+public:
+  DensePhysics( CHECK check_collision = [](BodyHandle<FLOAT_TYPE, N, TYPE>, BodyHandle<FLOAT_TYPE, N, TYPE>) -> bool { return true; },
+                RESOLVE resolve_collision = [](BodyHandle<FLOAT_TYPE, N, TYPE>, BodyHandle<FLOAT_TYPE, N, TYPE>) -> void { } );
+
+  // adds a body, it takes part in the next tick
+  BodyHandle<FLOAT_TYPE, N, TYPE> add_body(Vector<FLOAT_TYPE, N> position, FLOAT_TYPE radius,
+                                           Vector<FLOAT_TYPE, N> velocity = Vector<FLOAT_TYPE, N>(),
+                                           FLOAT_TYPE max_velocity = 1.0, FLOAT_TYPE min_velocity = 0.0,
+                                           FLOAT_TYPE angle = 0.0, TYPE type = TYPE());
+
+  DenseBodies<FLOAT_TYPE, N, TYPE> & get_bodies();
+
+  void set_tick_time(FLOAT_TYPE tick_time);
+
+  FLOAT_TYPE get_tick_time() const;
+
+  // see Physics::set_world_extent
+  void set_world_extent(Vector<FLOAT_TYPE, N> world_extent);
+
+  // appends the index pairs (i, j) with i < j of all colliding bodies to pairs, ordered by i and j
+  void find_colliding_pairs(std::vector<std::pair<size_t, size_t>> & pairs);
+
+  void tick();
+
+  void tick(FLOAT_TYPE tick_time);
+
+  // returns the phase times and counts of the last tick, like Physics::get_tick_statistics
+  const TickStatistics & get_tick_statistics() const;
+
+  bool is_area_free_of_bodies(Vector<FLOAT_TYPE, N> center, FLOAT_TYPE radius,
+                              std::function<bool(BodyHandle<FLOAT_TYPE, N, TYPE>)> check_body
+                                = [](BodyHandle<FLOAT_TYPE, N, TYPE> body) -> bool { return !body.is_marked_for_deletion(); });
+};
+
+
+typedef BodyHandle<float, 2u> BodyHandle2df;
+typedef DenseBodies<float, 2u> DenseBodies2df;
+typedef DensePhysics<float, 2u> DensePhysics2df;
+
+#endif
@@ -0,0 +1,389 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "slot_map.tcc"
+
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+BodyHandle<FLOAT_TYPE, N, TYPE>::BodyHandle(DenseBodies<FLOAT_TYPE, N, TYPE> * bodies, SlotHandle handle)
+  : bodies(bodies), handle(handle) { }
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+size_t BodyHandle<FLOAT_TYPE, N, TYPE>::get_index() const {
+  return bodies->get_index(handle);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+bool BodyHandle<FLOAT_TYPE, N, TYPE>::is_valid() const {
+  return bodies != nullptr && get_index() != DenseBodies<FLOAT_TYPE, N, TYPE>::NONE;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+SlotHandle BodyHandle<FLOAT_TYPE, N, TYPE>::get_handle() const {
+  return handle;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+Vector<FLOAT_TYPE, N> BodyHandle<FLOAT_TYPE, N, TYPE>::get_position() const {
+  return bodies->positions[get_index()];
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::set_position(Vector<FLOAT_TYPE, N> position) {
+  bodies->positions.set(get_index(), position);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+Vector<FLOAT_TYPE, N> BodyHandle<FLOAT_TYPE, N, TYPE>::get_velocity() const {
+  return bodies->velocities[get_index()];
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::set_velocity(Vector<FLOAT_TYPE, N> velocity) {
+  const size_t index = get_index();
+  FLOAT_TYPE max_velocity = bodies->max_velocities[index];
+  FLOAT_TYPE min_velocity = bodies->min_velocities[index];
+  FLOAT_TYPE length = velocity.length();
+  if (length > max_velocity) {
+    velocity = (max_velocity / length) * velocity;
+    length = max_velocity;
+  }
+  if (length < min_velocity) {
+    velocity = (min_velocity / length) * velocity;
+  }
+  bodies->velocities.set(index, velocity);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE seconds) {
+  if (N >= 2) {
+    Vector<FLOAT_TYPE, N> direction = Matrix<FLOAT_TYPE, N, N + 1u>::rotation(get_angle()).column(0); // the rotated x-axis
+    set_velocity( get_velocity() + seconds * acceleration * direction );
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::bounce(size_t coordinate) {
+  bodies->velocities.component(coordinate)[get_index()] *= -1;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+FLOAT_TYPE BodyHandle<FLOAT_TYPE, N, TYPE>::get_radius() const {
+  return bodies->radii[get_index()];
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::turn(FLOAT_TYPE angle, FLOAT_TYPE seconds) {
+  bodies->angles[get_index()] += seconds * angle;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+FLOAT_TYPE BodyHandle<FLOAT_TYPE, N, TYPE>::get_angle() const {
+  return bodies->angles[get_index()];
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::mark_for_deletion() {
+  set_time_to_delete(0.0);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+bool BodyHandle<FLOAT_TYPE, N, TYPE>::is_marked_for_deletion() const {
+  return get_time_to_delete() <= 0;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void BodyHandle<FLOAT_TYPE, N, TYPE>::set_time_to_delete(FLOAT_TYPE time_to_delete) {
+  bodies->times_to_delete[get_index()] = std::max(time_to_delete, static_cast<FLOAT_TYPE>(0.0));
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+FLOAT_TYPE BodyHandle<FLOAT_TYPE, N, TYPE>::get_time_to_delete() const {
+  return bodies->times_to_delete[get_index()];
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+TYPE BodyHandle<FLOAT_TYPE, N, TYPE>::get_type() const {
+  return bodies->types.get_values()[get_index()];
+}
+
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+BodyHandle<FLOAT_TYPE, N, TYPE> DenseBodies<FLOAT_TYPE, N, TYPE>::add(Vector<FLOAT_TYPE, N> position, FLOAT_TYPE radius,
+                                                                     Vector<FLOAT_TYPE, N> velocity, FLOAT_TYPE max_velocity,
+                                                                     FLOAT_TYPE min_velocity, FLOAT_TYPE angle, TYPE type) {
+  positions.push_back(position);
+  velocities.push_back(Vector<FLOAT_TYPE, N>());
+  radii.push_back(radius);
+  max_velocities.push_back(max_velocity);
+  min_velocities.push_back(min_velocity);
+  angles.push_back(angle);
+  times_to_delete.push_back(std::numeric_limits<FLOAT_TYPE>::infinity());
+  BodyHandle<FLOAT_TYPE, N, TYPE> handle(this, types.insert(type));
+  handle.set_velocity(velocity);
+  return handle;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+size_t DenseBodies<FLOAT_TYPE, N, TYPE>::size() const {
+  return types.size();
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+size_t DenseBodies<FLOAT_TYPE, N, TYPE>::get_index(SlotHandle handle) const {
+  return types.get_index(handle);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+BodyHandle<FLOAT_TYPE, N, TYPE> DenseBodies<FLOAT_TYPE, N, TYPE>::get_handle(size_t index) {
+  return BodyHandle<FLOAT_TYPE, N, TYPE>(this, types.get_handle(index));
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void DenseBodies<FLOAT_TYPE, N, TYPE>::remove(size_t index) {
+  const size_t last = size() - 1;
+  if (index != last) {
+    positions.set(index, positions[last]);
+    velocities.set(index, velocities[last]);
+    radii[index] = radii[last];
+    max_velocities[index] = max_velocities[last];
+    min_velocities[index] = min_velocities[last];
+    angles[index] = angles[last];
+    times_to_delete[index] = times_to_delete[last];
+  }
+  types.erase_at(index);
+  positions.resize(last);
+  velocities.resize(last);
+  radii.pop_back();
+  max_velocities.pop_back();
+  min_velocities.pop_back();
+  angles.pop_back();
+  times_to_delete.pop_back();
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE>
+void DenseBodies<FLOAT_TYPE, N, TYPE>::remove_marked() {
+  // backwards, so the bodies moved into the removed places were already tested
+  for (size_t index = size(); index > 0; index--) {
+    if (times_to_delete[index - 1] <= 0) {
+      remove(index - 1);
+    }
+  }
+}
+
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::DensePhysics(CHECK check_collision, RESOLVE resolve_collision)
+  : check_collision(check_collision), resolve_collision(resolve_collision) { }
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+BodyHandle<FLOAT_TYPE, N, TYPE> DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::add_body(Vector<FLOAT_TYPE, N> position, FLOAT_TYPE radius,
+                                                                                            Vector<FLOAT_TYPE, N> velocity, FLOAT_TYPE max_velocity,
+                                                                                            FLOAT_TYPE min_velocity, FLOAT_TYPE angle, TYPE type) {
+  return bodies.add(position, radius, velocity, max_velocity, min_velocity, angle, type);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+DenseBodies<FLOAT_TYPE, N, TYPE> & DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::get_bodies() {
+  return bodies;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::set_tick_time(FLOAT_TYPE tick_time) {
+  this->tick_time = tick_time;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+FLOAT_TYPE DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::get_tick_time() const {
+  return tick_time;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::set_world_extent(Vector<FLOAT_TYPE, N> world_extent) {
+  this->world_extent = world_extent;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::move_bodies(FLOAT_TYPE tick_time) {
+  bodies.positions.axpy(tick_time, bodies.velocities);
+  for (FLOAT_TYPE & time_to_delete : bodies.times_to_delete) {
+    time_to_delete -= tick_time;
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    const FLOAT_TYPE extent = world_extent[axis];
+    if (extent <= 0) {
+      continue;
+    }
+    for (FLOAT_TYPE & coordinate : bodies.positions.component(axis)) {
+      coordinate -= extent * std::floor(coordinate / extent);
+      if (coordinate >= extent) { // rounding of tiny negative values
+        coordinate = 0;
+      }
+    }
+  }
+}
+
+// sweep and prune like SweepAndPruneBroadphase, on copies of the bodies' components in sweep order
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::find_colliding_pairs(std::vector<std::pair<size_t, size_t>> & pairs) {
+  // keeps the order of the last tick and appends the new bodies
+  is_swept.assign(bodies.size(), false);
+  erase_if(sweep_handles, [&](SlotHandle handle) {
+    size_t index = bodies.get_index(handle);
+    if (index == DenseBodies<FLOAT_TYPE, N, TYPE>::NONE) {
+      return true;
+    }
+    is_swept[index] = true;
+    return false;
+  });
+  for (size_t index = 0; index < bodies.size(); index++) {
+    if ( !is_swept[index] ) {
+      sweep_handles.push_back( bodies.types.get_handle(index) );
+    }
+  }
+
+  const size_t count = sweep_handles.size();
+  std::span<const FLOAT_TYPE> x = bodies.positions.component(0);
+  sweep_lower.resize(count);
+  sweep_indices.resize(count);
+  for (size_t k = 0; k < count; k++) {
+    size_t index = bodies.get_index(sweep_handles[k]);
+    sweep_indices[k] = index;
+    sweep_lower[k] = x[index] - bodies.radii[index];
+  }
+  // the order is nearly sorted if the bodies moved only a bit since the last tick
+  for (size_t k = 1; k < count; k++) {
+    FLOAT_TYPE lower = sweep_lower[k];
+    SlotHandle handle = sweep_handles[k];
+    size_t index = sweep_indices[k];
+    size_t m = k;
+    for (; m > 0 && sweep_lower[m - 1] > lower; m--) {
+      sweep_lower[m] = sweep_lower[m - 1];
+      sweep_handles[m] = sweep_handles[m - 1];
+      sweep_indices[m] = sweep_indices[m - 1];
+    }
+    sweep_lower[m] = lower;
+    sweep_handles[m] = handle;
+    sweep_indices[m] = index;
+  }
+  // gathers the other components in sweep order
+  sweep_upper.resize(count);
+  sweep_radii.resize(count);
+  sweep_centers.resize(count);
+  for (size_t k = 0; k < count; k++) {
+    sweep_radii[k] = bodies.radii[sweep_indices[k]];
+    sweep_upper[k] = sweep_lower[k] + 2 * sweep_radii[k];
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    std::span<const FLOAT_TYPE> coordinates = bodies.positions.component(axis);
+    std::span<FLOAT_TYPE> sweep_coordinates = sweep_centers.component(axis);
+    for (size_t k = 0; k < count; k++) {
+      sweep_coordinates[k] = coordinates[sweep_indices[k]];
+    }
+  }
+
+  // the sweep reads the arrays through plain pointers, so the loops stay free of calls
+  std::array<const FLOAT_TYPE *, N> centers;
+  for (size_t axis = 0u; axis < N; axis++) {
+    centers[axis] = sweep_centers.component(axis).data();
+  }
+  const FLOAT_TYPE * lower = sweep_lower.data();
+  const FLOAT_TYPE * radii = sweep_radii.data();
+  const Vector<FLOAT_TYPE, N> extents = world_extent;
+  auto overlap = [&](size_t a, size_t b) -> bool {
+    FLOAT_TYPE square_of_distance = 0.0;
+    for (size_t axis = 0u; axis < N; axis++) {
+      FLOAT_TYPE difference = centers[axis][b] - centers[axis][a];
+      if (extents[axis] > 0) {
+        difference -= extents[axis] * std::round(difference / extents[axis]);
+      }
+      square_of_distance += difference * difference;
+    }
+    FLOAT_TYPE radius_sum = radii[a] + radii[b];
+    return square_of_distance <= radius_sum * radius_sum;
+  };
+
+  const FLOAT_TYPE extent = world_extent[0];
+  for (size_t k = 0; k < count; k++) {
+    const FLOAT_TYPE upper = sweep_upper[k];
+    for (size_t m = k + 1; m < count && lower[m] <= upper; m++) {
+      if ( overlap(k, m) ) {
+        pairs.push_back( std::minmax(sweep_indices[k], sweep_indices[m]) );
+      }
+    }
+    // the intervals at the beginning continue after the end of the repeating x-axis
+    for (size_t m = 0; extent > 0 && m < k && lower[m] + extent <= upper; m++) {
+      if ( overlap(k, m) ) {
+        pairs.push_back( std::minmax(sweep_indices[k], sweep_indices[m]) );
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  if (extent > 0) { // the pairs overlapping at both ends were found twice
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::tick() {
+  tick(tick_time);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+void DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::tick(FLOAT_TYPE tick_time) {
+  using Clock = std::chrono::steady_clock;
+  auto seconds_since = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+  Clock::time_point phase_start = Clock::now();
+  set_tick_time(tick_time);
+  bodies.remove_marked();
+  statistics.add_remove_time = seconds_since(phase_start);
+  statistics.body_count = bodies.size();
+
+  phase_start = Clock::now();
+  move_bodies(tick_time);
+  statistics.integrate_time = seconds_since(phase_start);
+
+  phase_start = Clock::now();
+  colliding_pairs.clear();
+  find_colliding_pairs(colliding_pairs);
+  statistics.pair_search_time = seconds_since(phase_start);
+  statistics.pair_count = colliding_pairs.size();
+
+  phase_start = Clock::now();
+  // the callbacks get handles, as resolving a collision may add bodies
+  pairs_to_resolve.clear();
+  for (auto [i, j] : colliding_pairs) {
+    BodyHandle<FLOAT_TYPE, N, TYPE> a = bodies.get_handle(i), b = bodies.get_handle(j);
+    if ( check_collision(a, b) ) {
+      pairs_to_resolve.push_back( {a, b} );
+    }
+  }
+  for (auto [a, b] : pairs_to_resolve) {
+    resolve_collision(a, b);
+  }
+  statistics.resolve_time = seconds_since(phase_start);
+  statistics.resolved_count = pairs_to_resolve.size();
+
+  phase_start = Clock::now();
+  bodies.remove_marked();
+  statistics.add_remove_time += seconds_since(phase_start);
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+const TickStatistics & DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::get_tick_statistics() const {
+  return statistics;
+}
+
+template<class FLOAT_TYPE, size_t N, class TYPE, class CHECK, class RESOLVE>
+bool DensePhysics<FLOAT_TYPE, N, TYPE, CHECK, RESOLVE>::is_area_free_of_bodies(Vector<FLOAT_TYPE, N> center, FLOAT_TYPE radius,
+                                                                               std::function<bool(BodyHandle<FLOAT_TYPE, N, TYPE>)> check_body) {
+  Sphere<FLOAT_TYPE, N> area(center, radius);
+  for (size_t index = 0; index < bodies.size(); index++) {
+    Vector<FLOAT_TYPE, N> position = get_nearest_image(bodies.positions[index], center, world_extent);
+    if ( area.intersects(Sphere<FLOAT_TYPE, N>(position, bodies.radii[index])) && check_body(bodies.get_handle(index)) ) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,163 @@
+#include "dense_physics.h"
+#include "gtest/gtest.h"
+#include <random>
+
+
+namespace {
+
+TEST(DENSE_PHYSICS, HandlesSurviveRemoval) {
+  DensePhysics2df physics;
+  BodyHandle2df body1 = physics.add_body({1.0, 2.0}, 1.0);
+  BodyHandle2df body2 = physics.add_body({3.0, 4.0}, 1.0);
+  BodyHandle2df body3 = physics.add_body({5.0, 6.0}, 2.0, {0.0, 0.0}, 1.0, 0.0, 0.0, 7);
+  body1.mark_for_deletion();
+  physics.tick(1.0);
+
+  EXPECT_FALSE( body1.is_valid() );
+  EXPECT_TRUE( body2.is_valid() );
+  EXPECT_TRUE( body3.is_valid() );
+  EXPECT_FALSE( BodyHandle2df().is_valid() );
+  EXPECT_EQ(2u, physics.get_bodies().size());
+  EXPECT_NEAR(4.0, body2.get_position()[1], 0.00001);
+  EXPECT_NEAR(5.0, body3.get_position()[0], 0.00001);
+  EXPECT_NEAR(2.0, body3.get_radius(), 0.00001);
+  EXPECT_EQ(7, body3.get_type());
+
+  // the slot of body1 is reused, its handle stays stale
+  BodyHandle2df body4 = physics.add_body({7.0, 8.0}, 1.0);
+  EXPECT_EQ(body1.get_handle().slot, body4.get_handle().slot);
+  EXPECT_FALSE( body1.is_valid() );
+  EXPECT_TRUE( body4.is_valid() );
+  EXPECT_EQ(3u, physics.get_bodies().size());
+}
+
+// the velocity is limited to the maximal and minimal velocity like the one of a Body
+TEST(DENSE_PHYSICS, SetVelocityLikeBody) {
+  DensePhysics2df physics;
+  BodyHandle2df handle = physics.add_body({0.0, 0.0}, 1.0, {3.0, 4.0}, 10.0f, 2.0f);
+  Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {3.0, 4.0}, 10.0f, 2.0f );
+  for (Vector2df velocity : {Vector2df{30.0, 40.0}, Vector2df{-3.0, 4.0}, Vector2df{0.3, 0.4}}) {
+    handle.set_velocity(velocity);
+    body.set_velocity(velocity);
+    EXPECT_NEAR(body.get_velocity()[0], handle.get_velocity()[0], 0.0001);
+    EXPECT_NEAR(body.get_velocity()[1], handle.get_velocity()[1], 0.0001);
+  }
+  EXPECT_NEAR(2.0, handle.get_velocity().length(), 0.0001);
+}
+
+TEST(DENSE_PHYSICS, TickMovesAndWraps) {
+  DensePhysics2df physics;
+  physics.set_world_extent({100.0f, 50.0f});
+  BodyHandle2df body1 = physics.add_body({99.0, 20.0}, 1.0, {2.0, -30.0}, 100.0f);
+  BodyHandle2df body2 = physics.add_body({10.0, 10.0}, 1.0, {3.0, 4.0}, 1.0f);
+  physics.tick(1.0f);
+
+  EXPECT_NEAR(1.0, body1.get_position()[0], 0.0001);
+  EXPECT_NEAR(40.0, body1.get_position()[1], 0.0001);
+  // the velocity of body2 is limited to 1
+  EXPECT_NEAR(10.6, body2.get_position()[0], 0.0001);
+  EXPECT_NEAR(10.8, body2.get_position()[1], 0.0001);
+}
+
+TEST(DENSE_PHYSICS, AccelerateTurnAndDelete) {
+  DensePhysics2df physics;
+  BodyHandle2df body = physics.add_body({0.0, 0.0}, 1.0, {0.0, 0.0}, 10.0f);
+  body.turn(PI / 2.0f);
+  body.accelerate(2.0f, 0.5f);
+  body.set_time_to_delete(1.5f);
+  physics.tick(1.0f);
+
+  EXPECT_NEAR(0.0, body.get_velocity()[0], 0.0001);
+  EXPECT_NEAR(1.0, body.get_velocity()[1], 0.0001);
+  EXPECT_NEAR(0.5, body.get_time_to_delete(), 0.0001);
+  EXPECT_FALSE( body.is_marked_for_deletion() );
+  physics.tick(1.0f);
+  EXPECT_FALSE( body.is_valid() );
+}
+
+// the dense storage has to report the same collisions as Physics, in which the bodies keep their
+// order: the collisions of each tick are compared as sorted pairs of the indices the bodies were added with.
+// The slots of the removed bodies are reused by the bodies added later
+void expect_same_collisions_as_physics(Vector2df world_extent) {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<float> position(0.0f, 400.0f);
+  std::uniform_real_distribution<float> velocity(-50.0f, 50.0f);
+  std::uniform_real_distribution<float> radius(1.0f, 20.0f);
+  std::vector<Body2df> bodies;
+  for (size_t i = 0; i < 400; i++) {
+    bodies.push_back( Body2df( BoundingVolume2df({position(generator), position(generator)}, radius(generator)),
+                               {velocity(generator), velocity(generator)}, 100.0f ) );
+  }
+
+  using Collisions = std::vector<std::pair<size_t, size_t>>;
+  std::vector<BodyHandle2df> handles;
+  Collisions collisions, dense_collisions;
+  Physics2df physics([](Body2df *, Body2df *) -> bool { return true; },
+                     [&](Body2df * b1, Body2df * b2) -> void {
+                       collisions.push_back( std::minmax<size_t>(b1 - bodies.data(), b2 - bodies.data()) );
+                     });
+  DensePhysics2df dense_physics([](BodyHandle2df, BodyHandle2df) -> bool { return true; },
+                                [&](BodyHandle2df b1, BodyHandle2df b2) -> void {
+                                  size_t i1 = std::find(handles.begin(), handles.end(), b1) - handles.begin();
+                                  size_t i2 = std::find(handles.begin(), handles.end(), b2) - handles.begin();
+                                  dense_collisions.push_back( std::minmax(i1, i2) );
+                                });
+  physics.set_world_extent(world_extent);
+  dense_physics.set_world_extent(world_extent);
+  for (size_t i = 0; i < 300; i++) {
+    physics.add_body( &bodies[i] );
+    handles.push_back( dense_physics.add_body(bodies[i].get_position(), bodies[i].get_bounding_volume().get_radius(),
+                                              bodies[i].get_velocity(), 100.0f) );
+  }
+  size_t total_collisions = 0;
+  for (size_t tick = 0; tick < 20; tick++) {
+    if (tick == 5) {
+      for (size_t i = 0; i < 300; i += 7) {
+        bodies[i].mark_for_deletion();
+        handles[i].mark_for_deletion();
+      }
+    }
+    if (tick == 10) {
+      for (size_t i = 300; i < bodies.size(); i++) {
+        physics.add_body( &bodies[i] );
+        handles.push_back( dense_physics.add_body(bodies[i].get_position(), bodies[i].get_bounding_volume().get_radius(),
+                                                  bodies[i].get_velocity(), 100.0f) );
+      }
+    }
+    collisions.clear();
+    dense_collisions.clear();
+    physics.tick(0.1f);
+    dense_physics.tick(0.1f);
+    std::sort(collisions.begin(), collisions.end());
+    std::sort(dense_collisions.begin(), dense_collisions.end());
+    EXPECT_EQ(collisions, dense_collisions);
+    total_collisions += collisions.size();
+  }
+
+  EXPECT_LT(0u, total_collisions);
+  for (size_t i = 0; i < bodies.size(); i++) {
+    if (handles[i].is_valid()) {
+      EXPECT_NEAR(bodies[i].get_position()[0], handles[i].get_position()[0], 0.001);
+      EXPECT_NEAR(bodies[i].get_position()[1], handles[i].get_position()[1], 0.001);
+    }
+  }
+}
+
+TEST(DENSE_PHYSICS, TickReportsSameCollisionsAsPhysics) {
+  expect_same_collisions_as_physics({0.0f, 0.0f});
+}
+
+TEST(DENSE_PHYSICS, TickReportsSameCollisionsAsPhysicsInRepeatingWorld) {
+  expect_same_collisions_as_physics({400.0f, 300.0f});
+}
+
+TEST(DENSE_PHYSICS, IsAreaFreeOfBodies) {
+  DensePhysics2df physics;
+  physics.set_world_extent({100.0f, 100.0f});
+  physics.add_body({98.0, 50.0}, 1.0);
+
+  EXPECT_TRUE( physics.is_area_free_of_bodies({50.0, 50.0}, 10.0) );
+  EXPECT_FALSE( physics.is_area_free_of_bodies({1.0, 50.0}, 2.0) );
+}
+
+}
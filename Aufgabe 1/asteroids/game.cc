@@ -1,36 +1,16 @@
 #include "game.h"
+#include "physics.tcc" // instantiates the spatial queries with the filters below
 #include <iostream>
 #include <algorithm>
 
 const int SCREEN_WIDTH = 1024;
 const int SCREEN_HEIGHT = (SCREEN_WIDTH * 3) / 4;
 
-void displacement_fix(Body2df * body, float seconds) {
-  float x = body->get_position()[0];
-  float y = body->get_position()[1];
-  Vector2df new_position = body->get_position();
-  
-  if ( x < 0 ) {
-    new_position[0] = SCREEN_WIDTH;
-  }
-  if ( x > SCREEN_WIDTH ) {
-    new_position[0] = 0;
-  }
-  if ( y < 0 ) {
-    new_position[1] = SCREEN_HEIGHT;
-  }
-  if ( y > SCREEN_HEIGHT ) {
-    new_position[1] = 0;
-  }
-  
-  body->set_position(new_position);
-}
-
 Asteroid::Asteroid(short size)
   : TypedBody( BodyType::asteroid,
                Body2df{ BoundingVolume2df{ Vector2df{ 128.0f + 768.0f * dis(gen), 64.0f + 640.0f * dis(gen) }, size * 11.0f },
                          Vector2df{ 0.5f - dis(gen), 0.5f - dis(gen) },
-                         348.0, 0.0, 0.0, displacement_fix } ),
+                         348.0, 0.0, 0.0 } ),
     size(size),
     rock_type( std::trunc(4 * dis(gen)) )
   {
@@ -48,7 +28,7 @@ Asteroid::Asteroid(short size)
 
 
 Asteroid::Asteroid(short size, Vector2df position ) : Asteroid(size) {
-  set_position(position);
+  set_position(position, true);
 }
   
 short Asteroid::get_size() const {
@@ -59,6 +39,44 @@ short Asteroid::get_rock_type() const {
   return rock_type;
 }
 
+uint32_t get_collision_category(BodyType type) {
+  return 1u << static_cast<unsigned>(type);
+}
+
+uint32_t get_collision_mask(BodyType type) {
+  const uint32_t torpedo = get_collision_category(BodyType::torpedo), asteroid = get_collision_category(BodyType::asteroid),
+                 spaceship = get_collision_category(BodyType::spaceship), saucer = get_collision_category(BodyType::saucer);
+  switch (type) {
+    case BodyType::torpedo: return asteroid | spaceship | saucer;
+    case BodyType::asteroid: return torpedo | spaceship | saucer;
+    case BodyType::spaceship: return torpedo | asteroid | saucer;
+    case BodyType::saucer: return torpedo | asteroid | spaceship;
+    default: return 0u;
+  }
+}
+
+void TypedBody::save(Snapshot & snapshot) const {
+  Body2df::save(snapshot);
+  snapshot.write(type);
+}
+
+void TypedBody::restore(Snapshot & snapshot) {
+  Body2df::restore(snapshot);
+  snapshot.read(type);
+}
+
+void Asteroid::save(Snapshot & snapshot) const {
+  TypedBody::save(snapshot);
+  snapshot.write(size);
+  snapshot.write(rock_type);
+}
+
+void Asteroid::restore(Snapshot & snapshot) {
+  TypedBody::restore(snapshot);
+  snapshot.read(size);
+  snapshot.read(rock_type);
+}
+
 bool Spaceship::shoot(Physics2df & physics) {
   if (shoot_cooldown.get_time() <= 0.0 && ! is_marked_for_deletion() && ! in_hyperspace) {
     size_t i = 0;
@@ -121,7 +139,6 @@ void Spaceship::turn_right(float tick_time) {
 }
 
 void Spaceship::spaceship_fix(Body2df * body, float seconds) {
-  displacement_fix(body, seconds);
   Spaceship * ship = static_cast<Spaceship *>(body);
   ship->pass_time(seconds);
 }
@@ -144,10 +161,38 @@ bool Spaceship::is_in_hyperspace() {
   return in_hyperspace;
 }
 
+std::array<Torpedo, 4> & Spaceship::get_torpedos() {
+  return torpedos;
+}
+
+void Spaceship::save(Snapshot & snapshot) const {
+  TypedBody::save(snapshot);
+  for (const Torpedo & torpedo : torpedos) {
+    torpedo.save(snapshot);
+  }
+  snapshot.write(shoot_cooldown);
+  snapshot.write(accelerate_timer);
+  snapshot.write(turn_timer);
+  snapshot.write(hyperspace_delay);
+  snapshot.write(in_hyperspace);
+}
+
+void Spaceship::restore(Snapshot & snapshot) {
+  TypedBody::restore(snapshot);
+  for (Torpedo & torpedo : torpedos) {
+    torpedo.restore(snapshot);
+  }
+  snapshot.read(shoot_cooldown);
+  snapshot.read(accelerate_timer);
+  snapshot.read(turn_timer);
+  snapshot.read(hyperspace_delay);
+  snapshot.read(in_hyperspace);
+}
+
 void Spaceship::jump_into_hyperspace(Game & game) {
   if ( ! in_hyperspace ) {
     set_velocity({0.0f, 0.0f});
-    set_position({512.0f + 348.0f * (0.5f - dis(gen)) , 368.0f + 256.0f * (0.5f - dis(gen)) });
+    set_position({512.0f + 348.0f * (0.5f - dis(gen)) , 368.0f + 256.0f * (0.5f - dis(gen)) }, true);
     if ( dis(gen) < 0.25f ||  game.no_of_asteroids > (dis(gen) * 15.0f + 4.0f) ) {
       game.destroy_spaceship(); 
     } else {
@@ -174,7 +219,7 @@ bool Saucer::shoot(Game & game) {
     
     if ( i < torpedos.size() ) {
       if ( size == 0 && precise_shoot_counter <= 0 && ! game.ship.is_marked_for_deletion() ) {
-        auto direct_shot = ( game.ship.get_position() - this->get_position() );
+        Vector2df direct_shot = ( game.ship.get_position() - this->get_position() );
         direct_shot *= 1.0f /  direct_shot.length();
         torpedos[i] = Torpedo{ get_position(), direct_shot.angle(0.0f,1.0f), get_velocity() };
         precise_shoot_counter = 6;
@@ -225,11 +270,10 @@ void Game::saucer_fix(Body2df * body, float seconds) {
   Saucer * saucer = static_cast<Saucer *>(body);
   float x = saucer->get_position()[0];
   
+  // the saucer leaves the screen at the left and right border, it is called before physics wraps the position
   if ( x > SCREEN_WIDTH || x < 0.0f ) {
     saucer->mark_for_deletion();
     saucer_timer = SAUCER_SPAN_TIME;
-  } else {
-    displacement_fix(body, seconds);
   }
 
   saucer->pass_time(seconds, *this);
@@ -245,9 +289,116 @@ void Saucer::clear_torpedos() {
   }
 }
 
+std::array<Torpedo, 2> & Saucer::get_torpedos() {
+  return torpedos;
+}
+
+void Saucer::save(Snapshot & snapshot) const {
+  TypedBody::save(snapshot);
+  for (const Torpedo & torpedo : torpedos) {
+    torpedo.save(snapshot);
+  }
+  snapshot.write(shoot_cooldown);
+  snapshot.write(change_direction_cooldown);
+  snapshot.write(size);
+  snapshot.write(precise_shoot_counter);
+}
+
+void Saucer::restore(Snapshot & snapshot) {
+  TypedBody::restore(snapshot);
+  for (Torpedo & torpedo : torpedos) {
+    torpedo.restore(snapshot);
+  }
+  snapshot.read(shoot_cooldown);
+  snapshot.read(change_direction_cooldown);
+  snapshot.read(size);
+  snapshot.read(precise_shoot_counter);
+}
+
 Game::Game() {
+  physics.set_world_extent( {static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)} );
+  physics.set_continuous_collision_detection(true); // torpedos move farther than their radius in each frame
   saucer.mark_for_deletion();
   ship.mark_for_deletion();
+  bodies_by_id = { &ship, &saucer, &debris };
+  for (Torpedo & torpedo : ship.get_torpedos()) {
+    bodies_by_id.push_back(&torpedo);
+  }
+  for (Torpedo & torpedo : saucer.get_torpedos()) {
+    bodies_by_id.push_back(&torpedo);
+  }
+  for (Asteroid & asteroid : asteroids) {
+    bodies_by_id.push_back(&asteroid);
+  }
+  for (Debris & debris : debrises) {
+    bodies_by_id.push_back(&debris);
+  }
+}
+
+size_t Game::get_body_id(const Body2df * body) const {
+  // the asteroids and debrises come last in bodies_by_id, the few bodies before them are searched
+  const TypedBody * typed_body = static_cast<const TypedBody *>(body);
+  const size_t first_asteroid_id = bodies_by_id.size() - debrises.size() - asteroids.size();
+  switch (typed_body->get_type()) {
+  case BodyType::asteroid:
+    return first_asteroid_id + (static_cast<const Asteroid *>(typed_body) - asteroids.data());
+  case BodyType::debris:
+    return first_asteroid_id + asteroids.size() + (static_cast<const Debris *>(typed_body) - debrises.data());
+  default:
+    return std::find(bodies_by_id.begin(), bodies_by_id.begin() + first_asteroid_id, typed_body) - bodies_by_id.begin();
+  }
+}
+
+void Game::save(Snapshot & snapshot) const {
+  snapshot.write(gen);
+  snapshot.write(dis);
+  ship.save(snapshot);
+  saucer.save(snapshot);
+  debris.save(snapshot);
+  for (const Asteroid & asteroid : asteroids) {
+    asteroid.save(snapshot);
+  }
+  for (const Debris & debris : debrises) {
+    debris.save(snapshot);
+  }
+  snapshot.write(game_events);
+  snapshot.write(no_of_ships);
+  snapshot.write(current_no_of_asteroids);
+  snapshot.write(no_of_asteroids);
+  snapshot.write(next_asteroid);
+  snapshot.write(next_debris);
+  snapshot.write(score);
+  snapshot.write(time_since_start_of_level);
+  snapshot.write(saucer_timer);
+  snapshot.write(ship_spawn_timer);
+  snapshot.write(new_asteroids_spawn_timer);
+  physics.save(snapshot, [this](const Body2df * body) -> size_t { return get_body_id(body); });
+}
+
+void Game::restore(Snapshot & snapshot) {
+  snapshot.read(gen);
+  snapshot.read(dis);
+  ship.restore(snapshot);
+  saucer.restore(snapshot);
+  debris.restore(snapshot);
+  for (Asteroid & asteroid : asteroids) {
+    asteroid.restore(snapshot);
+  }
+  for (Debris & debris : debrises) {
+    debris.restore(snapshot);
+  }
+  snapshot.read(game_events);
+  snapshot.read(no_of_ships);
+  snapshot.read(current_no_of_asteroids);
+  snapshot.read(no_of_asteroids);
+  snapshot.read(next_asteroid);
+  snapshot.read(next_debris);
+  snapshot.read(score);
+  snapshot.read(time_since_start_of_level);
+  snapshot.read(saucer_timer);
+  snapshot.read(ship_spawn_timer);
+  snapshot.read(new_asteroids_spawn_timer);
+  physics.restore(snapshot, [this](size_t id) -> Body2df * { return bodies_by_id[id]; });
 }
 
 void Game::spawn_asteroids() {
@@ -408,11 +559,12 @@ Spaceship & Game::get_ship() {
 }
 
 bool Game::area_free_of_asteroids(BoundingVolume2df * bounding) {
-  return physics.is_area_free_of_bodies(bounding,
-     [bounding](Body2df * body) -> bool { TypedBody * typed_body = static_cast<TypedBody *>(body);  
-                                          return ! typed_body->is_marked_for_deletion()
-                                                    && typed_body->get_type() == BodyType::asteroid;
-                                        });                                
+  Body2df * found[1];
+  return physics.query_circle(bounding->get_position(), bounding->get_radius(), found,
+     [](Body2df * body) -> bool { TypedBody * typed_body = static_cast<TypedBody *>(body);
+                                  return ! typed_body->is_marked_for_deletion()
+                                            && typed_body->get_type() == BodyType::asteroid;
+                                }) == 0;
 }
 
 void Game::spawn_ship() {
@@ -559,18 +711,3 @@ void Game::resolve_collision(Body2df *body1, Body2df *body2) {
   }    
 }
   
-bool Game::check_collision(Body2df *body1, Body2df *body2) {
-  TypedBody *typed_body1 = static_cast<TypedBody *>(body1);
-  TypedBody *typed_body2 = static_cast<TypedBody *>(body2);
-  bool torpedo = typed_body1->get_type() == BodyType::torpedo
-                  || typed_body2->get_type() == BodyType::torpedo;
-  bool asteroid = typed_body1->get_type() == BodyType::asteroid
-                  || typed_body2->get_type() == BodyType::asteroid;
-  bool spaceship = typed_body1->get_type() == BodyType::spaceship
-                  || typed_body2->get_type() == BodyType::spaceship;
-  bool saucer = typed_body1->get_type() == BodyType::saucer
-                  || typed_body2->get_type() == BodyType::saucer;
-  return ( torpedo && (asteroid || spaceship || saucer ) )
-       || (asteroid && (saucer || spaceship) )
-       || (saucer && spaceship);  
-}
@@ -7,11 +7,18 @@
 #include <random>
 #include "timer.h"
 #include "physics.h" 
+#include "snapshot.h"
 
 // all different types of object used in this Asteroid-Game
 // for each type there will be a corresponding class
 enum class BodyType : short { spaceship, asteroid, torpedo, saucer, spaceship_debris, debris };
 
+// the collision category of the bodies of a type, one bit per type, and the categories they collide with
+// (see Body::set_collision_filter): torpedos, asteroids, the spaceship and the saucer collide with each
+// other, except torpedos with torpedos and asteroids with asteroids, and the debris collides with nothing
+uint32_t get_collision_category(BodyType type);
+uint32_t get_collision_mask(BodyType type);
+
 // these games events are generated during each tick and can, for instance, be used to
 // generate special view or sound effects
 enum class GameEvent : short { small_asteroid_destroyed, medium_asteroid_destroyed, large_asteroid_destroyed,
@@ -22,8 +29,6 @@ enum class GameEvent : short { small_asteroid_destroyed, medium_asteroid_destroy
 
 class Game;
 
-void displacement_fix(Body2df * body, float seconds = 1.0);
-
 static std::random_device rd;
 static std::mt19937 gen(rd());
 static std::uniform_real_distribution<float> dis(0.0, 0.99);
@@ -33,11 +38,17 @@ class TypedBody : public Body2df {
 protected:
   BodyType type;
 public:
-  TypedBody(BodyType type, Body2df body) : Body2df(body), type(type) { }
+  TypedBody(BodyType type, Body2df body) : Body2df(body), type(type) {
+    set_collision_filter( ::get_collision_category(type), ::get_collision_mask(type) );
+  }
 
-  BodyType get_type() {
+  BodyType get_type() const {
     return type;
   }
+
+  // the state of the body and its type, see Body::save
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
 };
 
 class Asteroid : public TypedBody {
@@ -51,6 +62,9 @@ public:
   short get_size() const;
   
   short get_rock_type() const;
+
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
 };
 
 class Torpedo : public TypedBody {
@@ -66,7 +80,7 @@ public:
     : TypedBody(BodyType::torpedo, 
                 Body2df{ BoundingVolume2df{position + 14.0f * Vector2df( angle ), 1.0},
                          velocity + 1.1f * MAX_SPEED / 2.0f * Vector2df( angle ),
-                         MAX_SPEED, 0.0f, angle, displacement_fix} ) 
+                         MAX_SPEED, 0.0f, angle} ) 
     { set_time_to_delete(1.2f);
     }
 
@@ -104,6 +118,10 @@ public:
   void turn_right(float seconds);
   void jump_into_hyperspace(Game & game);
   void jump_out_of_hyperspace(Game & game);
+  std::array<Torpedo, 4> & get_torpedos();
+  // the state of the ship and its torpedos
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
 };
 
 
@@ -114,7 +132,7 @@ public:
   SpaceshipDebris(Vector2df position = Vector2df{0.0, 0.0}, float angle = 0.0)
     : TypedBody(BodyType::spaceship_debris,
                 Body2df{ BoundingVolume2df{position, 0.0},
-                         Vector2df{0.0, 0.0}, 384.0, 0.0, angle, displacement_fix} )
+                         Vector2df{0.0, 0.0}, 384.0, 0.0, angle} )
   {
     set_time_to_delete(TIME_TO_DELETE);
   }
@@ -128,7 +146,7 @@ class Saucer : public TypedBody {
   short size; // 0 = small, 1 = big
   char precise_shoot_counter = 0; // every sixth torpedo of a small saucer shoots in direction to the spaceship
 public:
-  Saucer(short size = 1, Vector2df position = Vector2df{0.0, 0.0}, std::function<void(Body2df *, float)> saucer_fix = displacement_fix)
+  Saucer(short size = 1, Vector2df position = Vector2df{0.0, 0.0}, std::function<void(Body2df *, float)> saucer_fix = [](Body2df *, float) -> void { })
     : TypedBody(BodyType::saucer,
                 Body2df{ BoundingVolume2df{position, static_cast<float>(size == 1 ? 15 : 7) },
                          Vector2df{0.0, 0.0}, 200.0, 0.0, 0.0, saucer_fix} ) 
@@ -146,6 +164,10 @@ public:
   void pass_time(float seconds, Game & game);
   void clear_torpedos();
   short get_size() const;
+  std::array<Torpedo, 2> & get_torpedos();
+  // the state of the saucer and its torpedos, the saucer keeps its fix callback
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
 };
 
 
@@ -156,7 +178,7 @@ public:
   Debris(Vector2df position = Vector2df{0.0, 0.0}, float angle = 0.0f)
     : TypedBody( BodyType::debris,
                  Body2df{ BoundingVolume2df{position, 0.0f},
-                          Vector2df{0.0, 0.0}, 0.0f, 0.0f, angle, displacement_fix })
+                          Vector2df{0.0, 0.0}, 0.0f, 0.0f, angle })
   {
     set_time_to_delete(TIME_TO_DELETE);
   }
@@ -180,7 +202,8 @@ class Game {
   static constexpr short NO_OF_ASTEROIDS_AT_START = 4;
   static constexpr short MAXIMUM_ASTEROIDS_SPAWNING = 11;
   void saucer_fix(Body2df * body, float seconds);
-  Physics2df physics{ [&](Body2df * b1, Body2df * b2) -> bool { return this->check_collision(b1, b2); },
+  // the collision filters of the bodies select the pairs to resolve, see get_collision_mask
+  Physics2df physics{ [](Body2df *, Body2df *) -> bool { return true; },
                       [&](Body2df * b1, Body2df * b2) -> void { this->resolve_collision(b1, b2); }};
   Spaceship ship{ Vector2df{512.0, 368.0} };
   Saucer saucer{1, Vector2df{70.0, 70.0}, [&] (Body2df * body, float time)-> void { this->saucer_fix(body, time); } };
@@ -194,10 +217,12 @@ class Game {
   size_t next_asteroid = 0; // next unused asteroid 
   size_t next_debris = 0; // cycles throw the debrises array
   long long score = 0LL;
+  // all game objects, their index is the number of a body in a Snapshot of the physics
+  std::vector<TypedBody *> bodies_by_id;
+  // the index of body in bodies_by_id in O(1), from the index of an asteroid or a debris in its array
+  size_t get_body_id(const Body2df * body) const;
   Asteroid * get_next_asteroid();
   Debris * get_next_debris();
-  // check_collision must not have side effects
-  bool check_collision(Body2df *body1, Body2df *body2);
   void resolve_collision(Body2df *body1, Body2df *body2);
   void destroy_asteroid(Asteroid * asteroid);
   void spawn_ship();
@@ -227,6 +252,12 @@ public:
   Spaceship & get_ship();
   Physics2df & get_physics();
   std::vector<GameEvent> & get_game_events();  
+  // writes the complete state of the game to snapshot: all game objects, the timers and counters,
+  // the random number generator and the bodies taking part in the physics. restore reads it back,
+  // afterwards the game continues exactly like after the save with the same input, e.g. to
+  // simulate the frames since an earlier input again
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
   friend class Saucer;
   friend class Spaceship;
 };
@@ -10,6 +10,10 @@ protected:
 public:
   GameController(Game & game) : game(game) {  }
   
+  // handles the events of the window system, e.g. quitting, once per rendered frame
+  virtual void poll_events() = 0;
+
+  // ticks the game with the keys held down, once per fixed time step
   virtual void do_user_interactions() = 0;
   
   virtual void do_game_events() = 0;
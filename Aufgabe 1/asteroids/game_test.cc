@@ -22,6 +22,23 @@ TEST(SPACESHIP, HalfTurn) {
 }
   
   
+// torpedos, asteroids, the spaceship and the saucer collide with each other, except torpedos with
+// torpedos and asteroids with asteroids, the debris collides with nothing
+TEST(GAME, CollisionFilters) {
+  Spaceship ship{ Vector2df{512.0, 368.0} };
+  Asteroid asteroid1, asteroid2;
+  Torpedo torpedo1, torpedo2;
+  Debris debris;
+
+  EXPECT_TRUE( ship.can_collide(asteroid1) );
+  EXPECT_TRUE( torpedo1.can_collide(asteroid1) );
+  EXPECT_TRUE( torpedo1.can_collide(ship) );
+  EXPECT_FALSE( asteroid1.can_collide(asteroid2) );
+  EXPECT_FALSE( torpedo1.can_collide(torpedo2) );
+  EXPECT_FALSE( debris.can_collide(ship) );
+  EXPECT_FALSE( asteroid1.can_collide(debris) );
+}
+
 TEST(GAME, GetInitalScore) {
   Game game{}; 
   
@@ -57,5 +74,48 @@ TEST(GAME, ShipShoots) {
   ASSERT_EQ(9, game.get_physics().get_bodies().size());
 }
 
+// plays with a fixed input: the ship turns, shoots and accelerates now and then
+void play(Game & game, size_t ticks) {
+  for (size_t i = 0; i < ticks; i++) {
+    game.get_ship().turn_left(1.0f / 60.0f);
+    if (i % 7 == 0) {
+      game.ship_shoots();
+    }
+    if (i % 50 < 10) {
+      game.accelerate_ship(1.0f / 60.0f);
+    }
+    game.tick(1.0f / 60.0f);
+  }
+}
+
+// the positions of all bodies in the physics, the score and the number of ships
+std::vector<float> get_state(Game & game) {
+  std::vector<float> state;
+  for (Body2df * body : game.get_physics().get_bodies()) {
+    state.push_back(body->get_position()[0]);
+    state.push_back(body->get_position()[1]);
+  }
+  state.push_back(game.get_score());
+  state.push_back(game.get_no_of_ships());
+  return state;
+}
+
+TEST(GAME, RestoreSnapshotAndPlayAgain) {
+  Game game{};
+  play(game, 300);
+  Snapshot snapshot(16384);
+  game.save(snapshot);
+  play(game, 900);
+  std::vector<float> state = get_state(game);
+  std::vector<GameEvent> events = game.get_game_events();
+
+  snapshot.rewind();
+  game.restore(snapshot);
+  play(game, 900);
+  EXPECT_LT(0LL, game.get_score());
+  EXPECT_EQ(state, get_state(game));
+  EXPECT_EQ(events, game.get_game_events());
+}
+
 
 }
\ No newline at end of file
@@ -15,23 +15,30 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 }
 #endif
 
+// the rate of rendered frames, the game is ticked with the tick time of the controller independently
+constexpr float FRAME_RATE = 144.0f;
+
 // sets up the model, view, and controller objects
 // main itself is a controller containing the game main loop
 int main(void) {
-  Timer timer;
   Game game{};
   SDL2GameController controller = SDL2GameController{game};
   SDL2Renderer renderer = SDL2Renderer{game, "Asteroids"};
+  FixedTimestep timestep(controller.get_tick_time());
+  FramePacer pacer(1.0f / FRAME_RATE);
   
   renderer.init();
+  float frame_time = 0.0f;
   do {
-    timer.reset();
-    renderer.render();
-    controller.do_user_interactions();
-    if ( ! controller.exit_game() ) {
+    // the input is polled in every frame, also in the frames without a game step
+    controller.poll_events();
+    for (size_t steps = timestep.advance(frame_time); steps > 0 && ! controller.exit_game(); steps--) {
+      controller.do_user_interactions();
       controller.do_game_events();
-      timer.tick_and_delay( controller.get_tick_time() );
     }
+    renderer.set_interpolation( timestep.get_alpha() );
+    renderer.render();
+    frame_time = pacer.wait_for_next_frame();
   } while (! controller.exit_game() );
   renderer.exit();
 
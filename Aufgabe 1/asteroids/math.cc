@@ -11,22 +11,42 @@ template class Vector<float, 4u>;
 
 
 // instantiations of each template function
+#if defined(MATH_NO_EXPRESSION_TEMPLATES)
 template Vector<float, 2u> operator*(float scalar, Vector<float, 2u> value);
 template Vector<float, 2u> operator+(Vector<float, 2u> value, const Vector<float, 2u> addend);
 template Vector<float, 2u> operator-(Vector<float, 2u> value, const Vector<float, 2u> addend);
+#endif
 
 template float operator*(Vector<float, 2u> value, const Vector<float, 2u> addend);
 
+#if defined(MATH_NO_EXPRESSION_TEMPLATES)
 template Vector<float, 3u> operator*(float scalar, Vector<float, 3u> value);
 template Vector<float, 3u> operator+(Vector<float, 3u> value, const Vector<float, 3u> addend);
 template Vector<float, 3u> operator-(Vector<float, 3u> value, const Vector<float, 3u> addend);
+#endif
 
 template float operator*(Vector<float, 3u> value, const Vector<float, 3u> addend);
 
+#if defined(MATH_NO_EXPRESSION_TEMPLATES)
 template Vector<float, 4u> operator*(float scalar, Vector<float, 4u> value);
 template Vector<float, 4u> operator+(Vector<float, 4u> value, const Vector<float, 4u> addend);
 template Vector<float, 4u> operator-(Vector<float, 4u> value, const Vector<float, 4u> addend);
+#endif
 
 template float operator*(Vector<float, 4u> value, const Vector<float, 4u> addend);
 
 
+template class Matrix<float, 2u, 3u>;
+template class Matrix<float, 3u, 3u>;
+template class Matrix<float, 3u, 4u>;
+template class Matrix<float, 4u, 4u>;
+
+template Matrix<float, 2u, 3u> operator*(const Matrix<float, 2u, 3u> & left, const Matrix<float, 2u, 3u> & right);
+template Matrix<float, 3u, 3u> operator*(const Matrix<float, 3u, 3u> & left, const Matrix<float, 3u, 3u> & right);
+template Matrix<float, 3u, 4u> operator*(const Matrix<float, 3u, 4u> & left, const Matrix<float, 3u, 4u> & right);
+template Matrix<float, 4u, 4u> operator*(const Matrix<float, 4u, 4u> & left, const Matrix<float, 4u, 4u> & right);
+
+template Vector<float, 2u> operator*(const Matrix<float, 2u, 3u> & matrix, const Vector<float, 3u> value);
+template Vector<float, 3u> operator*(const Matrix<float, 3u, 3u> & matrix, const Vector<float, 3u> value);
+template Vector<float, 3u> operator*(const Matrix<float, 3u, 4u> & matrix, const Vector<float, 4u> value);
+template Vector<float, 4u> operator*(const Matrix<float, 4u, 4u> & matrix, const Vector<float, 4u> value);
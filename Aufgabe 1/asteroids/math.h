@@ -3,8 +3,131 @@
 
 #include <initializer_list>
 #include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
+#include <cassert>
+#include <concepts>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// The free operators +, - and scalar * Vector are the plain operators returning a Vector when
+// MATH_NO_EXPRESSION_TEMPLATES is defined, which the CMake build does by default. Configuring with
+// -DMATH_EXPRESSION_TEMPLATES=ON lets them build expression templates instead (see below).
+
+// base of all nodes of a vector expression, e.g. VectorSum
+struct vector_expression_node {};
+
+// a node of a vector expression whose value is a Vector<FLOAT_TYPE, N>
+template<class E, class FLOAT_TYPE, size_t N>
+concept vector_expression_node_of = std::is_base_of_v<vector_expression_node, E>
+                                    && std::same_as<typename E::float_type, FLOAT_TYPE> && E::size == N;
+
+// returns the square root of x, std::sqrt at runtime and Newton's method in constant
+// expressions, where std::sqrt can't be used
+template<class FLOAT_TYPE>
+constexpr FLOAT_TYPE square_root(FLOAT_TYPE x) {
+  if (std::is_constant_evaluated()) {
+    if (x != x || x <= 0 || x == std::numeric_limits<FLOAT_TYPE>::infinity()) {
+      return x < 0 ? std::numeric_limits<FLOAT_TYPE>::quiet_NaN() : x;
+    }
+    // starting above the root, the iterations decrease until the precision is exhausted
+    long double root = x > 1 ? x : 1.0L;
+    long double previous;
+    do {
+      previous = root;
+      root = 0.5L * (root + x / root);
+    } while (root < previous);
+    return static_cast<FLOAT_TYPE>(previous);
+  }
+  return std::sqrt(x);
+}
+
+// By default length, normalize, Vector(angle) and Matrix::rotation use the exact std::sqrt,
+// std::sin and std::cos. Define MATH_FAST_APPROXIMATIONS to use the approximations below:
+//   fast_reciprocal_square_root  relative error below 1e-6
+//   fast_sin, fast_cos           absolute error below 1e-6
+#if defined(MATH_FAST_APPROXIMATIONS)
+inline constexpr bool use_fast_approximations = true;
+#else
+inline constexpr bool use_fast_approximations = false;
+#endif
+
+// returns an approximation of 1 / sqrt(x) for x > 0
+// float: the SSE estimate improved by one step of Newton's method y' = y (1.5 - 0.5 x y^2),
+// without SSE (and in constant expressions) the bit trick on the IEEE 754 exponent and three
+// Newton steps, double: the bit trick and three Newton steps
+template<class FLOAT_TYPE>
+constexpr FLOAT_TYPE fast_reciprocal_square_root(FLOAT_TYPE x) {
+  if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+#if defined(__SSE__)
+    if (!std::is_constant_evaluated()) {
+      float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+      return estimate * (1.5f - 0.5f * x * estimate * estimate);
+    }
+#endif
+    float estimate = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<std::uint32_t>(x) >> 1));
+    for (int i = 0; i < 3; i++) {
+      estimate *= 1.5f - 0.5f * x * estimate * estimate;
+    }
+    return estimate;
+  } else if constexpr (std::is_same_v<FLOAT_TYPE, double>) {
+    double estimate = std::bit_cast<double>(0x5fe6eb50c7b537a9ull - (std::bit_cast<std::uint64_t>(x) >> 1));
+    for (int i = 0; i < 3; i++) {
+      estimate *= 1.5 - 0.5 * x * estimate * estimate;
+    }
+    return estimate;
+  } else {
+    return 1 / square_root(x);
+  }
+}
+
+// returns an approximation of sin(x): with the integer k nearest to x / pi, sin(x) = (-1)^k sin(x - k pi),
+// x - k pi in [-pi/2, pi/2] is computed in double precision (so large angles keep their accuracy)
+// and inserted into the Taylor polynomial of degree 11, all without branches
+template<class FLOAT_TYPE>
+constexpr FLOAT_TYPE fast_sin(double x) {
+  constexpr double PI_ = 3.14159265358979323846;
+  constexpr double ROUNDING = 6755399441055744.0; // 1.5 * 2^52, adding it rounds to an integer
+  double shifted = x * (1.0 / PI_) + ROUNDING;
+  double k = shifted - ROUNDING;
+  FLOAT_TYPE sign = 1 - 2 * static_cast<int>(std::bit_cast<std::uint64_t>(shifted) & 1u); // (-1)^k
+  FLOAT_TYPE reduced = static_cast<FLOAT_TYPE>(x - k * PI_);
+  FLOAT_TYPE square = reduced * reduced;
+  return sign * reduced * (1 + square * (FLOAT_TYPE(-1.0 / 6) + square * (FLOAT_TYPE(1.0 / 120) + square * (FLOAT_TYPE(-1.0 / 5040)
+                 + square * (FLOAT_TYPE(1.0 / 362880) + square * FLOAT_TYPE(-1.0 / 39916800))))));
+}
+
+// returns an approximation of cos(x) = sin(x + pi/2), see fast_sin
+template<class FLOAT_TYPE>
+constexpr FLOAT_TYPE fast_cos(double x) {
+  return fast_sin<FLOAT_TYPE>(x + 0.5 * 3.14159265358979323846);
+}
+
+// returns sin(x), fast_sin if MATH_FAST_APPROXIMATIONS is defined
+template<class FLOAT_TYPE>
+FLOAT_TYPE sine(FLOAT_TYPE x) {
+  if constexpr (use_fast_approximations) {
+    return fast_sin<FLOAT_TYPE>(x);
+  }
+  return std::sin(x);
+}
+
+// returns cos(x), fast_cos if MATH_FAST_APPROXIMATIONS is defined
+template<class FLOAT_TYPE>
+FLOAT_TYPE cosine(FLOAT_TYPE x) {
+  if constexpr (use_fast_approximations) {
+    return fast_cos<FLOAT_TYPE>(x);
+  }
+  return std::cos(x);
+}
 
 // A Vector consisting of N scalar values of type FLOAT_TYPE
 template<class FLOAT_TYPE, size_t N>
@@ -19,77 +142,531 @@ struct Vector {
   // if values is empty, then this->vector is initilized with zeros
   // if less than N values are given, then all remaining values of this->vector
   //   are initialized with the last given value 
-  Vector( std::initializer_list<FLOAT_TYPE> values );
+  constexpr Vector( std::initializer_list<FLOAT_TYPE> values );
   
   // creates a unit vector pointing to the given angle (in radians) in the x/y plane
   // angle = 0 points in the direction of the x-axis
   explicit Vector(FLOAT_TYPE angle);
 
+  // evaluates the given vector expression, e.g. a + s * b, component by component
+  template<vector_expression_node_of<FLOAT_TYPE, N> E>
+  constexpr Vector(const E & expression) {
+    for (size_t i = 0u; i < N; i++) {
+      vector[i] = expression[i];
+    }
+  }
+
+  // all components are 0
+  constexpr Vector() : vector{} {}
+
   // adds addend to this Vector and returns the resulting sum
-  Vector & operator+=(const Vector addend);
+  constexpr Vector & operator+=(const Vector addend);
 
   // subtracts minuend from this Vector and returns the resulting difference
-  Vector & operator-=(const Vector minuend);
+  constexpr Vector & operator-=(const Vector minuend);
 
   // multiplies the scalar factor to this vector and returns the result
-  Vector & operator*=(const FLOAT_TYPE factor);
+  constexpr Vector & operator*=(const FLOAT_TYPE factor);
 
   // divides this vector by the given factor and returns the result
-  Vector & operator/=(const FLOAT_TYPE factor);
+  constexpr Vector & operator/=(const FLOAT_TYPE factor);
 
   // returns the reference of the i-th scalar component of this vector      
-  FLOAT_TYPE & operator[](std::size_t i);
+  constexpr FLOAT_TYPE & operator[](std::size_t i);
 
   // returns the i-th scalar component of this Vector
-  FLOAT_TYPE operator[](std::size_t i) const;
+  constexpr FLOAT_TYPE operator[](std::size_t i) const;
 
   // returns the i-th scalar component of this Vector
   // throws an exception if i >= N
   FLOAT_TYPE at(std::size_t i) const;
   
   // normalize this Vector to the length 1  
-  void normalize();
+  constexpr void normalize();
   
   // returns the specular reflective "ray" Vector wrt the give normal vector
   // normal must be a normalized vector
-  Vector get_reflective(Vector normal) const;
+  constexpr Vector get_reflective(Vector normal) const;
   
   // returns the angle of this Vector between the two given axis in radians
   FLOAT_TYPE angle(size_t axis_1, size_t axis_2) const;
 
   // returns the cross product of this Vector with the Vector v
   // only three-dimensional case
-  Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
+  constexpr Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
   
+#if defined(MATH_NO_EXPRESSION_TEMPLATES)
   // returns the scalar product of the given scalar and value
   template <class F, size_t K>    
-  friend Vector<F, K> operator*(F scalar, Vector<F, K> value);
+  friend constexpr Vector<F, K> operator*(F scalar, Vector<F, K> value);
 
   // returns the vector sum of the to given vectors
   template <class F, size_t K>    
-  friend Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
+  friend constexpr Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
 
   // returns the vector difference value - minuend
   template <class F, size_t K>    
-  friend Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
+  friend constexpr Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
+#endif
 
   // returns the (euclidian) length of this Vector
 
-  FLOAT_TYPE length() const;
+  constexpr FLOAT_TYPE length() const;
 
   
   // returns the square of the this Vector's length
 
-  FLOAT_TYPE square_of_length() const;
+  constexpr FLOAT_TYPE square_of_length() const;
 
 
   // returns the scalar (inner) product of two Vectors
 
   template <class F, size_t K>    
-  friend F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
+  friend constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
+
+};
+
+#if !defined(MATH_NO_EXPRESSION_TEMPLATES)
+// ----------------------------------------------------------------------------
+// Expression templates
+//
+// a + b, a - b and s * a don't compute a new Vector but return a small node referencing
+// their operands. A whole expression like a + s * b - c is evaluated only when it is
+// converted to a Vector, with one loop over the components and without temporary
+// Vectors in between.
+// Nodes reference the Vectors of the expression, so convert them to a Vector instead of
+// storing them, e.g. in an auto variable.
+
+// provides float_type and size of a Vector or a node of a vector expression
+template<class E>
+struct vector_expression_traits {};
+
+template<class FLOAT_TYPE, size_t N>
+struct vector_expression_traits<Vector<FLOAT_TYPE, N>> {
+  using float_type = FLOAT_TYPE;
+  static constexpr size_t size = N;
+};
+
+template<class E> requires std::is_base_of_v<vector_expression_node, E>
+struct vector_expression_traits<E> {
+  using float_type = typename E::float_type;
+  static constexpr size_t size = E::size;
+};
+
+// a Vector or a node of a vector expression
+template<class E>
+concept vector_expression = requires { typename vector_expression_traits<E>::float_type; };
+
+// two vector expressions of the same type of Vector
+template<class L, class R>
+concept combinable_vector_expressions = vector_expression<L> && vector_expression<R>
+  && std::same_as<typename vector_expression_traits<L>::float_type, typename vector_expression_traits<R>::float_type>
+  && vector_expression_traits<L>::size == vector_expression_traits<R>::size;
+
+// base of the nodes of a vector expression whose value is a Vector<FLOAT_TYPE, N>
+// offers the const member functions of Vector, which evaluate the expression first
+template<class E, class FLOAT_TYPE, size_t N>
+struct VectorExpression : vector_expression_node {
+  using float_type = FLOAT_TYPE;
+  static constexpr size_t size = N;
+
+  // returns the value of this expression
+  constexpr Vector<FLOAT_TYPE, N> evaluate() const { return static_cast<const E &>(*this); }
+
+  constexpr FLOAT_TYPE length() const { return evaluate().length(); }
+
+  constexpr FLOAT_TYPE square_of_length() const { return evaluate().square_of_length(); }
+
+  constexpr Vector<FLOAT_TYPE, N> get_reflective(Vector<FLOAT_TYPE, N> normal) const { return evaluate().get_reflective(normal); }
+
+  FLOAT_TYPE angle(size_t axis_1, size_t axis_2) const { return evaluate().angle(axis_1, axis_2); }
+
+  constexpr Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const { return evaluate().cross_product(v); }
+};
+
+// nodes are kept by value, Vectors by reference
+template<class E>
+using vector_expression_operand = std::conditional_t<std::is_base_of_v<vector_expression_node, E>, const E, const E &>;
+
+
+// the node of left + right
+template<class L, class R>
+struct VectorSum : VectorExpression<VectorSum<L, R>, typename vector_expression_traits<L>::float_type,
+                                  vector_expression_traits<L>::size> {
+  using float_type = typename vector_expression_traits<L>::float_type;
+  static constexpr size_t size = vector_expression_traits<L>::size;
+
+  vector_expression_operand<L> left;
+  vector_expression_operand<R> right;
+
+  constexpr VectorSum(const L & left, const R & right) : left(left), right(right) {}
+
+  constexpr float_type operator[](std::size_t i) const { return left[i] + right[i]; }
+
+};
+
+// the node of left - right
+template<class L, class R>
+struct VectorDifference : VectorExpression<VectorDifference<L, R>, typename vector_expression_traits<L>::float_type,
+                                  vector_expression_traits<L>::size> {
+  using float_type = typename vector_expression_traits<L>::float_type;
+  static constexpr size_t size = vector_expression_traits<L>::size;
+
+  vector_expression_operand<L> left;
+  vector_expression_operand<R> right;
+
+  constexpr VectorDifference(const L & left, const R & right) : left(left), right(right) {}
+
+  constexpr float_type operator[](std::size_t i) const { return left[i] - right[i]; }
+
+};
+
+// the node of scalar * value
+template<class E>
+struct ScaledVector : VectorExpression<ScaledVector<E>, typename vector_expression_traits<E>::float_type,
+                                  vector_expression_traits<E>::size> {
+  using float_type = typename vector_expression_traits<E>::float_type;
+  static constexpr size_t size = vector_expression_traits<E>::size;
+
+  float_type scalar;
+  vector_expression_operand<E> value;
+
+  constexpr ScaledVector(float_type scalar, const E & value) : scalar(scalar), value(value) {}
+
+  constexpr float_type operator[](std::size_t i) const { return scalar * value[i]; }
+
+};
+
+// returns the node of the vector sum of the two given vector expressions
+template<class L, class R> requires combinable_vector_expressions<L, R>
+constexpr VectorSum<L, R> operator+(const L & value, const R & addend) {
+  return VectorSum<L, R>(value, addend);
+}
+
+// returns the node of the vector difference value - minuend
+template<class L, class R> requires combinable_vector_expressions<L, R>
+constexpr VectorDifference<L, R> operator-(const L & value, const R & minuend) {
+  return VectorDifference<L, R>(value, minuend);
+}
 
+// returns the node of the scalar product of the given scalar and vector expression
+template<class E> requires vector_expression<E>
+constexpr ScaledVector<E> operator*(typename vector_expression_traits<E>::float_type scalar, const E & value) {
+  return ScaledVector<E>(scalar, value);
+}
+
+// returns the scalar (inner) product of two vector expressions, at least one of them a node
+template<class L, class R>
+  requires combinable_vector_expressions<L, R>
+           && (std::is_base_of_v<vector_expression_node, L> || std::is_base_of_v<vector_expression_node, R>)
+constexpr typename vector_expression_traits<L>::float_type operator*(const L & vector1, const R & vector2) {
+  using vector_type = Vector<typename vector_expression_traits<L>::float_type, vector_expression_traits<L>::size>;
+  return vector_type(vector1) * vector_type(vector2);
+}
+#endif
+
+
+// ----------------------------------------------------------------------------
+// constexpr members of Vector
+//
+// They are defined here and not in math.tcc, so they can be evaluated at compile time,
+// e.g. to build lookup tables or scenes as constexpr data.
+
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) {
+  auto iterator = values.begin();
+  for (size_t i = 0u; i < N; i++) {
+    if ( iterator != values.end()) {
+      vector[i] = *iterator++;
+    } else {
+      vector[i] = (i > 0 ? vector[i - 1] : 0.0);
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
+  for (size_t i = 0u; i < N; i++) {
+    vector[i] += addend.vector[i];
+  }
+  return *this;
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
+  for (size_t i = 0u; i < N; i++) {
+    vector[i] -= minuend.vector[i];
+  }
+  return *this;
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
+  for (size_t i = 0u; i < N; i++) {
+    vector[i] *= factor;
+  }
+  return *this;
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
+  for (size_t i = 0u; i < N; i++) {
+    vector[i] /= factor;
+  }
+  return *this;
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
+  return vector[i];
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
+  return vector[i];
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
+  assert(N >= 3u);
+  return {this->vector[1] * v.vector[2] - this->vector[2] * v.vector[1],
+          this->vector[0] * v.vector[2] - this->vector[2] * v.vector[0],
+          this->vector[0] * v.vector[1] - this->vector[1] * v.vector[0] };
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr void Vector<FLOAT_TYPE, N>::normalize() {
+  if constexpr (use_fast_approximations) {
+    *this *= fast_reciprocal_square_root(square_of_length());
+    return;
+  }
+  *this /= length(); //  +/- INFINITY if length is (near to) zero
+}
+
+template <class FLOAT_TYPE, size_t N>  
+constexpr Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
+  assert(0.99999 < normal.square_of_length() && normal.square_of_length()  < 1.000001); 
+  return *this - static_cast<FLOAT_TYPE>(2.0) * (*this * normal ) * normal;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::length() const
+{
+  if constexpr (use_fast_approximations) {
+    FLOAT_TYPE square = square_of_length();
+    return square == 0 ? square : square * fast_reciprocal_square_root(square);
+  }
+  return square_root(square_of_length());
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const
+{
+  FLOAT_TYPE length = 0.0;
+  for(size_t i = 0u; i < N; i++) {
+    length += vector [i] * vector [i];
+  }
+  return length;
+}
+
+template <class F, size_t K>
+constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2)
+{
+  F sc_product = 0.0;
+  for(int i = 0u; i < K; i++) {
+    sc_product += vector1[i] * vector2[i];
+  }
+  return sc_product;
+}
+
+#if defined(MATH_NO_EXPRESSION_TEMPLATES)
+template <class FLOAT_TYPE, size_t N>    
+constexpr Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
+  Vector<FLOAT_TYPE, N> scalar_product = value;
+
+  scalar_product *= scalar;
+
+  return scalar_product;
+}
+
+template <class FLOAT_TYPE, size_t N>    
+constexpr Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
+  Vector<FLOAT_TYPE, N> sum = value;
+  sum += addend;
+  return sum;
+}
+
+template <class FLOAT_TYPE, size_t N>    
+constexpr Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
+  Vector<FLOAT_TYPE, N> difference = value;
+  difference -= minuend;
+  return difference;
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Matrix
+//
+// A Matrix with R rows and C columns of scalar values of type FLOAT_TYPE, stored as R row
+// Vectors. Products, inverses and transformations are computed with Vector operations on
+// whole rows.
+//
+// Square matrices and matrices with one more column than rows are used as affine
+// transformations of points with C - 1 components (2x3 and 3x3 for 2d points, 3x4 and 4x4
+// for 3d points): the last column is the translation, the last row of a square Matrix
+// is assumed to be (0, ..., 0, 1).
+template<class FLOAT_TYPE, size_t R, size_t C>
+class Matrix {
+  static_assert(R > 0u && C > 0u); // no empty matrices allowed
+
+  // row i is the i-th row of this Matrix
+  std::array<Vector<FLOAT_TYPE, C>, R> rows;
+
+public:
+  // true iff this Matrix can be used as affine transformation
+  static constexpr bool is_affine = C == R || C == R + 1u;
+
+  // the number of components of the points of an affine transformation
+  static constexpr size_t D = C - 1u;
+
+  // all values are 0
+  constexpr Matrix() : rows{} {}
+
+  // creates a new Matrix with the given rows
+  // if less than R rows are given, the remaining rows are initialized with zeros
+  constexpr Matrix( std::initializer_list<Vector<FLOAT_TYPE, C>> rows );
+
+  // returns the Matrix with 1 on the main diagonal and 0 elsewhere
+  static constexpr Matrix identity();
+
+  // returns the affine transformation moving points by offset
+  static constexpr Matrix translation(Vector<FLOAT_TYPE, D> offset) requires is_affine;
+
+  // returns the affine transformation scaling the i-th component of points by factors[i]
+  static constexpr Matrix scaling(Vector<FLOAT_TYPE, D> factors) requires is_affine;
+
+  // returns the affine transformation rotating points by angle (in radians) in the x/y plane,
+  // i.e. around the z-axis for 3d points, angle > 0 turns the x-axis towards the y-axis
+  static Matrix rotation(FLOAT_TYPE angle) requires is_affine && (D >= 2u);
+
+  // returns the affine transformation rotating points by angle (in radians) around the given axis
+  // axis must be a normalized vector
+  static Matrix rotation(Vector<FLOAT_TYPE, 3u> axis, FLOAT_TYPE angle) requires is_affine && (D == 3u);
+
+  // returns the reference of the i-th row of this Matrix
+  constexpr Vector<FLOAT_TYPE, C> & operator[](std::size_t i);
+
+  // returns the i-th row of this Matrix
+  constexpr const Vector<FLOAT_TYPE, C> & operator[](std::size_t i) const;
+
+  // returns the j-th column of this Matrix
+  constexpr Vector<FLOAT_TYPE, R> column(std::size_t j) const;
+
+  // returns the transposed Matrix, the rows of this Matrix are its columns
+  constexpr Matrix<FLOAT_TYPE, C, R> transpose() const;
+
+  // returns the determinant of this Matrix
+  FLOAT_TYPE determinant() const requires (R == C);
+
+  // returns the inverse of this Matrix, for matrices with one more column than rows the inverse
+  // of the affine transformation, via Gauss-Jordan elimination with partial pivoting
+  // this Matrix must be invertible (determinant != 0), otherwise the result contains +/- INFINITY or NaN
+  Matrix inverse() const requires is_affine;
+
+  // returns the given point transformed by the affine transformation of this Matrix
+  Vector<FLOAT_TYPE, D> transform_point(Vector<FLOAT_TYPE, D> point) const requires is_affine;
+
+  // returns the given direction transformed by the affine transformation of this Matrix,
+  // directions (and the difference of two points) aren't translated
+  Vector<FLOAT_TYPE, D> transform_direction(Vector<FLOAT_TYPE, D> direction) const requires is_affine;
+
+  // writes the transformed points[i] to transformed[i] for all points,
+  // transformed must have at least as many elements as points and may be the same span
+  void transform_points(std::span<const Vector<FLOAT_TYPE, D>> points, std::span<Vector<FLOAT_TYPE, D>> transformed) const requires is_affine;
+
+  // writes the transformed directions[i] to transformed[i] for all directions, see transform_points
+  void transform_directions(std::span<const Vector<FLOAT_TYPE, D>> directions, std::span<Vector<FLOAT_TYPE, D>> transformed) const requires is_affine;
 };
 
+// returns the Matrix product of left and right
+template <class FLOAT_TYPE, size_t R, size_t K, size_t C>
+Matrix<FLOAT_TYPE, R, C> operator*(const Matrix<FLOAT_TYPE, R, K> & left, const Matrix<FLOAT_TYPE, K, C> & right);
+
+// returns the composition of the affine transformations left and right, right is applied first
+// (the product of the two matrices, both extended by the row (0, ..., 0, 1))
+template <class FLOAT_TYPE, size_t R>
+Matrix<FLOAT_TYPE, R, R + 1u> operator*(const Matrix<FLOAT_TYPE, R, R + 1u> & left, const Matrix<FLOAT_TYPE, R, R + 1u> & right);
+
+// returns the product of matrix and the column vector value
+template <class FLOAT_TYPE, size_t R, size_t C>
+Vector<FLOAT_TYPE, R> operator*(const Matrix<FLOAT_TYPE, R, C> & matrix, const Vector<FLOAT_TYPE, C> value);
+
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C>::Matrix( std::initializer_list<Vector<FLOAT_TYPE, C>> rows ) : rows{} {
+  assert(rows.size() <= R);
+  size_t i = 0;
+  for (const Vector<FLOAT_TYPE, C> & row : rows) {
+    this->rows[i++] = row;
+  }
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::identity() {
+  Matrix<FLOAT_TYPE, R, C> identity;
+  for (size_t i = 0; i < R && i < C; i++) {
+    identity.rows[i][i] = 1.0;
+  }
+  return identity;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::translation(Vector<FLOAT_TYPE, D> offset) requires is_affine {
+  Matrix<FLOAT_TYPE, R, C> translation = identity();
+  for (size_t i = 0; i < D; i++) {
+    translation.rows[i][D] = offset[i];
+  }
+  return translation;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::scaling(Vector<FLOAT_TYPE, D> factors) requires is_affine {
+  Matrix<FLOAT_TYPE, R, C> scaling = identity();
+  for (size_t i = 0; i < D; i++) {
+    scaling.rows[i][i] = factors[i];
+  }
+  return scaling;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Vector<FLOAT_TYPE, C> & Matrix<FLOAT_TYPE, R, C>::operator[](std::size_t i) {
+  return rows[i];
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr const Vector<FLOAT_TYPE, C> & Matrix<FLOAT_TYPE, R, C>::operator[](std::size_t i) const {
+  return rows[i];
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Vector<FLOAT_TYPE, R> Matrix<FLOAT_TYPE, R, C>::column(std::size_t j) const {
+  Vector<FLOAT_TYPE, R> column;
+  for (size_t i = 0; i < R; i++) {
+    column[i] = rows[i][j];
+  }
+  return column;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, C, R> Matrix<FLOAT_TYPE, R, C>::transpose() const {
+  Matrix<FLOAT_TYPE, C, R> transposed;
+  for (size_t j = 0; j < C; j++) {
+    transposed[j] = column(j);
+  }
+  return transposed;
+}
+
+
 static const long double PI = std::acos(-1.0L);
 
 // shorter comfortable type names
@@ -97,4 +674,9 @@ typedef Vector<float, 2u> Vector2df;
 typedef Vector<float, 3u> Vector3df;
 typedef Vector<float, 4u> Vector4df;
 
+typedef Matrix<float, 2u, 3u> Matrix2x3df;
+typedef Matrix<float, 3u, 3u> Matrix3x3df;
+typedef Matrix<float, 3u, 4u> Matrix3x4df;
+typedef Matrix<float, 4u, 4u> Matrix4x4df;
+
 #endif
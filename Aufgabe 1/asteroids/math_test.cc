@@ -400,4 +400,31 @@ TEST(VECTOR, CrossVectorProduct7) {
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
+TEST(FAST_MATH, SinCos) {
+  for (float angle = -20.0f; angle < 20.0f; angle += 0.001f) {
+    EXPECT_NEAR(std::cos(angle), fast_cos<float>(angle), 1e-6);
+    EXPECT_NEAR(std::sin(angle), fast_sin<float>(angle), 1e-6);
+  }
+}
+
+TEST(MATRIX, Rotation2x3df) {
+  Matrix2x3df transformation = Matrix2x3df::translation({10.0, 20.0}) * Matrix2x3df::rotation(PI / 2.0);
+  std::array<Vector2df, 2> points = { Vector2df{1.0, 0.0}, Vector2df{0.0, 2.0} };
+  std::array<Vector2df, 2> transformed;
+  transformation.transform_points(points, transformed);
+
+  EXPECT_NEAR(10.0, transformed[0][0], 0.00001);
+  EXPECT_NEAR(21.0, transformed[0][1], 0.00001);
+  EXPECT_NEAR(8.0, transformed[1][0], 0.00001);
+  EXPECT_NEAR(20.0, transformed[1][1], 0.00001);
+}
+
+TEST(MATRIX, InverseAffine2x3df) {
+  Matrix2x3df transformation = Matrix2x3df::translation({3.0, -2.0}) * Matrix2x3df::scaling({0.5, 0.25});
+  Vector2df point = transformation.inverse().transform_point( transformation.transform_point({4.0, 8.0}) );
+
+  EXPECT_NEAR(4.0, point[0], 0.00001);
+  EXPECT_NEAR(8.0, point[1], 0.00001);
+}
+
 }
@@ -7,4 +7,18 @@ template class Body<float, 2u, BoundingVolumeCircle<float, 2>>;
 template class Physics<float, 2u, BoundingVolumeCircle<float, 2>>;
 template class Body<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
 template class Physics<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
-
+template class GridBroadphase<float, 2u, BoundingVolumeCircle<float, 2>>;
+template class GridBroadphase<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
+template class SweepAndPruneBroadphase<float, 2u, BoundingVolumeCircle<float, 2>>;
+template class SweepAndPruneBroadphase<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
+template class DynamicTreeBroadphase<float, 2u, BoundingVolumeCircle<float, 2>>;
+template class DynamicTreeBroadphase<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
+template class SlotMap<Body<float, 2u, BoundingVolumeCircle<float, 2>> *>;
+template class SlotMap<Body<float, 2u, BoundingVolumeHyperRectangle<float, 2>> *>;
+template class Physics<float, 2u, BoundingVolumeCircle<float, 2>, SweepAndPruneBroadphase<float, 2u, BoundingVolumeCircle<float, 2>>>;
+template class Physics<float, 2u, BoundingVolumeHyperRectangle<float, 2>, SweepAndPruneBroadphase<float, 2u, BoundingVolumeHyperRectangle<float, 2>>>;
+template class Physics<float, 2u, BoundingVolumeCircle<float, 2>, DynamicTreeBroadphase<float, 2u, BoundingVolumeCircle<float, 2>>>;
+template class Physics<float, 2u, BoundingVolumeHyperRectangle<float, 2>, DynamicTreeBroadphase<float, 2u, BoundingVolumeHyperRectangle<float, 2>>>;
+template Vector<float, 2> get_wrapped_position(Vector<float, 2> point, Vector<float, 2> world_extent);
+template Vector<float, 2> get_nearest_image(Vector<float, 2> point, Vector<float, 2> reference, Vector<float, 2> world_extent);
+template bool is_repeating(Vector<float, 2> world_extent);
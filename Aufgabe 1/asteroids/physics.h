@@ -1,7 +1,14 @@
 #ifndef BODY_H
 #define BODY_H
 
+#include <array>
+#include <chrono>
 #include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
 #include <vector>
 #include <functional>
 #include <iostream>
@@ -9,6 +16,22 @@
 #include "math.h"
 #include "timer.h"
 #include "geometry.h"
+#include "slot_map.h"
+#include "thread_pool.h"
+
+
+// returns point moved into [0, world_extent) along each axis of a world repeating with world_extent
+// (a torus), the axes with a world_extent of 0 don't repeat
+template<class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> get_wrapped_position(Vector<FLOAT_TYPE, N> point, Vector<FLOAT_TYPE, N> world_extent);
+
+// returns the copy (image) of point in a world repeating with world_extent, which is nearest to reference
+template<class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> get_nearest_image(Vector<FLOAT_TYPE, N> point, Vector<FLOAT_TYPE, N> reference, Vector<FLOAT_TYPE, N> world_extent);
+
+// returns true iff any axis of world_extent repeats
+template<class FLOAT_TYPE, size_t N>
+bool is_repeating(Vector<FLOAT_TYPE, N> world_extent);
 
 
 // a bounding "box" based on a sphere
@@ -19,12 +42,34 @@ public:
 
   bool collides(BoundingVolumeCircle<FLOAT_TYPE, N> volume) const;
 
+  // collides in a world repeating with world_extent, the nearest image of volume is tested
+  bool collides(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> world_extent) const;
+
+  // returns the time of impact t if this volume moves by displacement while volume stays: this volume
+  // first touches volume at its position + t * displacement, t is 0 if both collide already and greater
+  // than 1 if they don't collide during the movement (infinity if they never collide). The swept circle
+  // is the ray from the center against the circle around volume's center with the sum of both radii
+  FLOAT_TYPE get_time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement) const;
+
+  // the time of impact with the nearest image of volume in a world repeating with world_extent
+  FLOAT_TYPE get_time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement,
+                                Vector<FLOAT_TYPE, N> world_extent) const;
+
   FLOAT_TYPE get_radius() const;
   
   Vector<FLOAT_TYPE,N> get_position() const;
     
   void set_position(Vector<FLOAT_TYPE,N> position);  
-  
+
+  // returns the lower and the upper corner of the smallest axis aligned box containing this volume
+  Vector<FLOAT_TYPE,N> get_lower_corner() const;
+  Vector<FLOAT_TYPE,N> get_upper_corner() const;
+
+  // returns the distance of point to this volume, 0 if point is inside
+  FLOAT_TYPE get_distance(Vector<FLOAT_TYPE,N> point) const;
+
+  // returns true iff this volume overlaps the axis aligned box from lower to upper
+  bool overlaps(Vector<FLOAT_TYPE,N> lower, Vector<FLOAT_TYPE,N> upper) const;
 };
 
 
@@ -39,15 +84,47 @@ public:
 
   bool collides(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume) const;
 
+  // collides in a world repeating with world_extent, the image of volume with the nearest center is tested
+  bool collides(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> world_extent) const;
+
+  // returns the time of impact if this box moves by displacement while volume stays, see
+  // BoundingVolumeCircle::get_time_of_impact. The swept box is the ray from the lower corner
+  // against volume grown by the edge lengths of this box
+  FLOAT_TYPE get_time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement) const;
+
+  // the time of impact with the image of volume with the nearest center in a world repeating with world_extent
+  FLOAT_TYPE get_time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement,
+                                Vector<FLOAT_TYPE, N> world_extent) const;
+
   FLOAT_TYPE get_edge_length(size_t edge) const;
   
   Vector<FLOAT_TYPE,N> get_position() const;
     
   void set_position(Vector<FLOAT_TYPE,N> position);  
-  
+
+  // returns the lower and the upper corner of this box
+  Vector<FLOAT_TYPE,N> get_lower_corner() const;
+  Vector<FLOAT_TYPE,N> get_upper_corner() const;
+
+  // returns the distance of point to this volume, 0 if point is inside
+  FLOAT_TYPE get_distance(Vector<FLOAT_TYPE,N> point) const;
+
+  // returns true iff this box overlaps the axis aligned box from lower to upper
+  bool overlaps(Vector<FLOAT_TYPE,N> lower, Vector<FLOAT_TYPE,N> upper) const;
+
+  // returns a value t such that ray.origin + t * ray.direction is the first intersection with the
+  // border of this box (like Sphere::intersects), t <= 0 if no intersection occured
+  FLOAT_TYPE intersects(const Ray<FLOAT_TYPE, N> &ray) const;
 };
 
-template<class FLOAT_TYPE, size_t N, class BV> class Physics;
+template<class FLOAT_TYPE, size_t N, class BV> class Body;
+template<class FLOAT_TYPE, size_t N, class BV> class GridBroadphase;
+template<class FLOAT_TYPE, size_t N, class BV> struct NoFix;
+template<class FLOAT_TYPE, size_t N, class BV,
+         class BROADPHASE = GridBroadphase<FLOAT_TYPE, N, BV>,
+         class CHECK = std::function<bool(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)>,
+         class RESOLVE = std::function<void(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)>,
+         class FIX = NoFix<FLOAT_TYPE, N, BV>> class Physics;
 
 // dynamic physical body  with a bounding value of type BV
 // the body has a (central) position, a velocity, an orientation defined by an angle and other physical attributes
@@ -56,14 +133,34 @@ class Body  {
 protected:
   BV bounding;
   Vector<FLOAT_TYPE, N> velocity;
+  Vector<FLOAT_TYPE, N> previous_position; // before the last move
   FLOAT_TYPE max_velocity;
   FLOAT_TYPE min_velocity;
   FLOAT_TYPE angle;
+  Matrix<FLOAT_TYPE, N, N + 1u> orientation; // rotation by angle in the x/y-plane, updated by turn()
 
-  std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix; // fix object values after movement
+  std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix; // fix object values after movement, may be empty
 
   Counter delete_counter;
   bool deletable = false;
+
+  // a sleeping body is not moved by Physics::tick, see is_sleeping
+  bool sleeping = false;
+  bool static_body = false;
+
+  // the bits of the collision categories of the body and of the categories it collides with
+  uint32_t collision_category = 1u;
+  uint32_t collision_mask = ~0u;
+
+  // the handle in the Physics the body was added to, set by Physics::tick. It belongs to the body
+  // object, which the Physics refers to: a copy of a body has no handle, and assigning a body to
+  // another one (like a new asteroid to an asteroid of the game) keeps the handle of the assigned one
+  struct OwnHandle : SlotHandle {
+    OwnHandle() = default;
+    OwnHandle(const OwnHandle &) : SlotHandle() { }
+    OwnHandle & operator=(const OwnHandle &) { return *this; }
+    OwnHandle & operator=(SlotHandle handle) { SlotHandle::operator=(handle); return *this; }
+  } handle;
 public:
   Body(  BV bounding_volume,
          Vector<FLOAT_TYPE, N> velocity, 
@@ -73,7 +170,7 @@ public:
 
          std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix 
 
-            = [](Body<FLOAT_TYPE, N, BV> * , FLOAT_TYPE ) -> void {  }); 
+            = nullptr); 
 
  
 
@@ -85,6 +182,7 @@ public:
   // angle is measured in radians
   void turn(FLOAT_TYPE angle, FLOAT_TYPE seconds = 1.0);
 
+  // wakes the body up, a static body keeps its velocity of 0
   void set_velocity(Vector<FLOAT_TYPE, N> velocity);
   
   void accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE seconds = 1.0);
@@ -106,37 +204,378 @@ public:
 
   Vector<FLOAT_TYPE,N> get_position() const;
     
-  void set_position(Vector<FLOAT_TYPE,N> position);  
+  // wakes the body up. A teleport like a spawn or a jump sets reset_interpolation, so the body is
+  // displayed at the new position right away instead of moving there (see get_interpolated_position)
+  void set_position(Vector<FLOAT_TYPE,N> position, bool reset_interpolation = false);  
+
+  // a sleeping body is at rest: Physics::tick neither moves it nor calls its fix callbacks, only its
+  // time to delete runs down, and pairs of two sleeping bodies are not tested for collisions.
+  // Physics::tick puts the bodies without velocity and without a fix callback to sleep at the end
+  // of the tick, unless they were in a collision accepted by check_collision during it. Changing the
+  // velocity or the position wakes a body up. Static bodies are always sleeping
+  bool is_sleeping() const;
+
+  // a static body never moves, like a fixed obstacle: its velocity is set to 0 and it ignores set_velocity
+  void set_static(bool static_body);
+
+  bool is_static() const;
+
+  // puts the body into the collision categories given by the bits of category and lets it collide
+  // with the bodies in the categories of mask. Two bodies collide only if the category of each one
+  // shares a bit with the mask of the other one: the broadphases leave the other pairs out before
+  // their bounding volumes are tested, so check_collision isn't called for them. By default a body
+  // is in category 1 and collides with all bodies
+  void set_collision_filter(uint32_t category, uint32_t mask);
+
+  uint32_t get_collision_category() const;
+
+  uint32_t get_collision_mask() const;
+
+  // returns true iff the collision filters of this body and body let them collide, one AND per direction
+  bool can_collide(const Body<FLOAT_TYPE, N, BV> & body) const;
+
+  // returns the position between the position before the last move (alpha = 0) and the current
+  // position (alpha = 1), to display the body between two ticks of a fixed time step. In a world
+  // repeating with world_extent the shorter way across the border is taken
+  Vector<FLOAT_TYPE,N> get_interpolated_position(FLOAT_TYPE alpha, Vector<FLOAT_TYPE,N> world_extent = Vector<FLOAT_TYPE,N>()) const;
   
-  friend class Physics<FLOAT_TYPE, N, BV>;
+  template<class, size_t, class, class, class, class, class> friend class Physics;
 
   BV get_bounding_volume() const;
+
+  // returns the handle of this body in the Physics it takes part in, see Physics::get_body
+  SlotHandle get_handle() const;
+
+  // writes the state of this body to snapshot and reads it back, see Snapshot. The fix callback
+  // and the handle belong to the body object and are kept by restore
+  void save(Snapshot & snapshot) const;
+  void restore(Snapshot & snapshot);
 };
 
 
-// a basic physic engine controlling the movements and collisions of Body-objects
-// the collisions are resolved with callback handlers
+// Broadphases find the pairs of bodies whose bounding volumes collide, they are the policy BROADPHASE
+// of Physics. find_colliding_pairs appends the index pairs (i, j) with i < j of all bodies[i] and
+// bodies[j] whose bounding volumes collide to pairs, ordered by i and j like the nested loop over
+// all pairs. The bodies may differ between two calls, new bodies are appended and removed bodies
+// are erased from the vector, a broadphase keeping state between the calls identifies the bodies
+// by their handles (see Body::get_handle). The pairs of two sleeping bodies (see Body::is_sleeping) are left out,
+// they can't have started to collide, and so are the pairs whose collision filters don't match
+// (see Body::can_collide). set_world_extent makes the broadphase find the collisions in a world
+// repeating with the given extent (see Physics::set_world_extent). A broadphase may offer
+// set_thread_pool to split its search across the threads of a ThreadPool (see Physics::set_thread_count),
+// the pairs have to be the same as without threads. A broadphase may offer
+//   template<class VISITOR> void query_box(Vector lower, Vector upper, VISITOR visit) const
+// for the spatial queries of Physics: it calls the bool visit(size_t i) with the index i in the bodies
+// of the last find_colliding_pairs at least for each body whose bounding box overlapped the box from
+// lower to upper, as long as visit returns true. It may call visit for other bodies, and more than once
+// for a body, but must not touch the bodies, which may have been removed and destroyed since.
+
+// tests all pairs of bodies, or only the pairs of bodies sharing a cell of a uniform grid:
+// the bounding volumes are binned into square cells with the edge length cell_size
+template<class FLOAT_TYPE, size_t N, class BV>
+class GridBroadphase {
+  // edge length of the cells, 0 if all pairs of bodies are tested
+  FLOAT_TYPE cell_size = 0.0;
+
+  Vector<FLOAT_TYPE, N> world_extent;
+
+  // the edge lengths of the cells and, along the repeating axes, the number of cells, which is
+  // chosen so that the cells fill the world_extent. Set for each tick
+  Vector<FLOAT_TYPE, N> cell_sizes;
+  std::array<long, N> cell_counts;
+
+  // the grid: (cell, index of body) for every cell overlapped by a bounding volume, and the
+  // cell of each body's lower corner. Both are members to reuse their memory in each tick
+  std::vector<std::pair<std::array<long, N>, size_t>> grid_entries;
+  std::vector<std::array<long, N>> lower_cells;
+
+  // the index of the first grid entry of each occupied cell, followed by the number of entries
+  std::vector<size_t> cell_begins;
+
+  // may be nullptr, and the pairs found by each part of the search with it
+  ThreadPool * thread_pool = nullptr;
+  std::vector<std::vector<std::pair<size_t, size_t>>> part_pairs;
+
+  // returns the grid cell containing the given point
+  std::array<long, N> get_cell(Vector<FLOAT_TYPE, N> point) const;
+
+  void find_colliding_pairs_in_grid(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, std::vector<std::pair<size_t, size_t>> & pairs);
+
+  // tests the pairs (i, j) with begin <= i < end and i < j
+  void test_all_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, size_t begin, size_t end,
+                      std::vector<std::pair<size_t, size_t>> & pairs) const;
+
+  // tests the pairs of bodies in the occupied cells begin, ..., end - 1 (counted like cell_begins)
+  void test_cells(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, size_t begin, size_t end,
+                  std::vector<std::pair<size_t, size_t>> & pairs) const;
+public:
+  // choose about the diameter of the typical body, a cell_size of 0 (the default) tests all pairs of bodies
+  void set_cell_size(FLOAT_TYPE cell_size);
+
+  // the cells along the repeating axes wrap around
+  void set_world_extent(Vector<FLOAT_TYPE, N> world_extent);
+
+  // splits the rows of all pairs or the cells across the threads of thread_pool, nullptr to search in the calling thread
+  void set_thread_pool(ThreadPool * thread_pool);
+
+  void find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, std::vector<std::pair<size_t, size_t>> & pairs);
+};
+
+// sweep and prune along the x-axis: the bodies are kept sorted by the lower end of their bounding
+// volume's x-interval, and each body is only tested with the following bodies whose interval starts
+// before its own ends. The order of the last tick is re-sorted with insertion sort, which takes about
+// linear time as long as the bodies move slowly compared to the tick rate.
+// If the x-axis repeats, the sweep of the bodies at its end continues at its beginning.
+template<class FLOAT_TYPE, size_t N, class BV>
+class SweepAndPruneBroadphase {
+  struct Interval {
+    Body<FLOAT_TYPE, N, BV> * body;
+    SlotHandle handle; // of body, which identifies it between the ticks
+    size_t index; // of body in the current bodies
+    FLOAT_TYPE lower, upper;
+  };
+  // sorted by lower, kept between the ticks, and the longest interval of the last tick
+  std::vector<Interval> intervals;
+  FLOAT_TYPE max_interval_length = 0.0;
+
+  // the index in the current bodies of the body with each slot of a handle (see Body::get_handle),
+  // valid if the handle of that body is the one of the interval, and whether each body already has
+  // an interval, members to reuse their memory
+  std::vector<size_t> slot_indices;
+  std::vector<bool> has_interval;
+
+  Vector<FLOAT_TYPE, N> world_extent;
+
+  // may be nullptr, and the pairs found by each part of the sweep with it
+  ThreadPool * thread_pool = nullptr;
+  std::vector<std::vector<std::pair<size_t, size_t>>> part_pairs;
+
+  // sweeps the intervals[i] with begin <= i < end
+  void sweep(size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> & pairs) const;
+public:
+  void set_world_extent(Vector<FLOAT_TYPE, N> world_extent);
+
+  // splits the sweep across the threads of thread_pool, nullptr to sweep in the calling thread
+  void set_thread_pool(ThreadPool * thread_pool);
+
+  void find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, std::vector<std::pair<size_t, size_t>> & pairs);
+
+  // visits the indices of the bodies whose x-interval overlaps the one of the box, found by binary search
+  template<class VISITOR>
+  void query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit) const;
+};
+
+// a dynamic tree of axis aligned boxes (a bounding volume hierarchy), which is updated incrementally:
+// each body is a leaf whose box is its bounding box enlarged by margin on all sides (a "fat" box), so
+// a body moving less than margin needs no update. Inner nodes bound their two children and are
+// balanced by rotations like an AVL tree. The pairs of leaves with overlapping boxes are kept between
+// the ticks, only the leaves inserted again are queried for new ones. Besides the pairs for tick()
+// the tree offers query_box for the spatial queries of Physics (see Physics::query_circle).
+// In a repeating world the boxes crossing its borders are queried with their images on the other side.
+template<class FLOAT_TYPE, size_t N, class BV>
+class DynamicTreeBroadphase {
+  static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  struct Node {
+    Vector<FLOAT_TYPE, N> lower, upper; // the (fat) box
+    size_t parent = NONE,
+           left = NONE, // left and right are NONE for leaves
+           right = NONE,
+           height = 0; // 0 for leaves
+    Body<FLOAT_TYPE, N, BV> * body = nullptr; // leaves only
+    SlotHandle handle; // of body, which identifies it between the ticks
+    size_t index = 0; // of body in the bodies of the last tick
+
+    bool is_leaf() const { return left == NONE; }
+  };
+  // the nodes, unused nodes form a list connected by parent
+  std::vector<Node> nodes;
+  size_t root = NONE;
+  size_t free_nodes = NONE;
+
+  FLOAT_TYPE margin = 4.0;
+
+  Vector<FLOAT_TYPE, N> world_extent;
+
+  // the leaf of the body with each slot of a handle (see Body::get_handle), NONE for the free slots
+  std::vector<size_t> slot_leaves;
+  // true for the nodes of the leaves whose body is still there in this tick, a member to reuse its memory
+  std::vector<bool> kept;
+
+  // the pairs (a, b) with a < b of leaves whose boxes overlap
+  std::vector<std::pair<size_t, size_t>> leaf_pairs;
+  // true for the nodes of the leaves inserted, moved or removed in this tick
+  std::vector<bool> moved;
+  // the leaves found for one moved leaf, a member to reuse its memory
+  std::vector<size_t> found_leaves;
+  // the stack of query_box, a member to reuse its memory
+  mutable std::vector<size_t> query_stack;
+
+  size_t allocate_node();
+  void free_node(size_t node);
+  void insert_leaf(size_t leaf);
+  void remove_leaf(size_t leaf);
+  // restores the boxes and heights from node up to the root, balancing each node on the way
+  void refit(size_t node);
+  // rotates the higher child of node up if the heights of both children differ by more than 1,
+  // returns the node now at the position of node
+  size_t balance(size_t node);
+
+  // returns the sum of the edge lengths of the box from lower to upper, the cost of a node in the tree
+  static FLOAT_TYPE get_cost(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper);
+
+  // return the component-wise minimum and maximum of a and b
+  static Vector<FLOAT_TYPE, N> get_minimum(Vector<FLOAT_TYPE, N> a, Vector<FLOAT_TYPE, N> b);
+  static Vector<FLOAT_TYPE, N> get_maximum(Vector<FLOAT_TYPE, N> a, Vector<FLOAT_TYPE, N> b);
+
+  // returns true iff the boxes from lower1 to upper1 and from lower2 to upper2 overlap,
+  // or the first one contains the second one
+  static bool overlap(Vector<FLOAT_TYPE, N> lower1, Vector<FLOAT_TYPE, N> upper1, Vector<FLOAT_TYPE, N> lower2, Vector<FLOAT_TYPE, N> upper2);
+  static bool contains(Vector<FLOAT_TYPE, N> lower1, Vector<FLOAT_TYPE, N> upper1, Vector<FLOAT_TYPE, N> lower2, Vector<FLOAT_TYPE, N> upper2);
+
+  // calls visit for all leaves whose box overlaps the box from lower to upper, until visit returns false
+  // stack is used for the traversal, it is passed to reuse its memory
+  template<class VISITOR>
+  void query(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, std::vector<size_t> & stack, VISITOR visit) const;
+public:
+  // sets the enlargement of the leaves' boxes, it takes effect for the bodies updated in the next ticks
+  void set_margin(FLOAT_TYPE margin);
+
+  void set_world_extent(Vector<FLOAT_TYPE, N> world_extent);
+
+  // returns the height of the tree, 0 for no or one body
+  size_t get_height() const;
+
+  void find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, std::vector<std::pair<size_t, size_t>> & pairs);
+
+  // visits the indices of the bodies whose fat box overlaps the box from lower to upper
+  template<class VISITOR>
+  void query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit) const;
+};
+
+
+// the default callbacks of Physics: all collisions are resolved, resolving and fixing do nothing
 template<class FLOAT_TYPE, size_t N, class BV>
+struct AcceptAllCollisions {
+  bool operator()(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *) const { return true; }
+};
+
+template<class FLOAT_TYPE, size_t N, class BV>
+struct IgnoreCollisions {
+  void operator()(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *) const { }
+};
+
+template<class FLOAT_TYPE, size_t N, class BV>
+struct NoFix {
+  void operator()(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE) const { }
+};
+
+// the default filters of the spatial queries of Physics: all bodies are found, and the bodies marked
+// for deletion don't occupy an area
+template<class FLOAT_TYPE, size_t N, class BV>
+struct AcceptAllBodies {
+  bool operator()(Body<FLOAT_TYPE, N, BV> *) const { return true; }
+};
+
+template<class FLOAT_TYPE, size_t N, class BV>
+struct SkipBodiesMarkedForDeletion {
+  bool operator()(Body<FLOAT_TYPE, N, BV> * body) const { return !body->is_marked_for_deletion(); }
+};
+
+
+// what the last Physics::tick did, to compare broadphases and storage layouts: the wall clock
+// time of its phases in seconds and the number of bodies and pairs
+struct TickStatistics {
+  double add_remove_time = 0.0; // adding the new bodies and removing the deleted ones
+  double integrate_time = 0.0; // moving and fixing the bodies
+  double pair_search_time = 0.0; // finding the colliding pairs with the broadphase (and swept pairs)
+  double resolve_time = 0.0; // check_collision, resolve_collision and putting bodies to sleep
+  size_t body_count = 0;
+  size_t pair_count = 0; // found by the broadphase
+  size_t resolved_count = 0; // accepted by check_collision
+
+  double get_total_time() const { return add_remove_time + integrate_time + pair_search_time + resolve_time; }
+};
+
+// a basic physic engine controlling the movements and collisions of Body-objects
+// the collisions are found by the BROADPHASE and resolved with callback handlers.
+// The callbacks are functors of the types CHECK, RESOLVE and FIX, which are called as
+//   bool check_collision(Body *, Body *), void resolve_collision(Body *, Body *), void fix(Body *, FLOAT_TYPE seconds)
+// CHECK and RESOLVE are std::function by default, which takes any callable. Functor types with an
+// inline operator() let the compiler inline the callbacks into tick(), a Physics with such types
+// includes physics.tcc in the translation unit instantiating it (like physics.cc).
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
 class Physics {
-  // all Body objects controlled by the engine
-  std::vector<Body<FLOAT_TYPE, N, BV> *> bodies;
+  // all Body objects controlled by the engine, with O(1) insertion, removal and lookup by handle
+  SlotMap<Body<FLOAT_TYPE, N, BV> *> registry;
 
   // Body objects waiting to be added to this engine in the next call to tick()
   std::vector<Body<FLOAT_TYPE, N, BV> *> bodies_to_add;
 
   // collision callback that returns true if the collision of to Body objects has to be resolved
-  std::function<bool(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> check_collision;
+  CHECK check_collision;
   
   // callback that is responsible for resolving the collision
-  std::function<void(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> resolve_collision;
+  RESOLVE resolve_collision;
+
+  // callback for each Body after it moved (and after its own fix), before the collisions are checked.
+  // It is not called for sleeping bodies
+  FIX fix;
   FLOAT_TYPE tick_time = 1.0;
+
+  // the size of the world, which repeats along the axes with a non-zero extent, see set_world_extent
+  Vector<FLOAT_TYPE, N> world_extent;
+
+  // finds the pairs of bodies whose bounding volumes collide during tick()
+  BROADPHASE broadphase;
+
+  // nullptr for a single thread, see set_thread_count
+  std::unique_ptr<ThreadPool> thread_pool;
+
+  TickStatistics statistics;
+
+  // the bodies the broadphase searched in the last tick, nullptr for the ones removed since, empty
+  // after restore() until the next tick. The number of the current spatial query and, for each of
+  // these bodies, the last query which visited it
+  std::vector<Body<FLOAT_TYPE, N, BV> *> searched_bodies;
+  unsigned query_number = 0;
+  std::vector<unsigned> query_marks;
+
+  // see set_continuous_collision_detection, and the time of impact of the pair being resolved
+  bool continuous_collision_detection = false;
+  FLOAT_TYPE time_of_impact = 1.0;
+
+  // returns the displacement of body in the last tick, from its position before the move to its current
+  // one, across the border of a repeating world the shorter way. Fix callbacks and velocity limits may
+  // have changed the velocity during the tick, so it can differ from tick_time times the velocity
+  Vector<FLOAT_TYPE, N> get_displacement(const Body<FLOAT_TYPE, N, BV> * body) const;
+
+  // returns the time of impact of bodies[i] and bodies[j] during the last tick, as a fraction of tick_time,
+  // from their positions before the tick
+  FLOAT_TYPE get_time_of_impact(size_t i, size_t j) const;
+
+  // whether each body moved so far in the last tick that it may have passed through another one,
+  // a member to reuse its memory
+  std::vector<bool> fast_bodies;
+
+  // appends the pairs of bodies which collided during the tick but not at its end to the sorted
+  // pairs (i, j), keeping them sorted. Only the fast bodies can pass through another body in one
+  // tick, so each fast body is swept against the bodies the broadphase finds near its path
+  void add_swept_pairs(std::vector<std::pair<size_t, size_t>> & pairs);
+
+  // calls visit(body) for the bodies whose bounding box may overlap the box from lower to upper,
+  // and its images in a repeating world, until visit returns false. Each body is visited once,
+  // the candidates are found by the broadphase if it offers query_box, else all bodies are visited.
+  // Returns the number of bodies visited
+  template<class VISITOR>
+  size_t visit_candidates(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit);
 public:
 
-  Physics( std::function<bool(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> check_collision
-                   = [](Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> * ) -> bool { return true; },
+  Physics( CHECK check_collision = AcceptAllCollisions<FLOAT_TYPE, N, BV>(),
                    
-           std::function<void(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> resolve_collision 
-                              = [](Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *) -> void { }
+           RESOLVE resolve_collision = IgnoreCollisions<FLOAT_TYPE, N, BV>(),
+
+           FIX fix = FIX()
          );
 
   void set_tick_time(FLOAT_TYPE tick_time);
@@ -144,12 +583,50 @@ public:
   // returns the tick_time which was used during the last tick 
   FLOAT_TYPE get_tick_time();
 
+  // sets the cell size of the GridBroadphase (see there), a cell_size of 0 (the default) tests all pairs of bodies
+  void set_grid_cell_size(FLOAT_TYPE cell_size) requires std::same_as<BROADPHASE, GridBroadphase<FLOAT_TYPE, N, BV>>;
+
+  BROADPHASE & get_broadphase();
+
+  // makes the world repeat along each axis with a non-zero extent (a torus for two repeating axes,
+  // like the screen of asteroids): tick() moves the positions into [0, world_extent) after the
+  // bodies moved, and bodies collide with the nearest image of each other body, also across the
+  // borders. An extent of 0 (the default for all axes) leaves the axis unbounded.
+  void set_world_extent(Vector<FLOAT_TYPE, N> world_extent);
+
+  Vector<FLOAT_TYPE, N> get_world_extent() const;
+
+  // makes tick() also find the collisions during the movement of fast bodies (continuous collision
+  // detection), which move farther than half their smallest extent in one tick, like a torpedo
+  // passing through a small asteroid between two ticks. Such a body is swept from its position
+  // before the tick to its position after it, the bodies are assumed to move on straight lines with
+  // their velocity. Each fast body is tested against the bodies near its path, which the broadphase
+  // finds if it offers query_box, else against all bodies.
+  void set_continuous_collision_detection(bool continuous_collision_detection);
+
+  // returns the time of impact of the two bodies passed to resolve_collision during tick(), as a
+  // fraction of the tick_time: 0 if they collided at the start of the tick and 1 at its end. It is
+  // always 1 without continuous collision detection, as only the end of the tick is tested then
+  FLOAT_TYPE get_time_of_impact() const;
+
+  // splits the movement of the bodies and, if the broadphase offers set_thread_pool, the search
+  // for colliding pairs across thread_count threads. The pairs are combined in the order of the
+  // single-threaded search, and check_collision and resolve_collision are still called one after
+  // the other, so tick() gives exactly the same results with any number of threads. The fix
+  // callbacks of the bodies and FIX run concurrently for different bodies and must only change
+  // their own body. A thread_count of 1 (the default) runs tick() in the calling thread only.
+  void set_thread_count(size_t thread_count);
+
   // adds a new Body object to this engine
   // the body is added in the next call to tick()  
   void add_body(Body<FLOAT_TYPE, N, BV> * body);
   
   Body<FLOAT_TYPE, N, BV> * get_body(size_t i);
+
+  // returns the body with the given handle (see Body::get_handle), nullptr if it was removed since
+  Body<FLOAT_TYPE, N, BV> * get_body(SlotHandle handle);
   
+  // the order of the bodies changes when bodies are removed: the last body takes the place of a removed one
   const std::vector<Body<FLOAT_TYPE, N, BV> *> & get_bodies();
 
   // Peforms the follown steps in the given order:
@@ -158,22 +635,67 @@ public:
   // 3. moves all objects according to the current tick_time
   // 4. checks for collisions and uses the callback handler to resolve them
   // 5. removes all Body objects, that has to be deleted
+  // The sleeping bodies are skipped in step 3, see Body::is_sleeping
   void tick();
   
   void tick(FLOAT_TYPE tick_time);
+
+  // returns the phase times and counts of the last tick
+  const TickStatistics & get_tick_statistics() const;
   
-  bool is_area_free_of_bodies(BV * area,
-                              std::function<bool(Body<FLOAT_TYPE, N, BV> *)> check_body
-                                = [](Body<FLOAT_TYPE, N, BV> * body) -> bool {return ! body->is_marked_for_deletion();});
+  // writes the tick_time, the bodies taking part in this engine in their order and the bodies
+  // waiting to be added to snapshot. The bodies are written as the numbers get_id returns, the
+  // owner of the bodies saves their state itself (see Body::save). restore reads it back with the
+  // bodies get_body(id) returns and gives them their handles again. The broadphase finds the pairs
+  // of the restored bodies in the same order, so ticking the restored engine gives the same results
+  void save(Snapshot & snapshot, const std::function<size_t(const Body<FLOAT_TYPE, N, BV> *)> & get_id) const;
+
+  void restore(Snapshot & snapshot, const std::function<Body<FLOAT_TYPE, N, BV> *(size_t)> & get_body);
+
+  template<class CHECK_BODY = SkipBodiesMarkedForDeletion<FLOAT_TYPE, N, BV>>
+  bool is_area_free_of_bodies(BV * area, CHECK_BODY check_body = CHECK_BODY());
+
+  // The spatial queries about the bodies taking part in this engine, e.g. for spawning or the aim
+  // of a saucer. They use the broadphase if it offers query_box, which knows the bodies at their
+  // positions of the last tick, and test all bodies otherwise. The bodies found are written to the
+  // caller's buffer results, at most results.size() of them, and their number is returned, so the
+  // queries allocate no memory. Only the bodies for which the functor filter returns true are found,
+  // all by default. Like the collisions, the queries find the bodies across the borders of a
+  // repeating world, except ray_cast. The queries are templates of the filter, which is inlined into
+  // them, a translation unit calling them includes physics.tcc (like game.cc).
+
+  // the bodies whose bounding volume overlaps the circle (sphere) around center with radius
+  template<class FILTER = AcceptAllBodies<FLOAT_TYPE, N, BV>>
+  size_t query_circle(Vector<FLOAT_TYPE, N> center, FLOAT_TYPE radius, std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                      FILTER filter = FILTER());
+
+  // the bodies whose bounding volume overlaps the axis aligned box from lower to upper
+  template<class FILTER = AcceptAllBodies<FLOAT_TYPE, N, BV>>
+  size_t query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                   FILTER filter = FILTER());
+
+  // returns the body whose bounding volume is hit first by ray, at ray.origin + t * ray.direction
+  // with 0 < t <= max_t, and sets t, or returns nullptr if no body is hit
+  template<class FILTER = AcceptAllBodies<FLOAT_TYPE, N, BV>>
+  Body<FLOAT_TYPE, N, BV> * ray_cast(const Ray<FLOAT_TYPE, N> & ray, FLOAT_TYPE max_t, FLOAT_TYPE & t,
+                                     FILTER filter = FILTER());
+
+  // the results.size() bodies nearest to point (by the distance to their bounding volume), the nearest first
+  template<class FILTER = AcceptAllBodies<FLOAT_TYPE, N, BV>>
+  size_t query_nearest(Vector<FLOAT_TYPE, N> point, std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                       FILTER filter = FILTER());
 };
 
 
 typedef BoundingVolumeCircle<float, 2u> BoundingVolume2df;
 typedef Body<float, 2u, BoundingVolume2df> Body2df;
 typedef Physics<float, 2u, BoundingVolume2df> Physics2df;
+typedef Physics<float, 2u, BoundingVolume2df, SweepAndPruneBroadphase<float, 2u, BoundingVolume2df>> SweepAndPrunePhysics2df;
+typedef Physics<float, 2u, BoundingVolume2df, DynamicTreeBroadphase<float, 2u, BoundingVolume2df>> DynamicTreePhysics2df;
 
 typedef BoundingVolumeHyperRectangle<float, 2u> Rectangle2df;
 typedef Body<float, 2u, Rectangle2df> BodyRect2df;
 typedef Physics<float, 2u, Rectangle2df> PhysicsRect2df;
+typedef Physics<float, 2u, Rectangle2df, DynamicTreeBroadphase<float, 2u, Rectangle2df>> DynamicTreePhysicsRect2df;
 
 #endif
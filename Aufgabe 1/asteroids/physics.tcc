@@ -1,5 +1,42 @@
+#include <algorithm>
 #include <utility>
 
+#include "slot_map.tcc"
+
+template<class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> get_wrapped_position(Vector<FLOAT_TYPE, N> point, Vector<FLOAT_TYPE, N> world_extent) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    if (world_extent[axis] > 0) {
+      point[axis] -= world_extent[axis] * std::floor(point[axis] / world_extent[axis]);
+      if (point[axis] >= world_extent[axis]) { // rounding of tiny negative values
+        point[axis] = 0;
+      }
+    }
+  }
+  return point;
+}
+
+template<class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> get_nearest_image(Vector<FLOAT_TYPE, N> point, Vector<FLOAT_TYPE, N> reference, Vector<FLOAT_TYPE, N> world_extent) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    if (world_extent[axis] > 0) {
+      point[axis] -= world_extent[axis] * std::round((point[axis] - reference[axis]) / world_extent[axis]);
+    }
+  }
+  return point;
+}
+
+template<class FLOAT_TYPE, size_t N>
+bool is_repeating(Vector<FLOAT_TYPE, N> world_extent) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    if (world_extent[axis] > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 template<class FLOAT_TYPE, size_t N>
 BoundingVolumeCircle<FLOAT_TYPE, N>::BoundingVolumeCircle(Vector<FLOAT_TYPE,N> position, FLOAT_TYPE radius) 
  : Sphere<FLOAT_TYPE, N>(position, radius) { }
@@ -9,6 +46,34 @@ bool BoundingVolumeCircle<FLOAT_TYPE, N>::collides(BoundingVolumeCircle<FLOAT_TY
   return this->intersects(volume);
 }
 
+template<class FLOAT_TYPE, size_t N>
+bool BoundingVolumeCircle<FLOAT_TYPE, N>::collides(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> world_extent) const {
+  volume.center = get_nearest_image(volume.center, this->center, world_extent);
+  return this->intersects(volume);
+}
+
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::get_time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement) const {
+  if (this->intersects(volume)) {
+    return 0;
+  }
+  if (displacement * displacement == 0) {
+    return std::numeric_limits<FLOAT_TYPE>::infinity();
+  }
+  Sphere<FLOAT_TYPE, N> swept(volume.center, this->radius + volume.radius);
+  FLOAT_TYPE t = swept.intersects( Ray<FLOAT_TYPE, N>{this->center, displacement} );
+  return t > 0 ? t : std::numeric_limits<FLOAT_TYPE>::infinity();
+}
+
+// the image nearest to the middle of the movement is the one this volume may touch
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::get_time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement,
+                                                                   Vector<FLOAT_TYPE, N> world_extent) const {
+  Vector<FLOAT_TYPE, N> middle = this->center + static_cast<FLOAT_TYPE>(0.5) * displacement;
+  volume.center = get_nearest_image(volume.center, middle, world_extent);
+  return get_time_of_impact(volume, displacement);
+}
+
 template<class FLOAT_TYPE, size_t N>  
 FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::get_radius() const {
   return this->radius;
@@ -25,6 +90,39 @@ void BoundingVolumeCircle<FLOAT_TYPE, N>::set_position(Vector<FLOAT_TYPE,N> posi
   this->center = position;
 }
 
+template<class FLOAT_TYPE, size_t N>  
+Vector<FLOAT_TYPE,N> BoundingVolumeCircle<FLOAT_TYPE, N>::get_lower_corner() const {
+  Vector<FLOAT_TYPE,N> corner = this->center;
+  for (size_t axis = 0u; axis < N; axis++) {
+    corner[axis] -= this->radius;
+  }
+  return corner;
+}
+
+template<class FLOAT_TYPE, size_t N>  
+Vector<FLOAT_TYPE,N> BoundingVolumeCircle<FLOAT_TYPE, N>::get_upper_corner() const {
+  Vector<FLOAT_TYPE,N> corner = this->center;
+  for (size_t axis = 0u; axis < N; axis++) {
+    corner[axis] += this->radius;
+  }
+  return corner;
+}
+
+template<class FLOAT_TYPE, size_t N>  
+FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::get_distance(Vector<FLOAT_TYPE,N> point) const {
+  return std::max<FLOAT_TYPE>((point - this->center).length() - this->radius, 0.0);
+}
+
+// the point of the box nearest to the center is the center clamped to the box
+template<class FLOAT_TYPE, size_t N>
+bool BoundingVolumeCircle<FLOAT_TYPE, N>::overlaps(Vector<FLOAT_TYPE,N> lower, Vector<FLOAT_TYPE,N> upper) const {
+  Vector<FLOAT_TYPE,N> difference;
+  for (size_t axis = 0u; axis < N; axis++) {
+    difference[axis] = this->center[axis] - std::clamp(this->center[axis], lower[axis], upper[axis]);
+  }
+  return difference.square_of_length() <= this->radius * this->radius;
+}
+
 template<class FLOAT_TYPE, size_t N>  
 BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::BoundingVolumeHyperRectangle(Vector<FLOAT_TYPE,N> position, Vector<FLOAT_TYPE,N> edge_lengths )
  : position(position), edge_lengths(edge_lengths) { }
@@ -39,6 +137,14 @@ bool BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::collides(BoundingVolumeHyperRec
  return collision;
 }
 
+template<class FLOAT_TYPE, size_t N>  
+bool BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::collides(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> world_extent) const {
+  Vector<FLOAT_TYPE, N> center = position + static_cast<FLOAT_TYPE>(0.5) * edge_lengths;
+  Vector<FLOAT_TYPE, N> volume_center = volume.position + static_cast<FLOAT_TYPE>(0.5) * volume.edge_lengths;
+  volume.position = volume.position + (get_nearest_image(volume_center, center, world_extent) - volume_center);
+  return collides(volume);
+}
+
 template<class FLOAT_TYPE, size_t N>  
 FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_edge_length(size_t edge) const {
   return edge_lengths[edge];
@@ -54,8 +160,78 @@ void BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::set_position(Vector<FLOAT_TYPE,
   this->position = position;
 }
 
+template<class FLOAT_TYPE, size_t N>  
+Vector<FLOAT_TYPE,N> BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_lower_corner() const {
+  return position;
+}
+
+template<class FLOAT_TYPE, size_t N>  
+Vector<FLOAT_TYPE,N> BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_upper_corner() const {
+  return position + edge_lengths;
+}
+
+// the distance to the nearest point of the box, which is point clamped to the box
+template<class FLOAT_TYPE, size_t N>  
+FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_distance(Vector<FLOAT_TYPE,N> point) const {
+  Vector<FLOAT_TYPE,N> difference;
+  for (size_t axis = 0u; axis < N; axis++) {
+    difference[axis] = point[axis] - std::clamp(point[axis], position[axis], position[axis] + edge_lengths[axis]);
+  }
+  return difference.length();
+}
+
+template<class FLOAT_TYPE, size_t N>
+bool BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::overlaps(Vector<FLOAT_TYPE,N> lower, Vector<FLOAT_TYPE,N> upper) const {
+  bool overlap = true;
+  for (size_t axis = 0u; axis < N; axis++) {
+    overlap &= position[axis] <= upper[axis];
+    overlap &= position[axis] + edge_lengths[axis] >= lower[axis];
+  }
+  return overlap;
+}
+
+// slab method: the ray is inside the box between the entry into the last and the exit of the first slab
+template<class FLOAT_TYPE, size_t N>  
+FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::intersects(const Ray<FLOAT_TYPE, N> &ray) const {
+  FLOAT_TYPE t_entry = -std::numeric_limits<FLOAT_TYPE>::infinity();
+  FLOAT_TYPE t_exit = std::numeric_limits<FLOAT_TYPE>::infinity();
+  for (size_t axis = 0u; axis < N; axis++) {
+    if (ray.direction[axis] == 0) {
+      if (ray.origin[axis] < position[axis] || ray.origin[axis] > position[axis] + edge_lengths[axis]) {
+        return 0;
+      }
+      continue;
+    }
+    FLOAT_TYPE t1 = (position[axis] - ray.origin[axis]) / ray.direction[axis];
+    FLOAT_TYPE t2 = (position[axis] + edge_lengths[axis] - ray.origin[axis]) / ray.direction[axis];
+    t_entry = std::max(t_entry, std::min(t1, t2));
+    t_exit = std::min(t_exit, std::max(t1, t2));
+  }
+  if (t_entry > t_exit || t_exit <= 0) {
+    return 0;
+  }
+  return t_entry > 0 ? t_entry : t_exit; // the ray starts inside if t_entry <= 0
+}
+
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement) const {
+  if (collides(volume)) {
+    return 0;
+  }
+  BoundingVolumeHyperRectangle<FLOAT_TYPE, N> swept(volume.position - edge_lengths, volume.edge_lengths + edge_lengths);
+  FLOAT_TYPE t = swept.intersects( Ray<FLOAT_TYPE, N>{position, displacement} );
+  return t > 0 ? t : std::numeric_limits<FLOAT_TYPE>::infinity();
+}
+
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> displacement,
+                                                                         Vector<FLOAT_TYPE, N> world_extent) const {
+  Vector<FLOAT_TYPE, N> center = position + static_cast<FLOAT_TYPE>(0.5) * (edge_lengths + displacement);
+  Vector<FLOAT_TYPE, N> volume_center = volume.position + static_cast<FLOAT_TYPE>(0.5) * volume.edge_lengths;
+  volume.position = volume.position + (get_nearest_image(volume_center, center, world_extent) - volume_center);
+  return get_time_of_impact(volume, displacement);
+}
 
-template<class FLOAT_TYPE, size_t N, class BV> class Physics;
 
 template<class FLOAT_TYPE, size_t N, class BV>
 Body<FLOAT_TYPE, N, BV>::Body(
@@ -66,17 +242,21 @@ Body<FLOAT_TYPE, N, BV>::Body(
        FLOAT_TYPE angle,
        std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix)
   : bounding(bounding_volume), velocity(velocity), max_velocity(max_velocity),
-    min_velocity(min_velocity), angle(angle)
+    min_velocity(min_velocity), angle(angle), orientation(Matrix<FLOAT_TYPE, N, N + 1u>::rotation(angle))
     {
       this->fix = fix;
       delete_counter.set_time(0.0);
+      previous_position = get_position();
     }
  
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::move(FLOAT_TYPE seconds) {
+  previous_position = get_position();
   set_position( get_position() +  seconds * velocity);
   delete_counter.tick(seconds);
-  fix(this, seconds);
+  if (fix) {
+    fix(this, seconds);
+  }
 }
   
 // turns the Body in the x/y-Plane 
@@ -84,15 +264,22 @@ void Body<FLOAT_TYPE, N, BV>::move(FLOAT_TYPE seconds) {
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::turn(FLOAT_TYPE angle, FLOAT_TYPE seconds) {
   this->angle += seconds * angle;
+  orientation = Matrix<FLOAT_TYPE, N, N + 1u>::rotation(this->angle);
 }
 
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::set_velocity(Vector<FLOAT_TYPE, N> velocity) {
-  if (velocity.length() > max_velocity) {
-    velocity = (1.0f / velocity.length()) * max_velocity  * velocity;
+  if (static_body) {
+    return;
+  }
+  sleeping = false;
+  FLOAT_TYPE length = velocity.length(); // computed once, the square root dominates this method
+  if (length > max_velocity) {
+    velocity = (1.0f / length) * max_velocity  * velocity;
+    length = max_velocity;
   }
-  if (velocity.length() < min_velocity) {
-    velocity = (min_velocity / velocity.length()) * velocity;
+  if (length < min_velocity) {
+    velocity = (min_velocity / length) * velocity;
   }
   this->velocity = velocity;
 }
@@ -100,7 +287,7 @@ void Body<FLOAT_TYPE, N, BV>::set_velocity(Vector<FLOAT_TYPE, N> velocity) {
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE seconds) {
   if (N >= 2) {
-    Vector<FLOAT_TYPE, N> velocity = this->velocity + seconds * acceleration * Vector<FLOAT_TYPE,N>{ std::cos(angle), std::sin(angle) };   
+    Vector<FLOAT_TYPE, N> velocity = this->velocity + seconds * acceleration * orientation.column(0); // the rotated x-axis
     set_velocity(velocity);
   }
 }
@@ -108,6 +295,7 @@ void Body<FLOAT_TYPE, N, BV>::accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE sec
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::bounce(size_t coordinate) {
   velocity[coordinate] = -velocity[coordinate];
+  sleeping = false;
 }
 
 template<class FLOAT_TYPE, size_t N, class BV>
@@ -120,8 +308,51 @@ Vector<FLOAT_TYPE, N> Body<FLOAT_TYPE, N, BV>::get_position() const {
 }
     
 template<class FLOAT_TYPE, size_t N, class BV>
-void Body<FLOAT_TYPE, N, BV>::set_position(Vector<FLOAT_TYPE,N> position) {
+void Body<FLOAT_TYPE, N, BV>::set_position(Vector<FLOAT_TYPE,N> position, bool reset_interpolation) {
   bounding.set_position(position);
+  if (reset_interpolation) {
+    previous_position = position;
+  }
+  sleeping = false;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+bool Body<FLOAT_TYPE, N, BV>::is_sleeping() const {
+  return sleeping || static_body;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void Body<FLOAT_TYPE, N, BV>::set_static(bool static_body) {
+  this->static_body = static_body;
+  if (static_body) {
+    velocity = Vector<FLOAT_TYPE, N>();
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void Body<FLOAT_TYPE, N, BV>::set_collision_filter(uint32_t category, uint32_t mask) {
+  collision_category = category;
+  collision_mask = mask;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+uint32_t Body<FLOAT_TYPE, N, BV>::get_collision_category() const {
+  return collision_category;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+uint32_t Body<FLOAT_TYPE, N, BV>::get_collision_mask() const {
+  return collision_mask;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+bool Body<FLOAT_TYPE, N, BV>::can_collide(const Body<FLOAT_TYPE, N, BV> & body) const {
+  return (collision_category & body.collision_mask) != 0 && (body.collision_category & collision_mask) != 0;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+bool Body<FLOAT_TYPE, N, BV>::is_static() const {
+  return static_body;
 }
 
 
@@ -159,28 +390,192 @@ BV Body<FLOAT_TYPE, N, BV>::get_bounding_volume() const {
   return bounding;
 }
 
+template<class FLOAT_TYPE, size_t N, class BV>
+Vector<FLOAT_TYPE,N> Body<FLOAT_TYPE, N, BV>::get_interpolated_position(FLOAT_TYPE alpha, Vector<FLOAT_TYPE,N> world_extent) const {
+  Vector<FLOAT_TYPE,N> position = get_position();
+  Vector<FLOAT_TYPE,N> previous = get_nearest_image(previous_position, position, world_extent);
+  return get_wrapped_position<FLOAT_TYPE, N>(previous + alpha * (position - previous), world_extent);
+}
 
+template<class FLOAT_TYPE, size_t N, class BV>
+SlotHandle Body<FLOAT_TYPE, N, BV>::get_handle() const {
+  return handle;
+}
 
+template<class FLOAT_TYPE, size_t N, class BV>
+void Body<FLOAT_TYPE, N, BV>::save(Snapshot & snapshot) const {
+  snapshot.write(bounding);
+  snapshot.write(velocity);
+  snapshot.write(previous_position);
+  snapshot.write(max_velocity);
+  snapshot.write(min_velocity);
+  snapshot.write(angle);
+  snapshot.write(orientation);
+  snapshot.write(delete_counter);
+  snapshot.write(deletable);
+  snapshot.write(sleeping);
+  snapshot.write(static_body);
+  snapshot.write(collision_category);
+  snapshot.write(collision_mask);
+}
 
 template<class FLOAT_TYPE, size_t N, class BV>
-Physics<FLOAT_TYPE, N, BV>::Physics( std::function<bool(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> check_collision,
-                                 std::function<void(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> resolve_collision)
-  : check_collision(check_collision), resolve_collision(resolve_collision) { }
+void Body<FLOAT_TYPE, N, BV>::restore(Snapshot & snapshot) {
+  snapshot.read(bounding);
+  snapshot.read(velocity);
+  snapshot.read(previous_position);
+  snapshot.read(max_velocity);
+  snapshot.read(min_velocity);
+  snapshot.read(angle);
+  snapshot.read(orientation);
+  snapshot.read(delete_counter);
+  snapshot.read(deletable);
+  snapshot.read(sleeping);
+  snapshot.read(static_body);
+  snapshot.read(collision_category);
+  snapshot.read(collision_mask);
+}
+
+
+
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::Physics(CHECK check_collision, RESOLVE resolve_collision, FIX fix)
+  : check_collision(check_collision), resolve_collision(resolve_collision), fix(fix) { }
          
   
-template<class FLOAT_TYPE, size_t N, class BV>
-void Physics<FLOAT_TYPE, N, BV>::set_tick_time(FLOAT_TYPE tick_time) {
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::set_tick_time(FLOAT_TYPE tick_time) {
   this->tick_time = tick_time;
 }   
 
-template<class FLOAT_TYPE, size_t N, class BV>
-FLOAT_TYPE Physics<FLOAT_TYPE, N, BV>::get_tick_time() {
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+FLOAT_TYPE Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_tick_time() {
   return tick_time;
 }   
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::set_grid_cell_size(FLOAT_TYPE cell_size)
+    requires std::same_as<BROADPHASE, GridBroadphase<FLOAT_TYPE, N, BV>> {
+  broadphase.set_cell_size(cell_size);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+BROADPHASE & Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_broadphase() {
+  return broadphase;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::set_world_extent(Vector<FLOAT_TYPE, N> world_extent) {
+  this->world_extent = world_extent;
+  broadphase.set_world_extent(world_extent);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+Vector<FLOAT_TYPE, N> Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_world_extent() const {
+  return world_extent;
+}
   
-template<class FLOAT_TYPE, size_t N, class BV>
-void Physics<FLOAT_TYPE, N, BV>::add_body(Body<FLOAT_TYPE, N, BV> * body) {
-  if ( std::find( bodies.begin(), bodies.end(), body) == bodies.end() ) {
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::set_continuous_collision_detection(bool continuous_collision_detection) {
+  this->continuous_collision_detection = continuous_collision_detection;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+FLOAT_TYPE Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_time_of_impact() const {
+  return time_of_impact;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::set_thread_count(size_t thread_count) {
+  if constexpr (requires { broadphase.set_thread_pool(nullptr); }) {
+    broadphase.set_thread_pool(nullptr); // before the old pool is destroyed
+  }
+  thread_pool.reset();
+  if (thread_count > 1) {
+    thread_pool = std::make_unique<ThreadPool>(thread_count);
+    if constexpr (requires { broadphase.set_thread_pool(thread_pool.get()); }) {
+      broadphase.set_thread_pool(thread_pool.get());
+    }
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+Vector<FLOAT_TYPE, N> Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_displacement(const Body<FLOAT_TYPE, N, BV> * body) const {
+  Vector<FLOAT_TYPE, N> position = body->get_position();
+  return position - get_nearest_image(body->previous_position, position, world_extent);
+}
+
+// relative to bodies[j], bodies[i] moves by the difference of both displacements
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+FLOAT_TYPE Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_time_of_impact(size_t i, size_t j) const {
+  const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies = registry.get_values();
+  Vector<FLOAT_TYPE, N> displacement_i = get_displacement(bodies[i]);
+  Vector<FLOAT_TYPE, N> displacement_j = get_displacement(bodies[j]);
+  BV start_i = bodies[i]->bounding;
+  BV start_j = bodies[j]->bounding;
+  start_i.set_position( start_i.get_position() - displacement_i );
+  start_j.set_position( start_j.get_position() - displacement_j );
+  return start_i.get_time_of_impact(start_j, displacement_i - displacement_j, world_extent);
+}
+
+// two slow bodies can't pass through each other: their relative displacement is at most the sum of their half
+// extents. The broadphase knows the bodies at their positions after the tick, so the candidates of a fast body
+// are queried with its swept box enlarged by the largest displacement of any body along each axis
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::add_swept_pairs(std::vector<std::pair<size_t, size_t>> & pairs) {
+  const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies = registry.get_values();
+  fast_bodies.assign(bodies.size(), false);
+  bool any_fast = false;
+  Vector<FLOAT_TYPE, N> max_displacement;
+  for (size_t i = 0; i < bodies.size(); i++) {
+    Vector<FLOAT_TYPE, N> displacement = get_displacement(bodies[i]);
+    Vector<FLOAT_TYPE, N> extent = bodies[i]->bounding.get_upper_corner() - bodies[i]->bounding.get_lower_corner();
+    FLOAT_TYPE half_extent = extent[0];
+    for (size_t axis = 0u; axis < N; axis++) {
+      half_extent = std::min(half_extent, extent[axis]);
+      max_displacement[axis] = std::max(max_displacement[axis], std::abs(displacement[axis]));
+    }
+    half_extent *= static_cast<FLOAT_TYPE>(0.5);
+    fast_bodies[i] = displacement.square_of_length() > half_extent * half_extent;
+    any_fast = any_fast || fast_bodies[i];
+  }
+  if (!any_fast) {
+    return;
+  }
+  const size_t sorted_pairs = pairs.size();
+  for (size_t i = 0; i < bodies.size(); i++) {
+    if ( !fast_bodies[i] ) {
+      continue;
+    }
+    Vector<FLOAT_TYPE, N> displacement = get_displacement(bodies[i]);
+    Vector<FLOAT_TYPE, N> lower = bodies[i]->bounding.get_lower_corner();
+    Vector<FLOAT_TYPE, N> upper = bodies[i]->bounding.get_upper_corner();
+    for (size_t axis = 0u; axis < N; axis++) {
+      lower[axis] = std::min(lower[axis], lower[axis] - displacement[axis]) - max_displacement[axis];
+      upper[axis] = std::max(upper[axis], upper[axis] - displacement[axis]) + max_displacement[axis];
+    }
+    visit_candidates(lower, upper, [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+      size_t j = registry.get_index(body->handle);
+      if (j == i || (j < i && fast_bodies[j]) || !bodies[i]->can_collide(*body)) { // the pairs of two fast bodies are swept once
+        return true;
+      }
+      std::pair<size_t, size_t> pair = std::minmax(i, j);
+      if (get_time_of_impact(i, j) <= 1 && !std::binary_search(pairs.begin(), pairs.begin() + sorted_pairs, pair)) {
+        pairs.push_back(pair);
+      }
+      return true;
+    });
+  }
+  std::sort(pairs.begin() + sorted_pairs, pairs.end());
+  std::inplace_merge(pairs.begin(), pairs.begin() + sorted_pairs, pairs.end());
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::add_body(Body<FLOAT_TYPE, N, BV> * body) {
+  // the handle of body is only found if it is in this engine, a copied body has another address
+  Body<FLOAT_TYPE, N, BV> ** added_body = registry.find(body->handle);
+  if ( added_body == nullptr || *added_body != body ) {
     bodies_to_add.push_back(body);
   } else {
     std::cout << "body alread in physics" << std::endl;
@@ -188,57 +583,990 @@ void Physics<FLOAT_TYPE, N, BV>::add_body(Body<FLOAT_TYPE, N, BV> * body) {
 }
 
 
-template<class FLOAT_TYPE, size_t N, class BV>
-Body<FLOAT_TYPE, N, BV> * Physics<FLOAT_TYPE, N, BV>::get_body(size_t i) {
-  return bodies[i];
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+Body<FLOAT_TYPE, N, BV> * Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_body(size_t i) {
+  return registry.get_values()[i];
 }
 
-template<class FLOAT_TYPE, size_t N, class BV>
-const std::vector<Body<FLOAT_TYPE, N, BV> *> & Physics<FLOAT_TYPE, N, BV>::get_bodies() {
-  return bodies;
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+Body<FLOAT_TYPE, N, BV> * Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_body(SlotHandle handle) {
+  Body<FLOAT_TYPE, N, BV> ** body = registry.find(handle);
+  return body == nullptr ? nullptr : *body;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+const std::vector<Body<FLOAT_TYPE, N, BV> *> & Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_bodies() {
+  return registry.get_values();
 }  
 
-template<class FLOAT_TYPE, size_t N, class BV>
-bool Physics<FLOAT_TYPE, N, BV>::is_area_free_of_bodies(BV * area, std::function<bool(Body<FLOAT_TYPE, N, BV> *)> check_body) {
-  for (Body<FLOAT_TYPE, N, BV> * body : bodies) {
-    if ( check_body(body) && body->bounding.collides(*area) ) {
-      return false;
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class CHECK_BODY>
+bool Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::is_area_free_of_bodies(BV * area, CHECK_BODY check_body) {
+  bool free = true;
+  visit_candidates(area->get_lower_corner(), area->get_upper_corner(), [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+    free = !( check_body(body) && area->collides(body->bounding, world_extent) );
+    return free;
+  });
+  return free;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class VISITOR>
+size_t Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::visit_candidates(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit) {
+  size_t visited = 0;
+  bool searching = true;
+  if constexpr ( requires { broadphase.query_box(lower, upper, std::declval<bool (*)(size_t)>()); } ) {
+    if ( !searched_bodies.empty() ) {
+      // a new query number unmarks all bodies, the marks are cleared when the numbers wrap around
+      query_marks.resize(searched_bodies.size(), 0);
+      if (++query_number == 0) {
+        std::fill(query_marks.begin(), query_marks.end(), 0);
+        query_number = 1;
+      }
+      auto visit_once = [&](size_t index) -> bool {
+        if (searched_bodies[index] != nullptr && query_marks[index] != query_number) {
+          query_marks[index] = query_number;
+          visited++;
+          searching = visit(searched_bodies[index]);
+        }
+        return searching;
+      };
+      // queries the box and, along the repeating axes, its images shifted by -1 and +1 world extent,
+      // counting through the shifts like an odometer
+      std::array<int, N> shift;
+      for (size_t axis = 0u; axis < N; axis++) {
+        shift[axis] = world_extent[axis] > 0 ? -1 : 0;
+      }
+      while (searching) {
+        Vector<FLOAT_TYPE, N> offset;
+        for (size_t axis = 0u; axis < N; axis++) {
+          offset[axis] = shift[axis] * world_extent[axis];
+        }
+        broadphase.query_box(lower + offset, upper + offset, visit_once);
+        size_t axis = 0u;
+        for (; axis < N && (world_extent[axis] <= 0 || shift[axis] == 1); axis++) {
+          shift[axis] = world_extent[axis] > 0 ? -1 : 0;
+        }
+        if (axis == N) {
+          break;
+        }
+        shift[axis]++;
+      }
+      return visited;
+    }
+  }
+  for (Body<FLOAT_TYPE, N, BV> * body : registry.get_values()) {
+    visited++;
+    if ( !visit(body) ) {
+      break;
     }
   }
-  return true;
+  return visited;
 }
 
-template<class FLOAT_TYPE, size_t N, class BV>
-void Physics<FLOAT_TYPE, N, BV>::tick() {
-  Physics<FLOAT_TYPE, N, BV>::tick(tick_time);
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class FILTER>
+size_t Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::query_circle(Vector<FLOAT_TYPE, N> center, FLOAT_TYPE radius,
+                                                                                std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                                                                                FILTER filter) {
+  size_t count = 0;
+  if ( results.empty() ) {
+    return count;
+  }
+  Vector<FLOAT_TYPE, N> half_size;
+  for (size_t axis = 0u; axis < N; axis++) {
+    half_size[axis] = radius;
+  }
+  visit_candidates(center - half_size, center + half_size, [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+    Vector<FLOAT_TYPE, N> image = get_nearest_image(center, body->get_position(), world_extent);
+    if ( body->bounding.get_distance(image) <= radius && filter(body) ) {
+      results[count++] = body;
+    }
+    return count < results.size();
+  });
+  return count;
 }
 
-template<class FLOAT_TYPE, size_t N, class BV>
-void Physics<FLOAT_TYPE, N, BV>::tick(FLOAT_TYPE tick_time) {
+// the box is moved to its image nearest to each body
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class FILTER>
+size_t Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper,
+                                                                             std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                                                                             FILTER filter) {
+  size_t count = 0;
+  if ( results.empty() ) {
+    return count;
+  }
+  Vector<FLOAT_TYPE, N> center = static_cast<FLOAT_TYPE>(0.5) * (lower + upper);
+  visit_candidates(lower, upper, [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+    Vector<FLOAT_TYPE, N> offset = get_nearest_image(center, body->get_position(), world_extent) - center;
+    if ( body->bounding.overlaps(lower + offset, upper + offset) && filter(body) ) {
+      results[count++] = body;
+    }
+    return count < results.size();
+  });
+  return count;
+}
+
+// the candidates are the bodies in the bounding box of the ray's segment from t = 0 to max_t
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class FILTER>
+Body<FLOAT_TYPE, N, BV> * Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::ray_cast(const Ray<FLOAT_TYPE, N> & ray, FLOAT_TYPE max_t, FLOAT_TYPE & t,
+                                                                                               FILTER filter) {
+  Vector<FLOAT_TYPE, N> end = ray.origin + max_t * ray.direction;
+  Vector<FLOAT_TYPE, N> lower, upper;
+  for (size_t axis = 0u; axis < N; axis++) {
+    lower[axis] = std::min(ray.origin[axis], end[axis]);
+    upper[axis] = std::max(ray.origin[axis], end[axis]);
+  }
+  Body<FLOAT_TYPE, N, BV> * first = nullptr;
+  FLOAT_TYPE first_t = std::numeric_limits<FLOAT_TYPE>::infinity();
+  visit_candidates(lower, upper, [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+    FLOAT_TYPE body_t = body->bounding.intersects(ray);
+    if ( body_t > 0 && body_t <= max_t && body_t < first_t && filter(body) ) {
+      first = body;
+      first_t = body_t;
+    }
+    return true;
+  });
+  if (first != nullptr) {
+    t = first_t;
+  }
+  return first;
+}
+
+// searches boxes around point of doubling size: once the results are full and the farthest of them is
+// inside the box, no body outside can be nearer. The first box holds about results.size() bodies if the
+// bodies are spread evenly over a repeating world
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+template<class FILTER>
+size_t Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::query_nearest(Vector<FLOAT_TYPE, N> point,
+                                                                                 std::span<Body<FLOAT_TYPE, N, BV> *> results,
+                                                                                 FILTER filter) {
+  size_t count = 0;
+  if ( results.empty() ) {
+    return count;
+  }
+  auto get_distance = [&](Body<FLOAT_TYPE, N, BV> * body) -> FLOAT_TYPE {
+    return body->bounding.get_distance( get_nearest_image(point, body->get_position(), world_extent) );
+  };
+  // inserts body into the sorted results, the farthest one falls out if they are full
+  auto insert = [&](Body<FLOAT_TYPE, N, BV> * body) {
+    FLOAT_TYPE distance = get_distance(body);
+    if ( count == results.size() && distance >= get_distance(results[count - 1]) ) {
+      return;
+    }
+    size_t i = count < results.size() ? count++ : count - 1;
+    for (; i > 0 && get_distance(results[i - 1]) > distance; i--) {
+      results[i] = results[i - 1];
+    }
+    results[i] = body;
+  };
+
+  FLOAT_TYPE volume = 1.0;
+  for (size_t axis = 0u; axis < N; axis++) {
+    volume *= world_extent[axis];
+  }
+  FLOAT_TYPE half_size = 1.0;
+  if ( volume > 0 && !registry.get_values().empty() ) {
+    half_size = static_cast<FLOAT_TYPE>(0.5) * std::pow(volume * results.size() / registry.get_values().size(), static_cast<FLOAT_TYPE>(1.0) / N);
+  }
+  while (true) {
+    count = 0;
+    Vector<FLOAT_TYPE, N> half_sizes;
+    for (size_t axis = 0u; axis < N; axis++) {
+      half_sizes[axis] = half_size;
+    }
+    size_t visited = visit_candidates(point - half_sizes, point + half_sizes, [&](Body<FLOAT_TYPE, N, BV> * body) -> bool {
+      if (filter(body)) {
+        insert(body);
+      }
+      return true;
+    });
+    if ( visited == registry.get_values().size() || (count == results.size() && get_distance(results[count - 1]) <= half_size) ) {
+      return count;
+    }
+    half_size *= 2;
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::save(Snapshot & snapshot,
+                                                                       const std::function<size_t(const Body<FLOAT_TYPE, N, BV> *)> & get_id) const {
+  snapshot.write(tick_time);
+  registry.save(snapshot, get_id);
+  snapshot.write(bodies_to_add.size());
+  for (const Body<FLOAT_TYPE, N, BV> * body : bodies_to_add) {
+    snapshot.write( get_id(body) );
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::restore(Snapshot & snapshot,
+                                                                          const std::function<Body<FLOAT_TYPE, N, BV> *(size_t)> & get_body) {
+  snapshot.read(tick_time);
+  registry.restore(snapshot, get_body);
+  searched_bodies.clear(); // the broadphase knows the bodies of the next tick again
+  const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies = registry.get_values();
+  for (size_t i = 0; i < bodies.size(); i++) {
+    bodies[i]->handle = registry.get_handle(i);
+  }
+  size_t size;
+  snapshot.read(size);
+  bodies_to_add.clear();
+  for (size_t i = 0; i < size; i++) {
+    size_t id;
+    snapshot.read(id);
+    bodies_to_add.push_back( get_body(id) );
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::tick() {
+  Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::tick(tick_time);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+void Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::tick(FLOAT_TYPE tick_time) {
+  using Clock = std::chrono::steady_clock;
+  auto seconds_since = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+  Clock::time_point phase_start = Clock::now();
   set_tick_time(tick_time);
   std::vector< std::pair<Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *> > bodies_to_resolve;
-  bodies.insert(bodies.end(), bodies_to_add.begin(), bodies_to_add.end() ); 
+  const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies = registry.get_values();
+  for (Body<FLOAT_TYPE, N, BV> * body : bodies_to_add) {
+    body->handle = registry.insert(body);
+  }
   bodies_to_add.clear();    
 
-  erase_if(bodies, [](Body<FLOAT_TYPE, N, BV> * body) { return body->is_marked_for_deletion();}); 
+  registry.erase_if([](Body<FLOAT_TYPE, N, BV> * body) { return body->is_marked_for_deletion();}); 
+  statistics.add_remove_time = seconds_since(phase_start);
+  statistics.body_count = bodies.size();
+
+  phase_start = Clock::now();
+  const bool repeating = is_repeating(world_extent);
+  auto move = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      if (bodies[i]->is_sleeping()) {
+        bodies[i]->delete_counter.tick(tick_time);
+        continue;
+      }
+      bodies[i]->move(tick_time);
+      fix(bodies[i], tick_time);
+      if (repeating) {
+        bodies[i]->set_position( get_wrapped_position(bodies[i]->get_position(), world_extent) );
+      }
+    }
+  };
+  if (thread_pool) {
+    const size_t part_count = thread_pool->get_thread_count();
+    thread_pool->run(part_count, [&](size_t part) {
+      auto [begin, end] = ThreadPool::get_range(part, part_count, bodies.size());
+      move(begin, end);
+    });
+  } else {
+    move(0, bodies.size());
+  }
+  statistics.integrate_time = seconds_since(phase_start);
 
-  for (auto body : bodies) {
-    body->move(tick_time);
+  phase_start = Clock::now();
+  std::vector<std::pair<size_t, size_t>> colliding_pairs;
+  broadphase.find_colliding_pairs(bodies, colliding_pairs);
+  searched_bodies.assign(bodies.begin(), bodies.end());
+  if (continuous_collision_detection) {
+    add_swept_pairs(colliding_pairs);
   }
-   
-  for (auto iterator1 = bodies.begin(); iterator1 != bodies.end(); iterator1++ ) {
-    for (auto iterator2 = iterator1 + 1; iterator2 != bodies.end(); iterator2++) {
-      if ( (*iterator1)->bounding.collides( (*iterator2)->bounding)   ) {
-        if (check_collision(*iterator1, *iterator2) ) {
-          bodies_to_resolve.push_back( std::pair<Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *>(*iterator1, *iterator2) );
+  statistics.pair_search_time = seconds_since(phase_start);
+  statistics.pair_count = colliding_pairs.size();
+
+  phase_start = Clock::now();
+  std::vector<FLOAT_TYPE> times_of_impact;
+  for (auto [i, j] : colliding_pairs) {
+    if (check_collision(bodies[i], bodies[j]) ) {
+      bodies_to_resolve.push_back( std::pair<Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *>(bodies[i], bodies[j]) );
+      times_of_impact.push_back( continuous_collision_detection ? std::min<FLOAT_TYPE>(get_time_of_impact(i, j), 1.0) : 1.0 );
+    }
+  }
+
+  for (size_t k = 0; k < bodies_to_resolve.size(); k++) {
+    time_of_impact = times_of_impact[k];
+    resolve_collision(bodies_to_resolve[k].first, bodies_to_resolve[k].second);
+  }    
+  time_of_impact = 1.0;
+
+  // the bodies at rest fall asleep, the bodies of the resolved collisions stay awake for the next tick
+  for (Body<FLOAT_TYPE, N, BV> * body : bodies) {
+    if ( !body->fix && body->velocity.square_of_length() == 0 ) {
+      body->sleeping = true;
+    }
+    if ( body->is_sleeping() ) {
+      body->previous_position = body->get_position();
+    }
+  }
+  for (auto [body1, body2] : bodies_to_resolve) {
+    body1->sleeping = false;
+    body2->sleeping = false;
+  }
+  statistics.resolve_time = seconds_since(phase_start);
+  statistics.resolved_count = bodies_to_resolve.size();
+
+  phase_start = Clock::now();
+  // the bodies removed now may be destroyed before the next tick, the spatial queries skip them
+  for (Body<FLOAT_TYPE, N, BV> *& body : searched_bodies) {
+    if ( body->is_marked_for_deletion() ) {
+      body = nullptr;
+    }
+  }
+  registry.erase_if([](Body<FLOAT_TYPE, N, BV> * body) { return body->is_marked_for_deletion();}); 
+  statistics.add_remove_time += seconds_since(phase_start);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV, class BROADPHASE, class CHECK, class RESOLVE, class FIX>
+const TickStatistics & Physics<FLOAT_TYPE, N, BV, BROADPHASE, CHECK, RESOLVE, FIX>::get_tick_statistics() const {
+  return statistics;
+}
+
+
+// -------------------------------------------------------------------
+// broadphases
+
+// runs find_pairs(begin, end, pairs) for [0, size) at once without thread_pool, else for parts of
+// [0, size) on the threads of thread_pool. Each part appends to its own buffer of part_pairs, the
+// buffers are appended to pairs in the order of the parts, so the pairs are the same in both cases.
+// There are more parts than threads, as the work of equal parts differs
+template<class FIND_PAIRS>
+void find_pairs_in_parts(ThreadPool * thread_pool, std::vector<std::vector<std::pair<size_t, size_t>>> & part_pairs,
+                         size_t size, std::vector<std::pair<size_t, size_t>> & pairs, FIND_PAIRS find_pairs) {
+  if (thread_pool == nullptr) {
+    find_pairs(0, size, pairs);
+    return;
+  }
+  const size_t part_count = 4 * thread_pool->get_thread_count();
+  part_pairs.resize(part_count);
+  thread_pool->run(part_count, [&](size_t part) {
+    part_pairs[part].clear();
+    auto [begin, end] = ThreadPool::get_range(part, part_count, size);
+    find_pairs(begin, end, part_pairs[part]);
+  });
+  for (const std::vector<std::pair<size_t, size_t>> & found_pairs : part_pairs) {
+    pairs.insert(pairs.end(), found_pairs.begin(), found_pairs.end());
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::set_cell_size(FLOAT_TYPE cell_size) {
+  this->cell_size = cell_size;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::set_world_extent(Vector<FLOAT_TYPE, N> world_extent) {
+  this->world_extent = world_extent;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::set_thread_pool(ThreadPool * thread_pool) {
+  this->thread_pool = thread_pool;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies,
+                                                             std::vector<std::pair<size_t, size_t>> & pairs) {
+  if (cell_size > 0) {
+    find_colliding_pairs_in_grid(bodies, pairs);
+    return;
+  }
+  find_pairs_in_parts(thread_pool, part_pairs, bodies.size(), pairs,
+                      [&](size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> & found_pairs) {
+                        test_all_pairs(bodies, begin, end, found_pairs);
+                      });
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::test_all_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, size_t begin, size_t end,
+                                                       std::vector<std::pair<size_t, size_t>> & pairs) const {
+  for (size_t i = begin; i < end; i++) {
+    const bool sleeping = bodies[i]->is_sleeping();
+    for (size_t j = i + 1; j < bodies.size(); j++) {
+      if ( (sleeping && bodies[j]->is_sleeping()) || !bodies[i]->can_collide(*bodies[j]) ) {
+        continue;
+      }
+      if ( bodies[i]->get_bounding_volume().collides( bodies[j]->get_bounding_volume(), world_extent ) ) {
+        pairs.push_back( {i, j} );
+      }
+    }
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+std::array<long, N> GridBroadphase<FLOAT_TYPE, N, BV>::get_cell(Vector<FLOAT_TYPE, N> point) const {
+  std::array<long, N> cell;
+  for (size_t axis = 0u; axis < N; axis++) {
+    cell[axis] = static_cast<long>(std::floor(point[axis] / cell_sizes[axis]));
+  }
+  return cell;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::find_colliding_pairs_in_grid(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies,
+                                                                     std::vector<std::pair<size_t, size_t>> & pairs) {
+  const bool repeating = is_repeating(world_extent);
+  for (size_t axis = 0u; axis < N; axis++) {
+    cell_counts[axis] = 0;
+    cell_sizes[axis] = cell_size;
+    if (world_extent[axis] > 0) {
+      cell_counts[axis] = std::max(1L, static_cast<long>(world_extent[axis] / cell_size));
+      cell_sizes[axis] = world_extent[axis] / cell_counts[axis];
+    }
+  }
+  grid_entries.clear();
+  lower_cells.resize(bodies.size());
+  for (size_t i = 0; i < bodies.size(); i++) {
+    BV bounding = bodies[i]->get_bounding_volume();
+    std::array<long, N> lower = get_cell(bounding.get_lower_corner());
+    std::array<long, N> upper = get_cell(bounding.get_upper_corner());
+    for (size_t axis = 0u; axis < N; axis++) {
+      // a volume overlapping all cells of a repeating axis must not enter one cell twice
+      if (cell_counts[axis] > 0 && upper[axis] - lower[axis] >= cell_counts[axis]) {
+        lower[axis] = 0;
+        upper[axis] = cell_counts[axis] - 1;
+      }
+    }
+    lower_cells[i] = lower;
+    // enumerates all cells from lower to upper like an odometer
+    std::array<long, N> cell = lower;
+    while (true) {
+      std::array<long, N> wrapped_cell = cell;
+      for (size_t axis = 0u; axis < N; axis++) {
+        if (cell_counts[axis] > 0) {
+          wrapped_cell[axis] = (cell[axis] % cell_counts[axis] + cell_counts[axis]) % cell_counts[axis];
         }
       }
+      grid_entries.push_back( {wrapped_cell, i} );
+      size_t axis = 0u;
+      while (axis < N && cell[axis] == upper[axis]) {
+        cell[axis] = lower[axis];
+        axis++;
+      }
+      if (axis == N) {
+        break;
+      }
+      cell[axis]++;
+    }
+  }
+  // groups the entries by cell, in each cell the bodies are ordered by their index
+  std::sort(grid_entries.begin(), grid_entries.end());
+  cell_begins.clear();
+  for (size_t entry = 0; entry < grid_entries.size(); entry++) {
+    if (entry == 0 || grid_entries[entry].first != grid_entries[entry - 1].first) {
+      cell_begins.push_back(entry);
     }
   }
+  const size_t cell_count = cell_begins.size();
+  cell_begins.push_back(grid_entries.size());
 
-  for (auto pair : bodies_to_resolve) {
-    resolve_collision(pair.first, pair.second);
-  }    
-  erase_if(bodies, [](Body<FLOAT_TYPE, N, BV> * body) { return body->is_marked_for_deletion();}); 
+  find_pairs_in_parts(thread_pool, part_pairs, cell_count, pairs,
+                      [&](size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> & found_pairs) {
+                        test_cells(bodies, begin, end, found_pairs);
+                      });
+  // the order of the cells is not the order of the bodies
+  std::sort(pairs.begin(), pairs.end());
+  if (repeating) {
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void GridBroadphase<FLOAT_TYPE, N, BV>::test_cells(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies, size_t begin_cell, size_t end_cell,
+                                                   std::vector<std::pair<size_t, size_t>> & pairs) const {
+  const bool repeating = is_repeating(world_extent);
+  for (size_t c = begin_cell; c < end_cell; c++) {
+    const size_t begin = cell_begins[c];
+    const size_t end = cell_begins[c + 1];
+    const std::array<long, N> & cell = grid_entries[begin].first;
+    for (size_t first = begin; first < end; first++) {
+      for (size_t second = first + 1; second < end; second++) {
+        size_t i = grid_entries[first].second;
+        size_t j = grid_entries[second].second;
+        // bodies sharing several cells are only tested in the first of them, i.e. the cell of the
+        // upper one of both lower corners. In a repeating world this cell is not defined for
+        // cells wrapping around, so the duplicates are removed at the end
+        bool first_shared_cell = true;
+        for (size_t axis = 0u; axis < N && !repeating; axis++) {
+          first_shared_cell &= std::max(lower_cells[i][axis], lower_cells[j][axis]) == cell[axis];
+        }
+        if ( (bodies[i]->is_sleeping() && bodies[j]->is_sleeping()) || !bodies[i]->can_collide(*bodies[j]) ) {
+          continue;
+        }
+        if ( first_shared_cell && bodies[i]->get_bounding_volume().collides( bodies[j]->get_bounding_volume(), world_extent ) ) {
+          pairs.push_back( {i, j} );
+        }
+      }
+    }
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void SweepAndPruneBroadphase<FLOAT_TYPE, N, BV>::set_world_extent(Vector<FLOAT_TYPE, N> world_extent) {
+  this->world_extent = world_extent;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void SweepAndPruneBroadphase<FLOAT_TYPE, N, BV>::set_thread_pool(ThreadPool * thread_pool) {
+  this->thread_pool = thread_pool;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void SweepAndPruneBroadphase<FLOAT_TYPE, N, BV>::find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies,
+                                                                      std::vector<std::pair<size_t, size_t>> & pairs) {
+  for (size_t i = 0; i < bodies.size(); i++) {
+    size_t slot = bodies[i]->get_handle().slot;
+    if (slot >= slot_indices.size()) {
+      slot_indices.resize(slot + 1, 0);
+    }
+    slot_indices[slot] = i;
+  }
+  // keeps the intervals of the bodies of the last tick in their order and appends the new bodies. The
+  // slot of a removed body may hold a new body, whose handle has another generation
+  has_interval.assign(bodies.size(), false);
+  erase_if(intervals, [&](Interval & interval) {
+    size_t slot = interval.handle.slot;
+    if ( slot >= slot_indices.size() || slot_indices[slot] >= bodies.size()
+         || bodies[slot_indices[slot]]->get_handle() != interval.handle ) {
+      return true;
+    }
+    interval.index = slot_indices[slot];
+    interval.body = bodies[interval.index];
+    has_interval[interval.index] = true;
+    return false;
+  });
+  for (size_t i = 0; i < bodies.size(); i++) {
+    if ( !has_interval[i] ) {
+      intervals.push_back( {bodies[i], bodies[i]->get_handle(), i, 0.0, 0.0} );
+    }
+  }
+
+  max_interval_length = 0.0;
+  for (Interval & interval : intervals) {
+    BV bounding = interval.body->get_bounding_volume();
+    interval.lower = bounding.get_lower_corner()[0];
+    interval.upper = bounding.get_upper_corner()[0];
+    max_interval_length = std::max(max_interval_length, interval.upper - interval.lower);
+  }
+  // the intervals are nearly sorted if the bodies moved only a bit since the last tick
+  for (size_t i = 1; i < intervals.size(); i++) {
+    Interval interval = intervals[i];
+    size_t j = i;
+    for (; j > 0 && intervals[j - 1].lower > interval.lower; j--) {
+      intervals[j] = intervals[j - 1];
+    }
+    intervals[j] = interval;
+  }
+
+  find_pairs_in_parts(thread_pool, part_pairs, intervals.size(), pairs,
+                      [&](size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> & found_pairs) {
+                        sweep(begin, end, found_pairs);
+                      });
+  // the order of the sweep is not the order of the bodies
+  std::sort(pairs.begin(), pairs.end());
+  if (world_extent[0] > 0) { // the pairs overlapping at both ends were found twice
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void SweepAndPruneBroadphase<FLOAT_TYPE, N, BV>::sweep(size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> & pairs) const {
+  const FLOAT_TYPE extent = world_extent[0];
+  for (size_t i = begin; i < end; i++) {
+    BV bounding = intervals[i].body->get_bounding_volume();
+    const bool sleeping = intervals[i].body->is_sleeping();
+    for (size_t j = i + 1; j < intervals.size() && intervals[j].lower <= intervals[i].upper; j++) {
+      if ( (sleeping && intervals[j].body->is_sleeping()) || !intervals[i].body->can_collide(*intervals[j].body) ) {
+        continue;
+      }
+      if ( bounding.collides( intervals[j].body->get_bounding_volume(), world_extent ) ) {
+        pairs.push_back( std::minmax(intervals[i].index, intervals[j].index) );
+      }
+    }
+    // the intervals at the beginning continue after the end of the repeating x-axis
+    for (size_t j = 0; extent > 0 && j < i && intervals[j].lower + extent <= intervals[i].upper; j++) {
+      if ( (sleeping && intervals[j].body->is_sleeping()) || !intervals[i].body->can_collide(*intervals[j].body) ) {
+        continue;
+      }
+      if ( bounding.collides( intervals[j].body->get_bounding_volume(), world_extent ) ) {
+        pairs.push_back( std::minmax(intervals[i].index, intervals[j].index) );
+      }
+    }
+  }
+}
+
+// no interval starting before lower[0] - max_interval_length reaches the box
+template<class FLOAT_TYPE, size_t N, class BV>
+template<class VISITOR>
+void SweepAndPruneBroadphase<FLOAT_TYPE, N, BV>::query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit) const {
+  auto interval = std::lower_bound(intervals.begin(), intervals.end(), lower[0] - max_interval_length,
+                                   [](const Interval & interval, FLOAT_TYPE value) { return interval.lower < value; });
+  for (; interval != intervals.end() && interval->lower <= upper[0]; interval++) {
+    if ( interval->upper >= lower[0] && !visit(interval->index) ) {
+      return;
+    }
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::set_margin(FLOAT_TYPE margin) {
+  this->margin = margin;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::set_world_extent(Vector<FLOAT_TYPE, N> world_extent) {
+  this->world_extent = world_extent;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+size_t DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::get_height() const {
+  return root == NONE ? 0 : nodes[root].height;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+size_t DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::allocate_node() {
+  if (free_nodes == NONE) {
+    nodes.push_back( Node{} );
+    return nodes.size() - 1;
+  }
+  size_t node = free_nodes;
+  free_nodes = nodes[node].parent;
+  nodes[node] = Node{};
+  return node;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::free_node(size_t node) {
+  nodes[node].parent = free_nodes;
+  nodes[node].body = nullptr;
+  free_nodes = node;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+FLOAT_TYPE DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::get_cost(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper) {
+  FLOAT_TYPE cost = 0.0;
+  for (size_t axis = 0u; axis < N; axis++) {
+    cost += upper[axis] - lower[axis];
+  }
+  return cost;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+Vector<FLOAT_TYPE, N> DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::get_minimum(Vector<FLOAT_TYPE, N> a, Vector<FLOAT_TYPE, N> b) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    a[axis] = std::min(a[axis], b[axis]);
+  }
+  return a;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+Vector<FLOAT_TYPE, N> DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::get_maximum(Vector<FLOAT_TYPE, N> a, Vector<FLOAT_TYPE, N> b) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    a[axis] = std::max(a[axis], b[axis]);
+  }
+  return a;
 }
 
+template<class FLOAT_TYPE, size_t N, class BV>
+bool DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::overlap(Vector<FLOAT_TYPE, N> lower1, Vector<FLOAT_TYPE, N> upper1,
+                                                       Vector<FLOAT_TYPE, N> lower2, Vector<FLOAT_TYPE, N> upper2) {
+  bool overlap = true;
+  for (size_t axis = 0u; axis < N; axis++) {
+    overlap &= lower1[axis] <= upper2[axis] && lower2[axis] <= upper1[axis];
+  }
+  return overlap;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+bool DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::contains(Vector<FLOAT_TYPE, N> lower1, Vector<FLOAT_TYPE, N> upper1,
+                                                        Vector<FLOAT_TYPE, N> lower2, Vector<FLOAT_TYPE, N> upper2) {
+  bool contains = true;
+  for (size_t axis = 0u; axis < N; axis++) {
+    contains &= lower1[axis] <= lower2[axis] && upper2[axis] <= upper1[axis];
+  }
+  return contains;
+}
+
+// descends from the root to the sibling, for which the costs of the new inner node and the enlarged
+// ancestors are the lowest, and replaces the sibling by a new inner node with the sibling and leaf
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::insert_leaf(size_t leaf) {
+  if (root == NONE) {
+    root = leaf;
+    nodes[leaf].parent = NONE;
+    return;
+  }
+  const Vector<FLOAT_TYPE, N> lower = nodes[leaf].lower, upper = nodes[leaf].upper;
+  size_t sibling = root;
+  while ( !nodes[sibling].is_leaf() ) {
+    const Node & node = nodes[sibling];
+    FLOAT_TYPE combined_cost = get_cost(get_minimum(node.lower, lower), get_maximum(node.upper, upper));
+    // the cost of a new parent of this node and leaf, and the enlargement of this node if leaf descends further
+    FLOAT_TYPE cost = 2 * combined_cost;
+    FLOAT_TYPE inheritance_cost = 2 * (combined_cost - get_cost(node.lower, node.upper));
+    FLOAT_TYPE child_costs[2];
+    size_t children[2] = {node.left, node.right};
+    for (size_t i = 0; i < 2; i++) {
+      const Node & child = nodes[children[i]];
+      FLOAT_TYPE enlarged_cost = get_cost(get_minimum(child.lower, lower), get_maximum(child.upper, upper));
+      child_costs[i] = (child.is_leaf() ? enlarged_cost : enlarged_cost - get_cost(child.lower, child.upper)) + inheritance_cost;
+    }
+    if (cost < child_costs[0] && cost < child_costs[1]) {
+      break;
+    }
+    sibling = child_costs[0] < child_costs[1] ? children[0] : children[1];
+  }
+
+  size_t old_parent = nodes[sibling].parent;
+  size_t new_parent = allocate_node();
+  nodes[new_parent].parent = old_parent;
+  nodes[new_parent].left = sibling;
+  nodes[new_parent].right = leaf;
+  nodes[sibling].parent = new_parent;
+  nodes[leaf].parent = new_parent;
+  if (old_parent == NONE) {
+    root = new_parent;
+  } else if (nodes[old_parent].left == sibling) {
+    nodes[old_parent].left = new_parent;
+  } else {
+    nodes[old_parent].right = new_parent;
+  }
+  refit(new_parent);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::remove_leaf(size_t leaf) {
+  if (leaf == root) {
+    root = NONE;
+    return;
+  }
+  size_t parent = nodes[leaf].parent;
+  size_t grand_parent = nodes[parent].parent;
+  size_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+  nodes[sibling].parent = grand_parent;
+  free_node(parent);
+  if (grand_parent == NONE) {
+    root = sibling;
+    return;
+  }
+  if (nodes[grand_parent].left == parent) {
+    nodes[grand_parent].left = sibling;
+  } else {
+    nodes[grand_parent].right = sibling;
+  }
+  refit(grand_parent);
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::refit(size_t node) {
+  while (node != NONE) {
+    node = balance(node);
+    Node & inner = nodes[node];
+    const Node & left = nodes[inner.left];
+    const Node & right = nodes[inner.right];
+    inner.lower = get_minimum(left.lower, right.lower);
+    inner.upper = get_maximum(left.upper, right.upper);
+    inner.height = 1 + std::max(left.height, right.height);
+    node = inner.parent;
+  }
+}
+
+/*
+ if the right child is too high, its higher child replaces it and it replaces node (and vice versa):
+
+         node                  right
+        /    \                /     \
+     left    right    ->    node    higher
+            /     \        /    \
+       higher    lower   left  lower
+*/
+template<class FLOAT_TYPE, size_t N, class BV>
+size_t DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::balance(size_t node) {
+  if (nodes[node].is_leaf() || nodes[node].height < 2) {
+    return node;
+  }
+  size_t left = nodes[node].left;
+  size_t right = nodes[node].right;
+  long difference = static_cast<long>(nodes[right].height) - static_cast<long>(nodes[left].height);
+  if (difference >= -1 && difference <= 1) {
+    return node;
+  }
+  size_t up = difference > 1 ? right : left; // the child rotated up
+  size_t other = difference > 1 ? left : right;
+  size_t higher = nodes[nodes[up].left].height > nodes[nodes[up].right].height ? nodes[up].left : nodes[up].right;
+  size_t lower = higher == nodes[up].left ? nodes[up].right : nodes[up].left;
+
+  // up takes the place of node
+  nodes[up].parent = nodes[node].parent;
+  if (nodes[up].parent == NONE) {
+    root = up;
+  } else if (nodes[nodes[up].parent].left == node) {
+    nodes[nodes[up].parent].left = up;
+  } else {
+    nodes[nodes[up].parent].right = up;
+  }
+  // node gets the children other and lower, up the children node and higher
+  nodes[node].parent = up;
+  nodes[node].left = other;
+  nodes[node].right = lower;
+  nodes[lower].parent = node;
+  nodes[up].left = node;
+  nodes[up].right = higher;
+
+  nodes[node].lower = get_minimum(nodes[other].lower, nodes[lower].lower);
+  nodes[node].upper = get_maximum(nodes[other].upper, nodes[lower].upper);
+  nodes[node].height = 1 + std::max(nodes[other].height, nodes[lower].height);
+  nodes[up].lower = get_minimum(nodes[node].lower, nodes[higher].lower);
+  nodes[up].upper = get_maximum(nodes[node].upper, nodes[higher].upper);
+  nodes[up].height = 1 + std::max(nodes[node].height, nodes[higher].height);
+  return up;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+template<class VISITOR>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::query(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper,
+                                                     std::vector<size_t> & stack, VISITOR visit) const {
+  if (root == NONE) {
+    return;
+  }
+  stack.assign(1, root);
+  while ( !stack.empty() ) {
+    const Node & node = nodes[stack.back()];
+    stack.pop_back();
+    if ( !overlap(node.lower, node.upper, lower, upper) ) {
+      continue;
+    }
+    if (node.is_leaf()) {
+      if ( !visit(node) ) {
+        return;
+      }
+    } else {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+template<class VISITOR>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::query_box(Vector<FLOAT_TYPE, N> lower, Vector<FLOAT_TYPE, N> upper, VISITOR visit) const {
+  query(lower, upper, query_stack, [&](const Node & leaf) -> bool {
+    return visit(leaf.index);
+  });
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+void DynamicTreeBroadphase<FLOAT_TYPE, N, BV>::find_colliding_pairs(const std::vector<Body<FLOAT_TYPE, N, BV> *> & bodies,
+                                                                    std::vector<std::pair<size_t, size_t>> & pairs) {
+  // removes the leaves of the removed bodies. The slot of a removed body may hold a new body, whose
+  // handle has another generation
+  kept.assign(nodes.size(), false);
+  for (Body<FLOAT_TYPE, N, BV> * body : bodies) {
+    SlotHandle handle = body->get_handle();
+    if ( handle.slot < slot_leaves.size() && slot_leaves[handle.slot] != NONE && nodes[slot_leaves[handle.slot]].handle == handle ) {
+      kept[slot_leaves[handle.slot]] = true;
+    }
+  }
+  moved.assign(nodes.size(), false);
+  for (size_t & leaf : slot_leaves) {
+    if (leaf != NONE && !kept[leaf]) {
+      remove_leaf(leaf);
+      free_node(leaf);
+      moved[leaf] = true;
+      leaf = NONE;
+    }
+  }
+  // inserts the new bodies and the bodies which left their fat box
+  Vector<FLOAT_TYPE, N> enlargement;
+  for (size_t axis = 0u; axis < N; axis++) {
+    enlargement[axis] = margin;
+  }
+  for (size_t i = 0; i < bodies.size(); i++) {
+    BV bounding = bodies[i]->get_bounding_volume();
+    Vector<FLOAT_TYPE, N> lower = bounding.get_lower_corner();
+    Vector<FLOAT_TYPE, N> upper = bounding.get_upper_corner();
+    SlotHandle handle = bodies[i]->get_handle();
+    if (handle.slot >= slot_leaves.size()) {
+      slot_leaves.resize(handle.slot + 1, NONE);
+    }
+    size_t & leaf_node = slot_leaves[handle.slot];
+    bool inserted = leaf_node == NONE;
+    if (inserted) {
+      leaf_node = allocate_node();
+      nodes[leaf_node].handle = handle;
+    } else if ( !contains(nodes[leaf_node].lower, nodes[leaf_node].upper, lower, upper) ) {
+      remove_leaf(leaf_node);
+      inserted = true;
+    }
+    Node & leaf = nodes[leaf_node];
+    leaf.body = bodies[i];
+    leaf.index = i;
+    if (inserted) {
+      leaf.lower = lower - enlargement;
+      leaf.upper = upper + enlargement;
+      insert_leaf(leaf_node);
+      moved.resize(nodes.size(), false);
+      moved[leaf_node] = true;
+    }
+  }
+
+  // replaces the leaf pairs of the moved leaves by the pairs found with their new boxes,
+  // a pair of two moved leaves is added by the lower one
+  erase_if(leaf_pairs, [&](std::pair<size_t, size_t> pair) { return moved[pair.first] || moved[pair.second]; });
+  std::vector<size_t> stack;
+  for (size_t leaf : slot_leaves) {
+    if ( leaf == NONE || !moved[leaf] ) {
+      continue;
+    }
+    found_leaves.clear();
+    // queries the box and, along the repeating axes, its images shifted by -world_extent and
+    // +world_extent, enumerated like an odometer. The images beyond the boxes of all leaves stop at the root
+    std::array<int, N> shift; // -1, 0 or 1 times the world_extent of the axis
+    for (size_t axis = 0u; axis < N; axis++) {
+      shift[axis] = world_extent[axis] > 0 ? -1 : 0;
+    }
+    while (true) {
+      Vector<FLOAT_TYPE, N> offset;
+      for (size_t axis = 0u; axis < N; axis++) {
+        offset[axis] = shift[axis] * world_extent[axis];
+      }
+      query(nodes[leaf].lower + offset, nodes[leaf].upper + offset, stack, [&](const Node & other) -> bool {
+        found_leaves.push_back(&other - nodes.data());
+        return true;
+      });
+      size_t axis = 0u;
+      while (axis < N && (shift[axis] == 1 || world_extent[axis] <= 0)) {
+        shift[axis] = world_extent[axis] > 0 ? -1 : 0;
+        axis++;
+      }
+      if (axis == N) {
+        break;
+      }
+      shift[axis]++;
+    }
+    if ( is_repeating(world_extent) ) { // a leaf may overlap several images of another one
+      std::sort(found_leaves.begin(), found_leaves.end());
+      found_leaves.erase(std::unique(found_leaves.begin(), found_leaves.end()), found_leaves.end());
+    }
+    for (size_t other_leaf : found_leaves) {
+      if ( other_leaf != leaf && (!moved[other_leaf] || leaf < other_leaf) ) {
+        leaf_pairs.push_back( std::minmax(leaf, other_leaf) );
+      }
+    }
+  }
+
+  for (auto [a, b] : leaf_pairs) {
+    if ( (nodes[a].body->is_sleeping() && nodes[b].body->is_sleeping()) || !nodes[a].body->can_collide(*nodes[b].body) ) {
+      continue;
+    }
+    if ( nodes[a].body->get_bounding_volume().collides( nodes[b].body->get_bounding_volume(), world_extent ) ) {
+      pairs.push_back( std::minmax(nodes[a].index, nodes[b].index) );
+    }
+  }
+  // the order of the tree is not the order of the bodies
+  std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,211 @@
+#include "dense_physics.h"
+#include "physics.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// stress benchmark of Physics::tick with many bodies, to compare the broadphases and storage layouts:
+//
+//   physics_bench [bodies=1000,10000,100000] [broadphase=grid,sweep,tree,dense] [density=0.002] [radius=4]
+//                 [velocity=uniform] [speed=50] [churn=0.01] [ticks=100] [threads=1] [seed=1]
+//
+// The bodies are spread uniformly over a square repeating world, whose size follows from the number
+// of bodies and the density (bodies per square unit). Their radii are uniform in [radius / 2, 3 radius / 2],
+// their velocities are uniform in [-speed, speed] or normal with the standard deviation speed along
+// each axis (velocity=uniform or normal), or 0 (velocity=zero, the bodies fall asleep). In each tick
+// churn times the bodies are removed and as many new ones added. The broadphases are the grid with
+// a cell size of 4 radius (grid), testing all pairs (allpairs, slow for many bodies), sweep and prune
+// (sweep) and the dynamic tree (tree) of Physics with its Body objects, and the sweep of DensePhysics
+// over its arrays of components (dense, single threaded). After a first tick adding all bodies, ticks
+// ticks of 1/60 s are timed, and the mean time of the phases of a tick (see TickStatistics) is reported.
+
+struct Settings {
+  std::vector<size_t> body_counts = {1000, 10000, 100000};
+  std::vector<std::string> broadphases = {"grid", "sweep", "tree", "dense"};
+  float density = 0.002f;
+  float radius = 4.0f;
+  std::string velocity = "uniform";
+  float speed = 50.0f;
+  float churn = 0.01f;
+  size_t ticks = 100;
+  size_t threads = 1;
+  unsigned seed = 1;
+};
+
+// splits value at the commas
+std::vector<std::string> split(const std::string & value) {
+  std::vector<std::string> parts;
+  std::stringstream stream(value);
+  for (std::string part; std::getline(stream, part, ','); ) {
+    parts.push_back(part);
+  }
+  return parts;
+}
+
+// reads the arguments name=value into settings, returns false for an unknown argument
+bool parse_arguments(int argc, char ** argv, Settings & settings) {
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    size_t equals = argument.find('=');
+    if (equals == std::string::npos) {
+      return false;
+    }
+    std::string name = argument.substr(0, equals);
+    std::string value = argument.substr(equals + 1);
+    if (name == "bodies") {
+      settings.body_counts.clear();
+      for (const std::string & count : split(value)) {
+        settings.body_counts.push_back( std::stoul(count) );
+      }
+    } else if (name == "broadphase") {
+      settings.broadphases = split(value);
+    } else if (name == "density") {
+      settings.density = std::stof(value);
+    } else if (name == "radius") {
+      settings.radius = std::stof(value);
+    } else if (name == "velocity") {
+      settings.velocity = value;
+    } else if (name == "speed") {
+      settings.speed = std::stof(value);
+    } else if (name == "churn") {
+      settings.churn = std::stof(value);
+    } else if (name == "ticks") {
+      settings.ticks = std::stoul(value);
+    } else if (name == "threads") {
+      settings.threads = std::stoul(value);
+    } else if (name == "seed") {
+      settings.seed = std::stoul(value);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// creates random bodies in the world as described at the top
+class BodyFactory {
+  const Settings & settings;
+  std::mt19937 generator;
+  std::uniform_real_distribution<float> position;
+  std::uniform_real_distribution<float> radius;
+  std::uniform_real_distribution<float> uniform_velocity;
+  std::normal_distribution<float> normal_velocity;
+public:
+  BodyFactory(const Settings & settings, float world_size)
+    : settings(settings), generator(settings.seed), position(0.0f, world_size),
+      radius(0.5f * settings.radius, 1.5f * settings.radius),
+      uniform_velocity(-settings.speed, settings.speed), normal_velocity(0.0f, settings.speed) { }
+
+  Body2df create() {
+    Vector2df velocity;
+    for (size_t axis = 0u; axis < 2u; axis++) {
+      if (settings.velocity == "uniform") {
+        velocity[axis] = uniform_velocity(generator);
+      } else if (settings.velocity == "normal") {
+        velocity[axis] = normal_velocity(generator);
+      }
+    }
+    Vector2df center{position(generator), position(generator)};
+    return Body2df( BoundingVolume2df(center, radius(generator)), velocity, 10.0f * settings.speed + 1.0f );
+  }
+};
+
+template<class PHYSICS>
+void run(const Settings & settings, size_t body_count, const std::string & broadphase) {
+  const float world_size = std::sqrt(body_count / settings.density);
+  const size_t churn_count = static_cast<size_t>(settings.churn * body_count);
+  PHYSICS physics; // all collisions are accepted and resolved by doing nothing
+  physics.set_world_extent({world_size, world_size});
+  if constexpr (!std::same_as<PHYSICS, DensePhysics2df>) { // DensePhysics runs on one thread
+    physics.set_thread_count(settings.threads);
+  }
+  if constexpr (std::same_as<PHYSICS, Physics2df>) {
+    physics.set_grid_cell_size(broadphase == "allpairs" ? 0.0f : 4.0f * settings.radius);
+  }
+
+  // the removed bodies of one tick take the place of the bodies added in the next one. DensePhysics
+  // stores copies of the components of the bodies, reached by their handles
+  BodyFactory factory(settings, world_size);
+  std::vector<Body2df> bodies;
+  std::vector<BodyHandle2df> handles(body_count + churn_count);
+  bodies.reserve(body_count + churn_count);
+  for (size_t i = 0; i < body_count + churn_count; i++) {
+    bodies.push_back( factory.create() );
+  }
+  auto add_body = [&](size_t i) {
+    if constexpr (std::same_as<PHYSICS, DensePhysics2df>) {
+      handles[i] = physics.add_body(bodies[i].get_position(), bodies[i].get_bounding_volume().get_radius(),
+                                    bodies[i].get_velocity(), 10.0f * settings.speed + 1.0f);
+    } else {
+      physics.add_body( &bodies[i] );
+    }
+  };
+  auto remove_body = [&](size_t i) {
+    if constexpr (std::same_as<PHYSICS, DensePhysics2df>) {
+      handles[i].mark_for_deletion();
+    } else {
+      bodies[i].mark_for_deletion();
+    }
+  };
+  for (size_t i = 0; i < body_count; i++) {
+    add_body(i);
+  }
+  physics.tick(1.0f / 60.0f);
+  size_t oldest = 0;
+  size_t next = body_count;
+
+  TickStatistics total;
+  for (size_t tick = 0; tick < settings.ticks; tick++) {
+    for (size_t i = 0; i < churn_count; i++) {
+      remove_body(oldest);
+      oldest = (oldest + 1) % bodies.size();
+      bodies[next] = factory.create();
+      add_body(next);
+      next = (next + 1) % bodies.size();
+    }
+    physics.tick(1.0f / 60.0f);
+    const TickStatistics & statistics = physics.get_tick_statistics();
+    total.add_remove_time += statistics.add_remove_time;
+    total.integrate_time += statistics.integrate_time;
+    total.pair_search_time += statistics.pair_search_time;
+    total.resolve_time += statistics.resolve_time;
+    total.pair_count += statistics.pair_count;
+  }
+
+  const double ticks = static_cast<double>(settings.ticks);
+  std::printf("%9zu %-10s %10.1f %12.0f %10.3f %10.3f %10.3f %10.3f %10.1f\n",
+              body_count, broadphase.c_str(), ticks / total.get_total_time(), total.pair_count / total.get_total_time(),
+              1000.0 * total.add_remove_time / ticks, 1000.0 * total.integrate_time / ticks,
+              1000.0 * total.pair_search_time / ticks, 1000.0 * total.resolve_time / ticks, total.pair_count / ticks);
+}
+
+int main(int argc, char ** argv) {
+  Settings settings;
+  if ( !parse_arguments(argc, argv, settings) ) {
+    std::fprintf(stderr, "usage: physics_bench [bodies=1000,10000,100000] [broadphase=grid,sweep,tree,dense] [density=0.002] [radius=4]\n"
+                         "                     [velocity=uniform|normal|zero] [speed=50] [churn=0.01] [ticks=100] [threads=1] [seed=1]\n");
+    return 1;
+  }
+  std::printf("%9s %-10s %10s %12s %10s %10s %10s %10s %10s\n", "bodies", "broadphase", "ticks/s", "pairs/s",
+              "add/rm ms", "move ms", "pairs ms", "resolve ms", "pairs");
+  for (size_t body_count : settings.body_counts) {
+    for (const std::string & broadphase : settings.broadphases) {
+      if (broadphase == "grid" || broadphase == "allpairs") {
+        run<Physics2df>(settings, body_count, broadphase);
+      } else if (broadphase == "sweep") {
+        run<SweepAndPrunePhysics2df>(settings, body_count, broadphase);
+      } else if (broadphase == "tree") {
+        run<DynamicTreePhysics2df>(settings, body_count, broadphase);
+      } else if (broadphase == "dense") {
+        run<DensePhysics2df>(settings, body_count, broadphase);
+      } else {
+        std::fprintf(stderr, "unknown broadphase %s\n", broadphase.c_str());
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include "physics.h"
+#include "physics.tcc" // instantiates the Physics with the functor callbacks below
 #include "gtest/gtest.h"
+#include <random>
 
 
 namespace {
@@ -32,6 +34,39 @@ TEST(BOUNDING_VOLUME, CollidesInside2) {
   EXPECT_TRUE( boundingVolume1.collides(boundingVolume2) );
 }
 
+TEST(BOUNDING_VOLUME, CollidesAcrossWorldBorder) {
+  BoundingVolume2df boundingVolume1( {1.0, 1.0}, 1.0 );
+  BoundingVolume2df boundingVolume2( {99.0, 1.5}, 1.5 );
+  BoundingVolume2df boundingVolume3( {1.0, 99.0}, 1.5 );
+
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume2) );
+  EXPECT_TRUE( boundingVolume1.collides(boundingVolume2, {100.0f, 100.0f}) );
+  EXPECT_TRUE( boundingVolume2.collides(boundingVolume1, {100.0f, 0.0f}) );
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume2, {0.0f, 100.0f}) );
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume3, {100.0f, 0.0f}) );
+  EXPECT_TRUE( boundingVolume1.collides(boundingVolume3, {0.0f, 100.0f}) );
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume3, {100.0f, 200.0f}) );
+}
+
+TEST(BOUNDING_VOLUME, TimeOfImpact) {
+  BoundingVolume2df boundingVolume1( {0.0, 0.0}, 1.0 );
+  BoundingVolume2df boundingVolume2( {10.0, 0.0}, 2.0 );
+  BoundingVolume2df boundingVolume3( {1.5, 0.5}, 1.0 );
+  BoundingVolume2df boundingVolume4( {92.0, 0.0}, 1.0 );
+
+  // touches at a distance of 3, when the center of boundingVolume1 is at 7
+  EXPECT_NEAR(0.35, boundingVolume1.get_time_of_impact(boundingVolume2, {20.0, 0.0}), 0.00001);
+  EXPECT_NEAR(0.7, boundingVolume1.get_time_of_impact(boundingVolume2, {10.0, 0.0}), 0.00001);
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {5.0, 0.0}));
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {20.0, 10.0}));
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {-20.0, 0.0}));
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {0.0, 0.0}));
+  EXPECT_NEAR(0.0, boundingVolume1.get_time_of_impact(boundingVolume3, {20.0, 0.0}), 0.00001);
+  // across the border the image at -8 is hit, at a distance of 2 when the center is at -6
+  EXPECT_NEAR(0.6, boundingVolume1.get_time_of_impact(boundingVolume4, {-10.0, 0.0}, {100.0f, 0.0f}), 0.00001);
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume4, {-10.0, 0.0}, {0.0f, 100.0f}));
+}
+
 
 TEST(RECT_BOUNDING_VOLUME, DoesNotCollide) {
   Rectangle2df boundingVolume1( {0.0, 0.0}, {1.0, 1.0} );
@@ -61,6 +96,40 @@ TEST(RECT_BOUNDING_VOLUME, CollidesInside) {
   EXPECT_TRUE( boundingVolume1.collides(boundingVolume2) );
 }
 
+TEST(RECT_BOUNDING_VOLUME, CollidesAcrossWorldBorder) {
+  Rectangle2df boundingVolume1( {-1.0, 10.0}, {2.0, 2.0} );
+  Rectangle2df boundingVolume2( {97.0, 11.0}, {2.5, 5.0} );
+
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume2) );
+  EXPECT_TRUE( boundingVolume1.collides(boundingVolume2, {100.0f, 100.0f}) );
+  EXPECT_TRUE( boundingVolume2.collides(boundingVolume1, {100.0f, 0.0f}) );
+  EXPECT_FALSE( boundingVolume1.collides(boundingVolume2, {101.0f, 0.0f}) );
+}
+
+TEST(RECT_BOUNDING_VOLUME, TimeOfImpact) {
+  Rectangle2df boundingVolume1( {0.0, 0.0}, {1.0, 1.0} );
+  Rectangle2df boundingVolume2( {5.0, 0.5}, {1.0, 2.0} );
+  Rectangle2df boundingVolume3( {0.5, 0.5}, {1.0, 1.0} );
+
+  // touches when the lower corner of boundingVolume1 is at x = 4
+  EXPECT_NEAR(0.4, boundingVolume1.get_time_of_impact(boundingVolume2, {10.0, 0.0}), 0.00001);
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {3.0, 0.0}));
+  EXPECT_LT(1.0, boundingVolume1.get_time_of_impact(boundingVolume2, {10.0, 10.0}));
+  EXPECT_NEAR(0.0, boundingVolume1.get_time_of_impact(boundingVolume3, {10.0, 0.0}), 0.00001);
+  // across the border the image at x = -95 is hit, when the lower corner is at x = -94
+  EXPECT_NEAR(0.94, boundingVolume1.get_time_of_impact(boundingVolume2, {-100.0, 0.0}, {100.0f, 0.0f}), 0.00001);
+}
+
+TEST(RECT_BOUNDING_VOLUME, IntersectsRay) {
+  Rectangle2df rectangle( {1.0, 1.0}, {2.0, 1.0} );
+
+  EXPECT_NEAR(1.0, rectangle.intersects( Ray2df{ {0.0, 1.5}, {1.0, 0.0} } ), 0.00001);
+  EXPECT_NEAR(2.0, rectangle.intersects( Ray2df{ {2.0, 1.5}, {0.5, 0.0} } ), 0.00001); // starts inside
+  EXPECT_GE(0.0, rectangle.intersects( Ray2df{ {0.0, 2.5}, {1.0, 0.0} } ));
+  EXPECT_GE(0.0, rectangle.intersects( Ray2df{ {4.0, 1.5}, {1.0, 0.0} } ));
+  EXPECT_NEAR(1.0, rectangle.get_distance( {4.0, 1.5} ), 0.00001);
+}
+
 
 TEST(BODY, Move) {
   Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {1.0, 0.0} );
@@ -142,6 +211,24 @@ TEST(BODY, AccelerateAndMoveWithMaximumVelocity) {
   EXPECT_NEAR(0.0, body.get_position()[1], 0.00001);
 }
 
+TEST(BODY, GetInterpolatedPosition) {
+  Body2df body( BoundingVolume2df({98.0, 10.0}, 1.0), {4.0, -2.0}, 10.0f );
+  EXPECT_NEAR(98.0, body.get_interpolated_position(0.5f)[0], 0.0001);
+  body.move(1.0f);
+  EXPECT_NEAR(100.0, body.get_interpolated_position(0.5f)[0], 0.0001);
+  EXPECT_NEAR(9.0, body.get_interpolated_position(0.5f)[1], 0.0001);
+  EXPECT_NEAR(98.0, body.get_interpolated_position(0.0f)[0], 0.0001);
+  EXPECT_NEAR(102.0, body.get_interpolated_position(1.0f)[0], 0.0001);
+  // across the border of a repeating world
+  body.set_position({2.0, 8.0});
+  EXPECT_NEAR(1.0, body.get_interpolated_position(0.75f, {100.0f, 0.0f})[0], 0.0001);
+  EXPECT_NEAR(99.0, body.get_interpolated_position(0.25f, {100.0f, 0.0f})[0], 0.0001);
+  // a teleport isn't interpolated
+  body.set_position({50.0, 30.0}, true);
+  EXPECT_NEAR(50.0, body.get_interpolated_position(0.25f, {100.0f, 0.0f})[0], 0.0001);
+  EXPECT_NEAR(30.0, body.get_interpolated_position(0.25f, {100.0f, 0.0f})[1], 0.0001);
+}
+
 TEST(PHYSICS, IsAreaFreeOfBodiesTrue) {
   Body2df body1( BoundingVolume2df({2.0, 2.0}, 1.0), {-0.5, -0.5} );
   Body2df body2( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, -1.0} );
@@ -250,6 +337,33 @@ TEST(PHYSICS, TickBodiesDeletedWhenMarkedForDeletion) {
   EXPECT_EQ(&body3, bodies[0]);
 }
 
+TEST(PHYSICS, GetBodyByHandle) {
+  Body2df body1( BoundingVolume2df({2.0, 2.0}, 1.0), {0.0, 0.0} );
+  Body2df body2( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0} );
+  Physics2df physics{};
+  physics.add_body( &body1 );
+  physics.add_body( &body2 );
+  physics.tick(1.0);
+  physics.add_body( &body1 ); // already added
+  physics.tick(1.0);
+  SlotHandle handle1 = body1.get_handle();
+  SlotHandle handle2 = body2.get_handle();
+
+  EXPECT_EQ(2u, physics.get_bodies().size());
+  EXPECT_EQ(&body1, physics.get_body(handle1));
+  EXPECT_EQ(&body2, physics.get_body(handle2));
+  body1.mark_for_deletion();
+  physics.tick(1.0);
+  EXPECT_EQ(nullptr, physics.get_body(handle1));
+  EXPECT_EQ(&body2, physics.get_body(handle2));
+  EXPECT_EQ(&body2, physics.get_body(0));
+
+  Body2df body3( BoundingVolume2df({5.0, 5.0}, 1.0), {0.0, 0.0} );
+  physics.add_body( &body3 );
+  physics.tick(1.0);
+  EXPECT_EQ(nullptr, physics.get_body(handle1)); // the slot of body1 is reused with a new generation
+  EXPECT_EQ(&body3, physics.get_body(body3.get_handle()));
+}
 
 // object moves 768 units (pixel) from 0 up withing 2 s and 60 FPS 
 TEST(PHYSICS, TickTime60) {
@@ -277,4 +391,648 @@ TEST(PHYSICS, TickTime120) {
   EXPECT_NEAR(768.0, std::round(body.get_position()[1]), 0.00001);
 }
 
+TEST(PHYSICS, TickStatistics) {
+  Body2df body1( BoundingVolume2df({0.0, 0.0}, 1.0), {1.0, 0.0} );
+  Body2df body2( BoundingVolume2df({2.0, 0.0}, 1.0), {0.0, 0.0} );
+  Body2df body3( BoundingVolume2df({10.0, 0.0}, 1.0), {0.0, 0.0} );
+  Physics2df physics([](Body2df * b1, Body2df *) -> bool { return b1->get_position()[0] > 0.5f; },
+                     [](Body2df *, Body2df *) -> void { });
+  physics.add_body( &body1 );
+  physics.add_body( &body2 );
+  physics.add_body( &body3 );
+  physics.tick(0.1f);
+  physics.tick(1.0f);
+
+  const TickStatistics & statistics = physics.get_tick_statistics();
+  EXPECT_EQ(3u, statistics.body_count);
+  EXPECT_EQ(1u, statistics.pair_count);
+  EXPECT_EQ(1u, statistics.resolved_count);
+  EXPECT_LE(0.0, statistics.pair_search_time);
+  EXPECT_NEAR(statistics.add_remove_time + statistics.integrate_time + statistics.pair_search_time + statistics.resolve_time,
+              statistics.get_total_time(), 1e-12);
+}
+
+TEST(PHYSICS, SaveAndRestore) {
+  std::vector<Body2df> bodies;
+  for (size_t i = 0; i < 4; i++) {
+    bodies.push_back( Body2df( BoundingVolume2df({10.0f * i, 0.0}, 1.0), {1.0, 0.0}, 10.0f ) );
+  }
+  Physics2df physics{};
+  physics.add_body( &bodies[0] );
+  physics.add_body( &bodies[1] );
+  physics.add_body( &bodies[2] );
+  physics.tick(1.0f);
+  bodies[0].mark_for_deletion();
+  physics.add_body( &bodies[3] );
+  Snapshot snapshot;
+  for (const Body2df & body : bodies) {
+    body.save(snapshot);
+  }
+  physics.save(snapshot, [&](const Body2df * body) -> size_t { return body - bodies.data(); });
+
+  physics.tick(1.0f);
+  physics.tick(1.0f);
+  std::vector<Body2df *> after_ticks = physics.get_bodies();
+  Vector2df position = bodies[3].get_position();
+  SlotHandle handle = bodies[3].get_handle();
+
+  snapshot.rewind();
+  for (Body2df & body : bodies) {
+    body.restore(snapshot);
+  }
+  physics.restore(snapshot, [&](size_t id) { return &bodies[id]; });
+  EXPECT_NEAR(11.0, bodies[1].get_position()[0], 0.0001);
+  EXPECT_FALSE( physics.get_body(handle) ); // bodies[3] is waiting to be added again
+  physics.tick(1.0f);
+  physics.tick(1.0f);
+  EXPECT_EQ(after_ticks, physics.get_bodies());
+  EXPECT_NEAR(position[0], bodies[3].get_position()[0], 0.0001);
+  EXPECT_EQ(handle, bodies[3].get_handle());
+  EXPECT_EQ(&bodies[3], physics.get_body(handle));
+}
+
+// the grid broadphase has to report the same collisions in the same order as testing all pairs
+template<class BODY, class PHYSICS>
+void expect_grid_reports_same_collisions(std::vector<BODY> & bodies, float cell_size) {
+  using Collisions = std::vector<std::pair<BODY *, BODY *>>;
+  Collisions all_pairs_collisions, grid_collisions;
+  auto check_collision = [](BODY *, BODY *) -> bool { return true; };
+  PHYSICS all_pairs(check_collision, [&](BODY * b1, BODY * b2) -> void { all_pairs_collisions.push_back({b1, b2}); });
+  PHYSICS grid(check_collision, [&](BODY * b1, BODY * b2) -> void { grid_collisions.push_back({b1, b2}); });
+  grid.set_grid_cell_size(cell_size);
+  for (BODY & body : bodies) {
+    all_pairs.add_body( &body );
+    grid.add_body( &body );
+  }
+  all_pairs.tick(0.0f);
+  grid.tick(0.0f);
+
+  EXPECT_LT(0u, all_pairs_collisions.size());
+  EXPECT_EQ(all_pairs_collisions, grid_collisions);
+}
+
+TEST(PHYSICS, TickGridReportsSameCollisions) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+  std::uniform_real_distribution<float> radius(1.0f, 40.0f);
+  std::vector<Body2df> bodies;
+  for (size_t i = 0; i < 300; i++) {
+    bodies.push_back( Body2df( BoundingVolume2df({position(generator), position(generator)}, radius(generator)), {0.0, 0.0} ) );
+  }
+  expect_grid_reports_same_collisions<Body2df, Physics2df>(bodies, 16.0f);
+}
+
+TEST(PHYSICS, TickGridReportsSameCollisionsRect) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+  std::uniform_real_distribution<float> edge_length(1.0f, 80.0f);
+  std::vector<BodyRect2df> bodies;
+  for (size_t i = 0; i < 300; i++) {
+    Rectangle2df rectangle({position(generator), position(generator)}, {edge_length(generator), edge_length(generator)});
+    bodies.push_back( BodyRect2df( rectangle, {0.0, 0.0} ) );
+  }
+  expect_grid_reports_same_collisions<BodyRect2df, PhysicsRect2df>(bodies, 16.0f);
+}
+
+// the broadphases keep their state between the ticks, so moving, removed and added bodies are tested
+// the first 300 bodies are added at the start, every 7th is removed in tick 5, the others are added in tick 10
+// in a world repeating with world_extent, setup configures the tested engine
+template<class BODY, class ALL_PAIRS_PHYSICS, class PHYSICS>
+void expect_same_collisions_over_ticks(const std::vector<BODY> & bodies, Vector2df world_extent = {0.0f, 0.0f},
+                                       std::function<void(PHYSICS &)> setup = [](PHYSICS &) -> void { }) {
+  std::vector<BODY> all_pairs_bodies = bodies;
+  std::vector<BODY> tested_bodies = bodies;
+  // collisions as pairs of indices, the same for both engines
+  std::vector<std::pair<long, long>> all_pairs_collisions, tested_collisions;
+  auto check_collision = [](BODY *, BODY *) -> bool { return true; };
+  ALL_PAIRS_PHYSICS all_pairs(check_collision, [&](BODY * b1, BODY * b2) -> void {
+    all_pairs_collisions.push_back({b1 - all_pairs_bodies.data(), b2 - all_pairs_bodies.data()});
+  });
+  PHYSICS tested(check_collision, [&](BODY * b1, BODY * b2) -> void {
+    tested_collisions.push_back({b1 - tested_bodies.data(), b2 - tested_bodies.data()});
+  });
+  all_pairs.set_world_extent(world_extent);
+  tested.set_world_extent(world_extent);
+  setup(tested);
+  for (size_t i = 0; i < 300; i++) {
+    all_pairs.add_body( &all_pairs_bodies[i] );
+    tested.add_body( &tested_bodies[i] );
+  }
+  for (size_t tick = 0; tick < 20; tick++) {
+    if (tick == 5) {
+      for (size_t i = 0; i < 300; i += 7) {
+        all_pairs_bodies[i].mark_for_deletion();
+        tested_bodies[i].mark_for_deletion();
+      }
+    }
+    if (tick == 10) {
+      for (size_t i = 300; i < bodies.size(); i++) {
+        all_pairs.add_body( &all_pairs_bodies[i] );
+        tested.add_body( &tested_bodies[i] );
+      }
+    }
+    all_pairs.tick(0.1f);
+    tested.tick(0.1f);
+  }
+
+  EXPECT_LT(0u, all_pairs_collisions.size());
+  EXPECT_EQ(all_pairs_collisions, tested_collisions);
+}
+
+// 400 moving circles
+std::vector<Body2df> create_moving_bodies() {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<float> position(0.0f, 400.0f);
+  std::uniform_real_distribution<float> velocity(-50.0f, 50.0f);
+  std::uniform_real_distribution<float> radius(1.0f, 20.0f);
+  std::vector<Body2df> bodies;
+  for (size_t i = 0; i < 400; i++) {
+    bodies.push_back( Body2df( BoundingVolume2df({position(generator), position(generator)}, radius(generator)),
+                               {velocity(generator), velocity(generator)}, 100.0f ) );
+  }
+  return bodies;
+}
+
+// 400 moving rectangles
+std::vector<BodyRect2df> create_moving_rectangles() {
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<float> position(0.0f, 400.0f);
+  std::uniform_real_distribution<float> velocity(-50.0f, 50.0f);
+  std::uniform_real_distribution<float> edge_length(1.0f, 40.0f);
+  std::vector<BodyRect2df> bodies;
+  for (size_t i = 0; i < 400; i++) {
+    Rectangle2df rectangle({position(generator), position(generator)}, {edge_length(generator), edge_length(generator)});
+    bodies.push_back( BodyRect2df( rectangle, {velocity(generator), velocity(generator)}, 100.0f ) );
+  }
+  return bodies;
+}
+
+TEST(PHYSICS, TickSweepAndPruneReportsSameCollisions) {
+  expect_same_collisions_over_ticks<Body2df, Physics2df, SweepAndPrunePhysics2df>(create_moving_bodies());
+}
+
+TEST(PHYSICS, TickDynamicTreeReportsSameCollisions) {
+  expect_same_collisions_over_ticks<Body2df, Physics2df, DynamicTreePhysics2df>(create_moving_bodies());
+}
+
+TEST(PHYSICS, TickDynamicTreeReportsSameCollisionsRect) {
+  expect_same_collisions_over_ticks<BodyRect2df, PhysicsRect2df, DynamicTreePhysicsRect2df>(create_moving_rectangles());
+}
+
+TEST(PHYSICS, TickWrapsPositions) {
+  Body2df body( BoundingVolume2df({99.0, 20.0}, 1.0), {2.0, -30.0}, 100.0f );
+  Body2df unbounded_body( BoundingVolume2df({99.0, 20.0}, 1.0), {2.0, -30.0}, 100.0f );
+  Physics2df physics;
+  Physics2df unbounded_physics;
+  physics.set_world_extent({100.0f, 50.0f});
+  physics.add_body( &body );
+  unbounded_physics.add_body( &unbounded_body );
+  physics.tick(1.0f);
+  unbounded_physics.tick(1.0f);
+
+  EXPECT_NEAR(1.0, body.get_position()[0], 0.0001);
+  EXPECT_NEAR(40.0, body.get_position()[1], 0.0001);
+  EXPECT_NEAR(101.0, unbounded_body.get_position()[0], 0.0001);
+  EXPECT_NEAR(-10.0, unbounded_body.get_position()[1], 0.0001);
+}
+
+// the typed tests run with the broadphase of testing all pairs, sweep and prune and the dynamic tree
+template<class PHYSICS>
+class PHYSICS_BROADPHASES : public testing::Test {};
+
+typedef testing::Types<Physics2df, SweepAndPrunePhysics2df, DynamicTreePhysics2df> Broadphases;
+TYPED_TEST_SUITE(PHYSICS_BROADPHASES, Broadphases);
+
+// two resting bodies touching each other and a resting debris fall asleep after the first tick,
+// a moving body stays awake. The collisions are rejected, so they don't keep the bodies awake
+TYPED_TEST(PHYSICS_BROADPHASES, TickBodiesAtRestFallAsleep) {
+  Body2df resting1( BoundingVolume2df({0.0, 0.0}, 1.5), {0.0, 0.0}, 10.0f );
+  Body2df resting2( BoundingVolume2df({2.0, 0.0}, 1.5), {0.0, 0.0}, 10.0f );
+  Body2df moving( BoundingVolume2df({20.0, 0.0}, 1.0), {1.0, 0.0}, 10.0f );
+  Body2df debris( BoundingVolume2df({50.0, 50.0}, 0.0), {0.0, 0.0} );
+  debris.set_time_to_delete(2.5f);
+  size_t collisions = 0;
+  TypeParam physics([&](Body2df *, Body2df *) -> bool { collisions++; return false; },
+                    [](Body2df *, Body2df *) -> void { });
+  for (Body2df * body : {&resting1, &resting2, &moving, &debris}) {
+    physics.add_body( body );
+  }
+  physics.tick(1.0f);
+  EXPECT_EQ(1u, collisions);
+  EXPECT_TRUE( resting1.is_sleeping() );
+  EXPECT_TRUE( resting2.is_sleeping() );
+  EXPECT_TRUE( debris.is_sleeping() );
+  EXPECT_FALSE( moving.is_sleeping() );
+
+  // the pair of sleeping bodies isn't tested, the time to delete of the sleeping debris still runs down
+  physics.tick(1.0f);
+  EXPECT_EQ(1u, collisions);
+  EXPECT_NEAR(22.0, moving.get_position()[0], 0.0001);
+  EXPECT_NEAR(0.5, debris.get_time_to_delete(), 0.0001);
+
+  // a new velocity wakes the body up
+  resting2.set_velocity({0.5, 0.0});
+  EXPECT_FALSE( resting2.is_sleeping() );
+  physics.tick(1.0f);
+  EXPECT_EQ(2u, collisions);
+  EXPECT_NEAR(2.5, resting2.get_position()[0], 0.0001);
+  EXPECT_NEAR(0.0, resting1.get_position()[0], 0.0001);
+  EXPECT_EQ(3u, physics.get_bodies().size()); // the debris is deleted
+}
+
+// of four overlapping bodies only the pairs whose collision filters match are checked, also the
+// pairs of a fast body found by the continuous collision detection
+TYPED_TEST(PHYSICS_BROADPHASES, TickCollisionFiltersSkipPairs) {
+  Body2df all( BoundingVolume2df({0.0, 0.0}, 2.0), {0.0, 0.0}, 10.0f );
+  Body2df second1( BoundingVolume2df({1.0, 0.0}, 2.0), {0.0, 0.0}, 10.0f );
+  Body2df second2( BoundingVolume2df({0.0, 1.0}, 2.0), {0.0, 0.0}, 10.0f );
+  Body2df none( BoundingVolume2df({1.0, 1.0}, 2.0), {0.0, 0.0}, 10.0f );
+  Body2df fast( BoundingVolume2df({-50.0, 0.0}, 0.5), {100.0, 0.0}, 1000.0f );
+  second1.set_collision_filter(2u, 1u);
+  second2.set_collision_filter(2u, 1u);
+  none.set_collision_filter(4u, 0u);
+  fast.set_collision_filter(8u, ~1u);
+  std::vector<std::pair<Body2df *, Body2df *>> checked;
+  TypeParam physics([&](Body2df * body1, Body2df * body2) -> bool { checked.push_back( std::minmax(body1, body2) ); return false; },
+                    [](Body2df *, Body2df *) -> void { });
+  physics.set_continuous_collision_detection(true);
+  for (Body2df * body : {&all, &second1, &second2, &none, &fast}) {
+    physics.add_body( body );
+  }
+  physics.tick(1.0f);
+  std::sort(checked.begin(), checked.end());
+  std::vector<std::pair<Body2df *, Body2df *>> expected = { std::minmax(&all, &second1), std::minmax(&all, &second2) };
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, checked);
+  EXPECT_FALSE( second1.can_collide(second2) );
+  EXPECT_FALSE( none.can_collide(all) );
+  EXPECT_FALSE( fast.can_collide(all) ); // the fast body passed through all unchecked
+}
+
+TEST(PHYSICS, TickTouchedBodiesStayAwake) {
+  Body2df resting( BoundingVolume2df({0.0, 0.0}, 1.5), {0.0, 0.0}, 10.0f );
+  Body2df wall( BoundingVolume2df({2.0, 0.0}, 1.5), {0.0, 0.0}, 10.0f );
+  Body2df other_wall( BoundingVolume2df({4.0, 0.0}, 1.5), {0.0, 0.0}, 10.0f );
+  wall.set_static(true);
+  other_wall.set_static(true);
+  wall.set_velocity({1.0, 0.0}); // ignored by static bodies
+  size_t collisions = 0;
+  Physics2df physics([](Body2df *, Body2df *) -> bool { return true; },
+                     [&](Body2df *, Body2df *) -> void { collisions++; });
+  physics.add_body( &resting );
+  physics.add_body( &wall );
+  physics.add_body( &other_wall );
+  physics.tick(1.0f);
+  physics.tick(1.0f);
+
+  // the pair of both static bodies is never tested, the resting body touching the wall stays awake
+  EXPECT_EQ(2u, collisions);
+  EXPECT_FALSE( resting.is_sleeping() );
+  EXPECT_TRUE( wall.is_sleeping() );
+  EXPECT_TRUE( wall.is_static() );
+  EXPECT_NEAR(2.0, wall.get_position()[0], 0.0001);
+  EXPECT_NEAR(0.0, wall.get_velocity()[0], 0.0001);
+}
+
+// a torpedo (radius 1, 768 pixel per second) passes through a small asteroid between two ticks at 10 Hz
+TEST(PHYSICS, TickContinuousCollisionDetection) {
+  for (float tick_time : {0.1f, 0.05f}) {
+    Body2df torpedo( BoundingVolume2df({0.0, 50.0}, 1.0), {768.0, 0.0}, 1000.0f );
+    Body2df asteroid( BoundingVolume2df({40.0, 50.0}, 5.0), {0.0, 0.0} );
+    Body2df far_asteroid( BoundingVolume2df({40.0, 70.0}, 5.0), {0.0, 0.0} );
+    Physics2df * engine = nullptr;
+    std::vector<std::pair<Body2df *, Body2df *>> collisions;
+    std::vector<float> times_of_impact;
+    Physics2df physics([](Body2df *, Body2df *) -> bool { return true; },
+                       [&](Body2df * b1, Body2df * b2) -> void {
+                         collisions.push_back( {b1, b2} );
+                         times_of_impact.push_back( engine->get_time_of_impact() );
+                       });
+    engine = &physics;
+    physics.add_body( &torpedo );
+    physics.add_body( &asteroid );
+    physics.add_body( &far_asteroid );
+    physics.tick(tick_time);
+    // the collision at the end of the shorter tick is found without sweeping
+    EXPECT_EQ(tick_time == 0.05f ? 1u : 0u, collisions.size());
+    EXPECT_NEAR(1.0, physics.get_time_of_impact(), 0.00001);
+
+    torpedo.set_position({0.0, 50.0});
+    physics.set_continuous_collision_detection(true);
+    collisions.clear();
+    times_of_impact.clear();
+    physics.tick(tick_time);
+    ASSERT_EQ(1u, collisions.size());
+    EXPECT_EQ(&torpedo, collisions[0].first);
+    EXPECT_EQ(&asteroid, collisions[0].second);
+    // touches at a distance of 6, when the torpedo is at 34
+    EXPECT_NEAR(34.0f / 768.0f / tick_time, times_of_impact[0], 0.0001);
+  }
+}
+
+// in a repeating world a fast body is swept across the border
+TEST(PHYSICS, TickContinuousCollisionDetectionAcrossWorldBorder) {
+  Body2df torpedo( BoundingVolume2df({90.0, 50.0}, 1.0), {200.0, 0.0}, 1000.0f );
+  Body2df asteroid( BoundingVolume2df({5.0, 50.0}, 2.0), {0.0, 0.0} );
+  Body2df fast_asteroid( BoundingVolume2df({50.0, 20.0}, 2.0), {0.0, 100.0}, 1000.0f );
+  std::vector<std::pair<Body2df *, Body2df *>> collisions;
+  Physics2df physics([](Body2df *, Body2df *) -> bool { return true; },
+                     [&](Body2df * b1, Body2df * b2) -> void { collisions.push_back( {b1, b2} ); });
+  physics.set_world_extent({100.0f, 100.0f});
+  physics.set_continuous_collision_detection(true);
+  physics.add_body( &torpedo );
+  physics.add_body( &asteroid );
+  physics.add_body( &fast_asteroid );
+  physics.tick(0.2f);
+
+  // the torpedo ends at 30 (130 wrapped), the fast asteroid crosses its path at 50 but after it
+  EXPECT_NEAR(30.0, torpedo.get_position()[0], 0.0001);
+  ASSERT_EQ(1u, collisions.size());
+  EXPECT_EQ(&torpedo, collisions[0].first);
+  EXPECT_EQ(&asteroid, collisions[0].second);
+}
+
+// the sweep follows the actual move of a body, also if its fix callback changed its velocity after it
+TEST(PHYSICS, TickContinuousCollisionDetectionAfterFix) {
+  Body2df torpedo( BoundingVolume2df({0.0, 50.0}, 1.0), {768.0, 0.0}, 1000.0f, 0.0f, 0.0f,
+                   [](Body2df * body, float) -> void { body->set_velocity({0.0, 0.0}); } );
+  Body2df asteroid( BoundingVolume2df({40.0, 50.0}, 5.0), {0.0, 0.0} );
+  std::vector<std::pair<Body2df *, Body2df *>> collisions;
+  Physics2df physics([](Body2df *, Body2df *) -> bool { return true; },
+                     [&](Body2df * b1, Body2df * b2) -> void { collisions.push_back( {b1, b2} ); });
+  physics.set_continuous_collision_detection(true);
+  physics.add_body( &torpedo );
+  physics.add_body( &asteroid );
+  physics.tick(0.1f);
+
+  EXPECT_NEAR(76.8, torpedo.get_position()[0], 0.0001);
+  ASSERT_EQ(1u, collisions.size());
+  EXPECT_EQ(&torpedo, collisions[0].first);
+  EXPECT_EQ(&asteroid, collisions[0].second);
+}
+
+// at a low tick rate most of the moving bodies are fast, the candidates the broadphases find for
+// them give the same swept pairs as testing all bodies, also across the borders of a repeating world
+TYPED_TEST(PHYSICS_BROADPHASES, TickContinuousCollisionDetectionLikeTestingAllBodies) {
+  std::vector<Body2df> all_bodies = create_moving_bodies();
+  std::vector<Body2df> tested_bodies = create_moving_bodies();
+  std::vector<std::pair<long, long>> all_collisions, tested_collisions;
+  Physics2df all([](Body2df *, Body2df *) -> bool { return true; }, [&](Body2df * b1, Body2df * b2) -> void {
+    all_collisions.push_back({b1 - all_bodies.data(), b2 - all_bodies.data()});
+  });
+  TypeParam tested([](Body2df *, Body2df *) -> bool { return true; }, [&](Body2df * b1, Body2df * b2) -> void {
+    tested_collisions.push_back({b1 - tested_bodies.data(), b2 - tested_bodies.data()});
+  });
+  all.set_world_extent({400.0f, 400.0f});
+  tested.set_world_extent({400.0f, 400.0f});
+  all.set_continuous_collision_detection(true);
+  tested.set_continuous_collision_detection(true);
+  for (size_t i = 0; i < all_bodies.size(); i++) {
+    all.add_body( &all_bodies[i] );
+    tested.add_body( &tested_bodies[i] );
+  }
+  for (size_t tick = 0; tick < 10; tick++) {
+    all.tick(0.5f);
+    tested.tick(0.5f);
+  }
+
+  EXPECT_LT(0u, all_collisions.size());
+  EXPECT_EQ(all_collisions, tested_collisions);
+}
+
+// the moving bodies cross the borders of a 400 x 300 world
+TEST(PHYSICS, TickRepeatingWorldReportsSameCollisions) {
+  const Vector2df world_extent = {400.0f, 300.0f};
+  expect_same_collisions_over_ticks<Body2df, Physics2df, Physics2df>(create_moving_bodies(), world_extent,
+      [](Physics2df & physics) -> void { physics.set_grid_cell_size(16.0f); });
+  expect_same_collisions_over_ticks<Body2df, Physics2df, Physics2df>(create_moving_bodies(), world_extent,
+      [](Physics2df & physics) -> void { physics.set_grid_cell_size(48.0f); });
+  expect_same_collisions_over_ticks<Body2df, Physics2df, SweepAndPrunePhysics2df>(create_moving_bodies(), world_extent);
+  expect_same_collisions_over_ticks<Body2df, Physics2df, DynamicTreePhysics2df>(create_moving_bodies(), world_extent);
+}
+
+TEST(PHYSICS, TickRepeatingWorldReportsSameCollisionsRect) {
+  const Vector2df world_extent = {400.0f, 300.0f};
+  expect_same_collisions_over_ticks<BodyRect2df, PhysicsRect2df, PhysicsRect2df>(create_moving_rectangles(), world_extent,
+      [](PhysicsRect2df & physics) -> void { physics.set_grid_cell_size(16.0f); });
+  expect_same_collisions_over_ticks<BodyRect2df, PhysicsRect2df, DynamicTreePhysicsRect2df>(create_moving_rectangles(), world_extent);
+}
+
+// callbacks as functors, which are statically dispatched
+struct CollidesIfMoving {
+  bool operator()(Body2df * b1, Body2df * b2) const {
+    return b1->get_velocity().square_of_length() > 0 || b2->get_velocity().square_of_length() > 0;
+  }
+};
+
+struct RecordCollision {
+  std::vector<std::pair<Body2df *, Body2df *>> * collisions;
+  void operator()(Body2df * b1, Body2df * b2) const { collisions->push_back({b1, b2}); }
+};
+
+struct StopAtZero {
+  void operator()(Body2df * body, float) const {
+    if (body->get_position()[0] < 0) {
+      body->set_velocity({0.0f, 0.0f});
+    }
+  }
+};
+
+// with several threads the collisions and positions are exactly the same as with one thread
+TEST(PHYSICS, TickMultithreadedReportsSameCollisions) {
+  const Vector2df world_extent = {400.0f, 300.0f};
+  for (size_t thread_count : {2u, 3u, 8u}) {
+    for (Vector2df extent : {Vector2df{0.0f, 0.0f}, world_extent}) {
+      expect_same_collisions_over_ticks<Body2df, Physics2df, Physics2df>(create_moving_bodies(), extent,
+          [&](Physics2df & physics) -> void { physics.set_thread_count(thread_count); });
+      expect_same_collisions_over_ticks<Body2df, Physics2df, Physics2df>(create_moving_bodies(), extent,
+          [&](Physics2df & physics) -> void { physics.set_grid_cell_size(16.0f); physics.set_thread_count(thread_count); });
+      expect_same_collisions_over_ticks<Body2df, Physics2df, SweepAndPrunePhysics2df>(create_moving_bodies(), extent,
+          [&](SweepAndPrunePhysics2df & physics) -> void { physics.set_thread_count(thread_count); });
+      expect_same_collisions_over_ticks<Body2df, Physics2df, DynamicTreePhysics2df>(create_moving_bodies(), extent,
+          [&](DynamicTreePhysics2df & physics) -> void { physics.set_thread_count(thread_count); });
+    }
+  }
+
+  std::vector<Body2df> bodies = create_moving_bodies();
+  std::vector<Body2df> multithreaded_bodies = bodies;
+  Physics2df physics;
+  Physics2df multithreaded_physics;
+  multithreaded_physics.set_thread_count(4);
+  for (size_t i = 0; i < bodies.size(); i++) {
+    physics.add_body( &bodies[i] );
+    multithreaded_physics.add_body( &multithreaded_bodies[i] );
+  }
+  for (size_t tick = 0; tick < 10; tick++) {
+    physics.tick(0.1f);
+    multithreaded_physics.tick(0.1f);
+  }
+  for (size_t i = 0; i < bodies.size(); i++) {
+    EXPECT_EQ(bodies[i].get_position()[0], multithreaded_bodies[i].get_position()[0]);
+    EXPECT_EQ(bodies[i].get_position()[1], multithreaded_bodies[i].get_position()[1]);
+  }
+}
+
+TEST(PHYSICS, TickFunctorCallbacksLikeFunctionCallbacks) {
+  std::vector<Body2df> bodies = create_moving_bodies();
+  for (size_t i = 0; i < bodies.size(); i += 3) {
+    bodies[i].set_velocity({0.0f, 0.0f});
+  }
+  std::vector<Body2df> function_bodies = bodies;
+  std::vector<std::pair<Body2df *, Body2df *>> collisions, function_collisions;
+  Physics<float, 2u, BoundingVolume2df, GridBroadphase<float, 2u, BoundingVolume2df>, CollidesIfMoving, RecordCollision, StopAtZero>
+      physics(CollidesIfMoving{}, RecordCollision{&collisions});
+  Physics<float, 2u, BoundingVolume2df, GridBroadphase<float, 2u, BoundingVolume2df>, std::function<bool(Body2df *, Body2df *)>,
+          std::function<void(Body2df *, Body2df *)>, std::function<void(Body2df *, float)>>
+      function_physics(CollidesIfMoving{}, RecordCollision{&function_collisions}, StopAtZero{});
+  for (size_t i = 0; i < bodies.size(); i++) {
+    physics.add_body( &bodies[i] );
+    function_physics.add_body( &function_bodies[i] );
+  }
+  for (size_t tick = 0; tick < 10; tick++) {
+    physics.tick(0.5f);
+    function_physics.tick(0.5f);
+  }
+
+  EXPECT_LT(0u, collisions.size());
+  ASSERT_EQ(function_collisions.size(), collisions.size());
+  for (size_t i = 0; i < collisions.size(); i++) {
+    EXPECT_EQ(function_collisions[i].first - function_bodies.data(), collisions[i].first - bodies.data());
+    EXPECT_EQ(function_collisions[i].second - function_bodies.data(), collisions[i].second - bodies.data());
+  }
+  for (size_t i = 0; i < bodies.size(); i++) {
+    EXPECT_EQ(function_bodies[i].get_position()[0], bodies[i].get_position()[0]);
+  }
+}
+
+// the queries of the Physics with the tree have to find the same bodies as testing all bodies
+TEST(PHYSICS, DynamicTreeQueries) {
+  std::vector<Body2df> bodies = create_moving_bodies();
+  DynamicTreePhysics2df physics;
+  for (Body2df & body : bodies) {
+    physics.add_body( &body );
+  }
+  physics.tick(0.1f);
+  EXPECT_GT(20u, physics.get_broadphase().get_height()); // balanced, 400 leaves need at least 9 levels
+
+  Vector2df center = {200.0f, 200.0f};
+  std::vector<Body2df *> found(bodies.size()), expected;
+  found.resize( physics.query_circle(center, 30.0f, found) );
+  for (Body2df & body : bodies) {
+    if ( body.get_bounding_volume().get_distance(center) <= 30.0f ) {
+      expected.push_back(&body);
+    }
+  }
+  std::sort(found.begin(), found.end());
+  EXPECT_LT(0u, expected.size());
+  EXPECT_EQ(expected, found);
+
+  Ray2df ray{ {-10.0f, 180.0f}, {1.0f, 0.1f} };
+  float t = 0.0f;
+  Body2df * hit = physics.ray_cast(ray, 1000.0f, t);
+  Body2df * expected_hit = nullptr;
+  float expected_t = std::numeric_limits<float>::infinity();
+  for (Body2df & body : bodies) {
+    float body_t = body.get_bounding_volume().intersects(ray);
+    if (body_t > 0 && body_t < expected_t) {
+      expected_hit = &body;
+      expected_t = body_t;
+    }
+  }
+  ASSERT_NE(nullptr, expected_hit);
+  EXPECT_EQ(expected_hit, hit);
+  EXPECT_NEAR(expected_t, t, 0.0001);
+
+  Vector2df point = {123.0f, 321.0f};
+  Body2df * nearest[1];
+  EXPECT_EQ(1u, physics.query_nearest(point, nearest));
+  Body2df * expected_nearest = &bodies[0];
+  for (Body2df & body : bodies) {
+    if (body.get_bounding_volume().get_distance(point) < expected_nearest->get_bounding_volume().get_distance(point)) {
+      expected_nearest = &body;
+    }
+  }
+  EXPECT_EQ(expected_nearest, nearest[0]);
+}
+
+// the spatial queries of the Physics have to find the same bodies as testing all bodies, across the
+// borders of the repeating world, also after some bodies were removed
+TYPED_TEST(PHYSICS_BROADPHASES, QueriesLikeTestingAllBodies) {
+  std::vector<Body2df> bodies = create_moving_bodies();
+  TypeParam physics;
+  const Vector2df world_extent = {400.0f, 400.0f};
+  physics.set_world_extent(world_extent);
+  for (Body2df & body : bodies) {
+    physics.add_body( &body );
+  }
+  physics.tick(0.1f);
+  for (size_t i = 0; i < bodies.size(); i += 7) {
+    bodies[i].mark_for_deletion();
+  }
+  physics.tick(0.1f);
+  const std::vector<Body2df *> live_bodies = physics.get_bodies();
+  auto is_even = [&](Body2df * body) -> bool { return (body - bodies.data()) % 2 == 0; };
+
+  Vector2df center = {5.0f, 390.0f};
+  std::vector<Body2df *> found(bodies.size()), expected;
+  found.resize( physics.query_circle(center, 30.0f, found, is_even) );
+  for (Body2df * body : live_bodies) {
+    if ( is_even(body) && body->get_bounding_volume().get_distance( get_nearest_image(center, body->get_position(), world_extent) ) <= 30.0f ) {
+      expected.push_back(body);
+    }
+  }
+  std::sort(found.begin(), found.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_LT(0u, expected.size());
+  EXPECT_EQ(expected, found);
+
+  // the results end at the size of the buffer
+  Body2df * two[2];
+  EXPECT_EQ(2u, physics.query_circle(center, 30.0f, two));
+
+  Vector2df lower = {380.0f, -10.0f}, upper = {420.0f, 50.0f};
+  Vector2df box_center = 0.5f * (lower + upper);
+  found.resize(bodies.size());
+  found.resize( physics.query_box(lower, upper, found) );
+  expected.clear();
+  for (Body2df * body : live_bodies) {
+    Vector2df offset = get_nearest_image(box_center, body->get_position(), world_extent) - box_center;
+    if ( body->get_bounding_volume().overlaps(lower + offset, upper + offset) ) {
+      expected.push_back(body);
+    }
+  }
+  std::sort(found.begin(), found.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_LT(0u, expected.size());
+  EXPECT_EQ(expected, found);
+
+  Ray2df ray{ {10.0f, 180.0f}, {1.0f, 0.1f} };
+  float t = 0.0f;
+  Body2df * hit = physics.ray_cast(ray, 300.0f, t);
+  Body2df * expected_hit = nullptr;
+  float expected_t = std::numeric_limits<float>::infinity();
+  for (Body2df * body : live_bodies) {
+    float body_t = body->get_bounding_volume().intersects(ray);
+    if (body_t > 0 && body_t <= 300.0f && body_t < expected_t) {
+      expected_hit = body;
+      expected_t = body_t;
+    }
+  }
+  ASSERT_NE(nullptr, expected_hit);
+  EXPECT_EQ(expected_hit, hit);
+  EXPECT_NEAR(expected_t, t, 0.0001);
+  EXPECT_EQ(nullptr, physics.ray_cast(ray, 0.5f * expected_t, t));
+
+  Vector2df point = {395.0f, 3.0f};
+  auto get_distance = [&](Body2df * body) {
+    return body->get_bounding_volume().get_distance( get_nearest_image(point, body->get_position(), world_extent) );
+  };
+  found.resize(5);
+  EXPECT_EQ(5u, physics.query_nearest(point, found));
+  expected = live_bodies;
+  std::sort(expected.begin(), expected.end(), [&](Body2df * a, Body2df * b) { return get_distance(a) < get_distance(b); });
+  expected.resize(5);
+  EXPECT_EQ(expected, found);
+}
+
 }
@@ -21,15 +21,18 @@ void SDL2GameController::set_fps(int fps) {
 }
 
 
-void SDL2GameController::do_user_interactions() {
-  const Uint8 *keys = SDL_GetKeyboardState(NULL);
- 
+// polling the events also updates the keyboard state read by do_user_interactions
+void SDL2GameController::poll_events() {
   SDL_Event e;
   while ( SDL_PollEvent( &e ) ) {
     if (e.type == SDL_QUIT ) {
       quit = true;
     }
   }
+}
+
+void SDL2GameController::do_user_interactions() {
+  const Uint8 *keys = SDL_GetKeyboardState(NULL);
 
   if (! quit) {
     game.tick(tick_time);
@@ -16,6 +16,7 @@ class SDL2GameController : public GameController {
   Effect backgroundSound = Effect( std::span{beats}, MAX_DISTANCE_BETWEEN_BEATS, 10.0f);
 public:
   SDL2GameController(Game & game);
+  virtual void poll_events();
   virtual void do_user_interactions();
   virtual void do_game_events();
   float get_tick_time() const;
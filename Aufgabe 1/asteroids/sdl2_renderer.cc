@@ -3,126 +3,101 @@
 #include <utility>
 
 
-void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
-    static std::array<SDL_Point, 5> ship_points{
+Vector2df SDL2Renderer::get_position(const Body2df * body) const {
+  return body->get_interpolated_position(interpolation, game.get_physics().get_world_extent());
+}
 
-                                              SDL_Point{-10, -5},
-                                              SDL_Point{10, -5},
-                                              SDL_Point{10, 5},
-                                              SDL_Point{-10, 5},
-                                              SDL_Point{-10, -5}};
-  
-  std::array<SDL_Point, ship_points.size()> points;
+void SDL2Renderer::set_interpolation(float alpha) {
+  interpolation = alpha;
+}
+
+void SDL2Renderer::renderOutline(const Matrix2x3df & transformation, std::span<const Vector2df> outline) {
+  constexpr size_t MAX_OUTLINE_SIZE = 16;
+  assert(outline.size() <= MAX_OUTLINE_SIZE);
+  std::array<Vector2df, MAX_OUTLINE_SIZE> transformed;
+  std::array<SDL_Point, MAX_OUTLINE_SIZE> points;
 
-  float cos_angle = std::cos(angle);
-  float sin_angle = std::sin(angle);
-  for (size_t i = 0; i < ship_points.size(); i++) {
-    float x = ship_points[i].x;
-    float y = ship_points[i].y;
-    points[i].x = (cos_angle * x - sin_angle * y) + position[0];
-    points[i].y = (sin_angle * x + cos_angle * y) + position[1];
+  transformation.transform_points(outline, transformed);
+  for (size_t i = 0; i < outline.size(); i++) {
+    points[i].x = transformed[i][0];
+    points[i].y = transformed[i][1];
   }
+  SDL_RenderDrawLines(renderer, points.data(), outline.size());
+}
+
+void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
+  static constexpr Vector2df ship_points[] = { {-10, -5}, {10, -5}, {10, 5}, {-10, 5}, {-10, -5} };
+
   SDL_SetRenderDrawColor(renderer, 28, 134, 238, 255);
-  SDL_RenderDrawLines(renderer, points.data(), points.size());
+  renderOutline(Matrix2x3df::translation(position) * Matrix2x3df::rotation(angle), ship_points);
   SDL_SetRenderDrawColor(renderer, 28, 134, 238, 255);
 
 }
 
 void SDL2Renderer::render(Spaceship * ship) {
-  static SDL_Point flame_points[] { {-6, 3}, {-12, 0}, {-6, -3} };
-  std::array<SDL_Point, std::span{flame_points}.size()> points;
+  static constexpr Vector2df flame_points[] { {-6, 3}, {-12, 0}, {-6, -3} };
 
   if (! ship->is_in_hyperspace()) {
     if (ship->is_accelerating()) {
-      float cos_angle = std::cos(ship->get_angle());
-      float sin_angle = std::sin(ship->get_angle());
-      for (size_t i = 0; i < points.size(); i++) {
-        float x = flame_points[i].x;
-        float y = flame_points[i].y;
-        points[i].x = (cos_angle * x - sin_angle * y) + ship->get_position()[0];
-        points[i].y = (sin_angle * x + cos_angle * y) + ship->get_position()[1];
-      }
-
-       SDL_RenderDrawLines(renderer, points.data(), points.size());
+      renderOutline(Matrix2x3df::translation(get_position(ship)) * Matrix2x3df::rotation(ship->get_angle()), flame_points);
     }
-  renderSpaceship(ship->get_position(), ship->get_angle());  
+  renderSpaceship(get_position(ship), ship->get_angle());  
   }
 }
 
 void SDL2Renderer::render(Saucer * saucer) {
-  static SDL_Point saucer_points[] = { {-16, -6}, {16, -6}, {40, 6}, {-40, 6}, {-16, 18}, {16, 18},
+  static constexpr Vector2df saucer_points[] = { {-16, -6}, {16, -6}, {40, 6}, {-40, 6}, {-16, 18}, {16, 18},
                                        {40, 6}, {16, -6}, {8, -18}, {-8, -18}, {-16, -6}, {-40, 6} };
-  
-  std::array<SDL_Point, std::span{saucer_points}.size()> points;
 
-  Vector2df position = saucer->get_position();
   float scale = 0.5;
   if ( saucer->get_size() == 0 ) {
     scale = 0.25;
   }
-  for (size_t i = 0; i < points.size(); i++) {
-    float x = saucer_points[i].x;
-    float y = saucer_points[i].y;
-    points[i].x = scale * x + position[0];
-    points[i].y = scale * y + position[1];
-  }
-  SDL_RenderDrawLines(renderer, points.data(), points.size());
+  renderOutline(Matrix2x3df::translation(get_position(saucer)) * Matrix2x3df::scaling({scale, scale}), saucer_points);
 }
 
 
 void SDL2Renderer::render(Torpedo * torpedo) {
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1]);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0] + 1, torpedo->get_position()[1]);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1] - 1);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1] + 1);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0] - 1, torpedo->get_position()[1]);
+  Vector2df position = get_position(torpedo);
+  SDL_RenderDrawPoint(renderer, position[0], position[1]);
+  SDL_RenderDrawPoint(renderer, position[0] + 1, position[1]);
+  SDL_RenderDrawPoint(renderer, position[0], position[1] - 1);
+  SDL_RenderDrawPoint(renderer, position[0], position[1] + 1);
+  SDL_RenderDrawPoint(renderer, position[0] - 1, position[1]);
 }
   
 void SDL2Renderer::render(Asteroid * asteroid) {
-  static SDL_Point asteroids_points1[] = {
+  static constexpr Vector2df asteroids_points1[] = {
     { 0, -12}, {16, -24}, {32, -12}, {24, 0}, {32, 12}, {8, 24}, {-16, 24}, {-32, 12}, {-32, -12}, {-16, -24}, {0, -12}
   };   
-  static SDL_Point asteroids_points2[] = {
+  static constexpr Vector2df asteroids_points2[] = {
     { 16, -6}, {32, -12}, {16, -24}, {0, -16}, {-16, -24}, {-24, -12}, {-16, -0}, {-32, 12}, {-16, 24}, {-8, 16}, {16, 24}, {32, 6}, {16, -6}
   }; 
-  static SDL_Point asteroids_points3[] = {
+  static constexpr Vector2df asteroids_points3[] = {
     {-16, 0}, {-32, 6}, {-16, 24}, {0, 6}, {0, 24}, {16, 24}, {32, 6}, {32, 6}, {16, -24}, {-8, -24}, {-32, -6}, {-16, 0}
   };
-  static SDL_Point asteroids_points4[] = {  
+  static constexpr Vector2df asteroids_points4[] = {  
     {8,0}, {32,-6}, {32, -12}, {8, -24}, {-16, -24}, {-8, -12}, {-32, -12}, {-32, 12}, {-16, 24}, {8, 16}, {16, 24}, {32, 12}, {8, 0}
   };
-  static size_t sizes[] = {std::span{asteroids_points1}.size(),
-                           std::span{asteroids_points2}.size(),
-                           std::span{asteroids_points3}.size(),
-                           std::span{asteroids_points4}.size() };
-  size_t size = sizes[ asteroid->get_rock_type() ];
-  SDL_Point * asteroids_points = asteroids_points1;
-  if ( asteroid->get_rock_type() == 1 ) asteroids_points = asteroids_points2;
-  if ( asteroid->get_rock_type() == 2 ) asteroids_points = asteroids_points3;
-  if ( asteroid->get_rock_type() == 3 ) asteroids_points = asteroids_points4;
- 
-  SDL_Point points[std::span{asteroids_points4}.size()];
-  
+  static constexpr std::span<const Vector2df> asteroids_outlines[] = { asteroids_points1, asteroids_points2,
+                                                                       asteroids_points3, asteroids_points4 };
+
   float scale = (asteroid->get_size() == 3 ? 1.0 : ( asteroid->get_size() == 2 ? 0.5 : 0.25 ));
-  Vector2df position = asteroid->get_position();
-  for (size_t i = 0; i < size; i++) {
-    points[i].x = scale * asteroids_points[i].x + position[0];
-    points[i].y = scale * asteroids_points[i].y + position[1];
-  }
-  SDL_RenderDrawLines(renderer, points, size);
+  renderOutline(Matrix2x3df::translation(get_position(asteroid)) * Matrix2x3df::scaling({scale, scale}),
+                asteroids_outlines[ asteroid->get_rock_type() ]);
 }
 
 
 void SDL2Renderer::render(SpaceshipDebris * debris) {
-  static SDL_Point ship_points[6][2] = {{ SDL_Point{-2, -1}, SDL_Point{-10, 7} }, 
+  static constexpr SDL_Point ship_points[6][2] = {{ SDL_Point{-2, -1}, SDL_Point{-10, 7} }, 
                                         { SDL_Point{3, 1}, SDL_Point{7, 8} },
                                         { SDL_Point{0, 3}, SDL_Point{6, 1} },
                                         { SDL_Point{3, -1}, SDL_Point{ -5, -7} },
                                         { SDL_Point{0, -4}, SDL_Point{-6, -6} },
                                         { SDL_Point{-2, 2}, SDL_Point{2, 5} } };
-  static std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
+  static constexpr std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
                                                        Vector2df{60, -15}, Vector2df{10, -52}, Vector2df{-40, 30} };
-  Vector2df position = debris->get_position();
+  Vector2df position = get_position(debris);
   std::array<SDL_Point, 4> points;
   float scale =  0.2 * (SpaceshipDebris::TIME_TO_DELETE - debris->get_time_to_delete());
   for (size_t i = 0; i < debris_direction.size(); i++) {
@@ -138,10 +113,10 @@ void SDL2Renderer::render(SpaceshipDebris * debris) {
 }
 
 void SDL2Renderer::render(Debris * debris) {
-  static SDL_Point debris_points[] = { {-32, 32}, {-32, -16}, {-16, 0}, {-16, -32}, {-8, 24}, {8, -24}, {24, 32}, {24, -24}, {24, -32}, {32, -8} };
+  static constexpr SDL_Point debris_points[] = { {-32, 32}, {-32, -16}, {-16, 0}, {-16, -32}, {-8, 24}, {8, -24}, {24, 32}, {24, -24}, {24, -32}, {32, -8} };
 
   static SDL_Point point;
-  Vector2df position = debris->get_position();
+  Vector2df position = get_position(debris);
   for (size_t i = 0; i < std::span{debris_points}.size(); i++) {
     point.x = (Debris::TIME_TO_DELETE - debris->get_time_to_delete()) * debris_points[i].x + position[0];
     point.y = (Debris::TIME_TO_DELETE - debris->get_time_to_delete()) * debris_points[i].y + position[1];
@@ -167,18 +142,18 @@ void SDL2Renderer::renderScore() {
   constexpr float SCORE_X = 128 - 48;
   constexpr float SCORE_Y = 48 - 4;
   
-  static SDL_Point digit_0[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0, -8} };
-  static SDL_Point digit_1[] = { {4,0}, {4,-8} };
-  static SDL_Point digit_2[] = { {0,-8}, {4,-8}, {4,-4}, {0,-4}, {0,0}, {4,0}  };
-  static SDL_Point digit_3[] = { {0,0}, {4, 0}, {4,-4}, {0,-4}, {4,-4}, {4, -8}, {0, -8}  };
-  static SDL_Point digit_4[] = { {4,0}, {4,-8}, {4,-4}, {0,-4}, {0,-8}  };
-  static SDL_Point digit_5[] = { {0,0}, {4,0}, {4,-4}, {0,-4}, {0,-8}, {4, -8}  };
-  static SDL_Point digit_6[] = { {0,-8}, {0,0}, {4,0}, {4,-4}, {0,-4} };
-  static SDL_Point digit_7[] = { {0,-8}, {4,-8}, {4,0} };
-  static SDL_Point digit_8[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0,-8}, {0, -4}, {4, -4} };
-  static SDL_Point digit_9[] = { {4, 0}, {4,-8}, {0,-8}, {0, -4}, {4, -4} };
+  static constexpr SDL_Point digit_0[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0, -8} };
+  static constexpr SDL_Point digit_1[] = { {4,0}, {4,-8} };
+  static constexpr SDL_Point digit_2[] = { {0,-8}, {4,-8}, {4,-4}, {0,-4}, {0,0}, {4,0}  };
+  static constexpr SDL_Point digit_3[] = { {0,0}, {4, 0}, {4,-4}, {0,-4}, {4,-4}, {4, -8}, {0, -8}  };
+  static constexpr SDL_Point digit_4[] = { {4,0}, {4,-8}, {4,-4}, {0,-4}, {0,-8}  };
+  static constexpr SDL_Point digit_5[] = { {0,0}, {4,0}, {4,-4}, {0,-4}, {0,-8}, {4, -8}  };
+  static constexpr SDL_Point digit_6[] = { {0,-8}, {0,0}, {4,0}, {4,-4}, {0,-4} };
+  static constexpr SDL_Point digit_7[] = { {0,-8}, {4,-8}, {4,0} };
+  static constexpr SDL_Point digit_8[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0,-8}, {0, -4}, {4, -4} };
+  static constexpr SDL_Point digit_9[] = { {4, 0}, {4,-8}, {0,-8}, {0, -4}, {4, -4} };
   
-  static size_t sizes[] = { std::span{digit_0}.size(), 
+  static constexpr size_t sizes[] = { std::span{digit_0}.size(), 
                             std::span{digit_1}.size(), 
                             std::span{digit_2}.size(), 
                             std::span{digit_3}.size(), 
@@ -188,7 +163,7 @@ void SDL2Renderer::renderScore() {
                             std::span{digit_7}.size(), 
                             std::span{digit_8}.size(), 
                             std::span{digit_9}.size() };
-  static SDL_Point * digits[] = {digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9 };
+  static constexpr const SDL_Point * digits[] = {digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9 };
 
   std::array<SDL_Point, 7> points;
   long long score = game.get_score();
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <iostream>
+#include <span>
 #include "physics.h"
 #include "game.h"
 #include "renderer.h"
@@ -17,6 +18,13 @@ class SDL2Renderer : public Renderer {
   SDL_Window * window = nullptr;
   SDL_Surface * screenSurface = nullptr;
   SDL_Renderer * renderer = nullptr;
+  float interpolation = 1.0f;
+
+  // returns the position of body to display, interpolated between its last two ticks
+  Vector2df get_position(const Body2df * body) const;
+
+  // draws the lines connecting the given outline points, each point transformed by transformation
+  void renderOutline(const Matrix2x3df & transformation, std::span<const Vector2df> outline);
 
   // render methods for the specific game objects, score, and free ships
   void renderSpaceship(Vector2df position, float angle);
@@ -35,6 +43,9 @@ public:
   virtual bool init();
   
   virtual void render();
+
+  // sets the fraction of a tick between the last two ticks at which render() displays the bodies
+  void set_interpolation(float alpha);
   
   virtual void exit(); 
   
@@ -0,0 +1,78 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "snapshot.h"
+
+// refers to a value of a SlotMap. A handle stays valid while other values are inserted or erased
+// and becomes stale when its own value is erased, also if the slot is used again for a new value
+struct SlotHandle {
+  uint32_t slot = std::numeric_limits<uint32_t>::max();
+  uint32_t generation = 0;
+
+  bool operator==(const SlotHandle & handle) const = default;
+};
+
+// a registry of values with O(1) insert, erase and lookup by handle: the values are kept in one
+// dense vector (in no particular order after an erase), the slots map the handles to their index.
+// Erasing moves the last value into the erased place and increments the generation of the erased
+// slot, so its old handles become stale. The free slots are reused in last in, first out order.
+template<class T>
+class SlotMap {
+  struct Slot {
+    uint32_t index; // of the value, or of the next free slot if this slot is free
+    uint32_t generation = 1; // the generation of the handle to the value, 0 is never used
+  };
+  static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+  std::vector<T> values;
+  std::vector<uint32_t> value_slots; // the slot of each value
+  std::vector<Slot> slots;
+  uint32_t free_slot = NO_SLOT; // the first free slot, the free slots are linked by their index
+public:
+  static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  // appends value to the values and returns its handle
+  SlotHandle insert(T value);
+
+  // returns the index of the value of handle in get_values(), NONE if handle is stale
+  size_t get_index(SlotHandle handle) const;
+
+  bool contains(SlotHandle handle) const;
+
+  // returns the value of handle, nullptr if handle is stale
+  T * find(SlotHandle handle);
+
+  SlotHandle get_handle(size_t index) const;
+
+  // erases the value of handle if it is not stale
+  void erase(SlotHandle handle);
+
+  // erases the value at index, the last value takes its place
+  void erase_at(size_t index);
+
+  // erases all values for which predicate(value) returns true. The values are tested backwards,
+  // so each value moved into an erased place was already tested
+  template<class PREDICATE>
+  void erase_if(PREDICATE predicate);
+
+  // the values, which may be changed in place
+  const std::vector<T> & get_values() const;
+  std::vector<T> & get_values();
+
+  size_t size() const;
+
+  // writes the values as the numbers get_id(value) returns and the slots to snapshot, restore()
+  // reads them back with the values get_value(id) returns. The handles stay valid
+  template<class GET_ID>
+  void save(Snapshot & snapshot, GET_ID get_id) const;
+
+  template<class GET_VALUE>
+  void restore(Snapshot & snapshot, GET_VALUE get_value);
+};
+
+#endif
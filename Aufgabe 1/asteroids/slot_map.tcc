@@ -0,0 +1,126 @@
+#include <utility>
+
+template<class T>
+SlotHandle SlotMap<T>::insert(T value) {
+  uint32_t slot = free_slot;
+  if (slot == NO_SLOT) {
+    slot = static_cast<uint32_t>(slots.size());
+    slots.push_back( Slot{} );
+  } else {
+    free_slot = slots[slot].index;
+  }
+  slots[slot].index = static_cast<uint32_t>(values.size());
+  values.push_back(value);
+  value_slots.push_back(slot);
+  return SlotHandle{slot, slots[slot].generation};
+}
+
+template<class T>
+size_t SlotMap<T>::get_index(SlotHandle handle) const {
+  if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation) {
+    return NONE;
+  }
+  // a free slot has the generation of its next handle, which a handle given out after a save()
+  // may already have when the map is restored
+  const uint32_t index = slots[handle.slot].index;
+  if (index >= values.size() || value_slots[index] != handle.slot) {
+    return NONE;
+  }
+  return index;
+}
+
+template<class T>
+bool SlotMap<T>::contains(SlotHandle handle) const {
+  return get_index(handle) != NONE;
+}
+
+template<class T>
+T * SlotMap<T>::find(SlotHandle handle) {
+  size_t index = get_index(handle);
+  return index == NONE ? nullptr : &values[index];
+}
+
+template<class T>
+SlotHandle SlotMap<T>::get_handle(size_t index) const {
+  return SlotHandle{value_slots[index], slots[value_slots[index]].generation};
+}
+
+template<class T>
+void SlotMap<T>::erase(SlotHandle handle) {
+  size_t index = get_index(handle);
+  if (index != NONE) {
+    erase_at(index);
+  }
+}
+
+template<class T>
+void SlotMap<T>::erase_at(size_t index) {
+  const uint32_t slot = value_slots[index];
+  const size_t last = values.size() - 1;
+  if (index != last) {
+    values[index] = std::move(values[last]);
+    value_slots[index] = value_slots[last];
+    slots[value_slots[index]].index = static_cast<uint32_t>(index);
+  }
+  values.pop_back();
+  value_slots.pop_back();
+  // a new generation makes the handles to the erased value stale, 0 is skipped after an overflow
+  if (++slots[slot].generation == 0) {
+    slots[slot].generation = 1;
+  }
+  slots[slot].index = free_slot;
+  free_slot = slot;
+}
+
+template<class T>
+template<class PREDICATE>
+void SlotMap<T>::erase_if(PREDICATE predicate) {
+  for (size_t index = values.size(); index > 0; index--) {
+    if (predicate(values[index - 1])) {
+      erase_at(index - 1);
+    }
+  }
+}
+
+template<class T>
+const std::vector<T> & SlotMap<T>::get_values() const {
+  return values;
+}
+
+template<class T>
+std::vector<T> & SlotMap<T>::get_values() {
+  return values;
+}
+
+template<class T>
+size_t SlotMap<T>::size() const {
+  return values.size();
+}
+
+template<class T>
+template<class GET_ID>
+void SlotMap<T>::save(Snapshot & snapshot, GET_ID get_id) const {
+  snapshot.write(values.size());
+  for (const T & value : values) {
+    snapshot.write( static_cast<size_t>(get_id(value)) );
+  }
+  snapshot.write(value_slots);
+  snapshot.write(slots);
+  snapshot.write(free_slot);
+}
+
+template<class T>
+template<class GET_VALUE>
+void SlotMap<T>::restore(Snapshot & snapshot, GET_VALUE get_value) {
+  size_t size;
+  snapshot.read(size);
+  values.clear();
+  for (size_t index = 0; index < size; index++) {
+    size_t id;
+    snapshot.read(id);
+    values.push_back( get_value(id) );
+  }
+  snapshot.read(value_slots);
+  snapshot.read(slots);
+  snapshot.read(free_slot);
+}
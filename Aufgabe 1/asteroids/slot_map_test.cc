@@ -0,0 +1,91 @@
+#include "slot_map.h"
+#include "slot_map.tcc"
+#include "gtest/gtest.h"
+#include <string>
+
+
+namespace {
+
+TEST(SLOT_MAP, InsertAndFind) {
+  SlotMap<std::string> map;
+  SlotHandle a = map.insert("a");
+  SlotHandle b = map.insert("b");
+
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ("a", *map.find(a));
+  EXPECT_EQ("b", *map.find(b));
+  EXPECT_EQ(1u, map.get_index(b));
+  EXPECT_EQ(b, map.get_handle(1));
+  EXPECT_FALSE( map.contains(SlotHandle()) );
+  EXPECT_EQ(nullptr, map.find(SlotHandle()));
+}
+
+TEST(SLOT_MAP, EraseMovesLastValue) {
+  SlotMap<std::string> map;
+  SlotHandle a = map.insert("a");
+  SlotHandle b = map.insert("b");
+  SlotHandle c = map.insert("c");
+  map.erase(a);
+
+  EXPECT_EQ(std::vector<std::string>({"c", "b"}), map.get_values());
+  EXPECT_FALSE( map.contains(a) );
+  EXPECT_EQ("b", *map.find(b));
+  EXPECT_EQ("c", *map.find(c));
+  EXPECT_EQ(0u, map.get_index(c));
+  map.erase(a); // stale handles are ignored
+  EXPECT_EQ(2u, map.size());
+}
+
+TEST(SLOT_MAP, ReusedSlotsHaveNewGeneration) {
+  SlotMap<int> map;
+  SlotHandle first = map.insert(1);
+  map.erase(first);
+  SlotHandle second = map.insert(2);
+
+  EXPECT_EQ(first.slot, second.slot);
+  EXPECT_NE(first.generation, second.generation);
+  EXPECT_FALSE( map.contains(first) );
+  EXPECT_EQ(2, *map.find(second));
+}
+
+TEST(SLOT_MAP, EraseIf) {
+  SlotMap<int> map;
+  std::vector<SlotHandle> handles;
+  for (int i = 0; i < 10; i++) {
+    handles.push_back( map.insert(i) );
+  }
+  map.erase_if([](int value) { return value % 3 == 0; });
+
+  EXPECT_EQ(6u, map.size());
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(i % 3 != 0, map.contains(handles[i]));
+    if (i % 3 != 0) {
+      EXPECT_EQ(i, *map.find(handles[i]));
+      EXPECT_EQ(handles[i], map.get_handle(map.get_index(handles[i])));
+    }
+  }
+}
+
+TEST(SLOT_MAP, SaveAndRestore) {
+  std::vector<std::string> names = {"a", "b", "c"};
+  SlotMap<std::string *> map;
+  SlotHandle a = map.insert(&names[0]);
+  SlotHandle b = map.insert(&names[1]);
+  map.erase(a);
+  Snapshot snapshot;
+  map.save(snapshot, [&](std::string * name) { return name - names.data(); });
+
+  SlotHandle c = map.insert(&names[2]);
+  map.erase(b);
+  snapshot.rewind();
+  map.restore(snapshot, [&](size_t id) { return &names[id]; });
+
+  EXPECT_EQ(1u, map.size());
+  EXPECT_FALSE( map.contains(a) );
+  EXPECT_FALSE( map.contains(c) );
+  EXPECT_EQ(&names[1], *map.find(b));
+  // the free slot of a is used again
+  EXPECT_EQ(a.slot, map.insert(&names[0]).slot);
+}
+
+}
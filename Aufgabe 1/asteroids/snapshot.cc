@@ -0,0 +1,40 @@
+#include "snapshot.h"
+#include <cassert>
+#include <cstring>
+
+Snapshot::Snapshot(size_t capacity) {
+  bytes.reserve(capacity);
+}
+
+void Snapshot::clear() {
+  bytes.clear();
+  read_position = 0;
+}
+
+void Snapshot::rewind() {
+  read_position = 0;
+}
+
+size_t Snapshot::size() const {
+  return bytes.size();
+}
+
+const std::byte * Snapshot::data() const {
+  return bytes.data();
+}
+
+void Snapshot::write_bytes(const void * source, size_t count) {
+  const size_t position = bytes.size();
+  bytes.resize(position + count);
+  if (count > 0) {
+    std::memcpy(bytes.data() + position, source, count);
+  }
+}
+
+void Snapshot::read_bytes(void * destination, size_t count) {
+  assert(read_position + count <= bytes.size());
+  if (count > 0) {
+    std::memcpy(destination, bytes.data() + read_position, count);
+  }
+  read_position += count;
+}
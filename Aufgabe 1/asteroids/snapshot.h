@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// a flat buffer of bytes holding the state of a simulation, e.g. to roll a game back and simulate
+// it again or to seek in a replay. The values are copied bytewise by write() and read back in the
+// same order by read(), so only trivially copyable values can be stored. Pointers are stored as
+// numbers the owner of the objects maps back (see Physics::save), and callbacks are not stored at
+// all: they belong to the objects, which keep their own when they are restored.
+class Snapshot {
+  std::vector<std::byte> bytes;
+  size_t read_position = 0;
+public:
+  // reserves capacity bytes, so writing a snapshot of up to this size doesn't allocate memory
+  explicit Snapshot(size_t capacity = 0);
+
+  // empties the snapshot for writing a new state, its memory is kept
+  void clear();
+
+  // starts reading at the first value again
+  void rewind();
+
+  size_t size() const;
+
+  const std::byte * data() const;
+
+  void write_bytes(const void * source, size_t count);
+
+  // reads the next count bytes, which must have been written
+  void read_bytes(void * destination, size_t count);
+
+  template<class T>
+  void write(const T & value);
+
+  template<class T>
+  void read(T & value);
+
+  // the number of values followed by the values
+  template<class T>
+  void write(const std::vector<T> & values);
+
+  template<class T>
+  void read(std::vector<T> & values);
+};
+
+
+template<class T>
+void Snapshot::write(const T & value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  write_bytes(&value, sizeof(T));
+}
+
+template<class T>
+void Snapshot::read(T & value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  read_bytes(&value, sizeof(T));
+}
+
+template<class T>
+void Snapshot::write(const std::vector<T> & values) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  write(values.size());
+  write_bytes(values.data(), values.size() * sizeof(T));
+}
+
+template<class T>
+void Snapshot::read(std::vector<T> & values) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  size_t size;
+  read(size);
+  values.resize(size);
+  read_bytes(values.data(), size * sizeof(T));
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include "snapshot.h"
+#include "gtest/gtest.h"
+
+
+namespace {
+
+TEST(SNAPSHOT, WriteAndRead) {
+  Snapshot snapshot(64);
+  snapshot.write(3.5f);
+  snapshot.write(std::vector<short>{1, 2, 3});
+  snapshot.write(true);
+  EXPECT_EQ(sizeof(float) + sizeof(size_t) + 3 * sizeof(short) + sizeof(bool), snapshot.size());
+
+  float number = 0.0f;
+  std::vector<short> values;
+  bool flag = false;
+  snapshot.read(number);
+  snapshot.read(values);
+  snapshot.read(flag);
+  EXPECT_EQ(3.5f, number);
+  EXPECT_EQ(std::vector<short>({1, 2, 3}), values);
+  EXPECT_TRUE(flag);
+
+  // reading again from the start, and writing again after clear
+  snapshot.rewind();
+  snapshot.read(number);
+  EXPECT_EQ(3.5f, number);
+  snapshot.clear();
+  EXPECT_EQ(0u, snapshot.size());
+  snapshot.write(7);
+  int integer = 0;
+  snapshot.read(integer);
+  EXPECT_EQ(7, integer);
+}
+
+}
@@ -0,0 +1,74 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  for (size_t i = 1; i < thread_count; i++) {
+    workers.emplace_back( [this]() { work(); } );
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  job_started.notify_all();
+  for (std::thread & worker : workers) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::get_thread_count() const {
+  return workers.size() + 1;
+}
+
+void ThreadPool::work() {
+  size_t finished_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_started.wait(lock, [&]() { return stopping || generation != finished_generation; });
+      if (stopping) {
+        return;
+      }
+      finished_generation = generation;
+    }
+    run_tasks();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      busy_workers--;
+    }
+    job_finished.notify_one();
+  }
+}
+
+void ThreadPool::run_tasks() {
+  for (size_t i = next_task++; i < task_count; i = next_task++) {
+    (*task)(i);
+  }
+}
+
+void ThreadPool::run(size_t task_count, const std::function<void(size_t)> & task) {
+  if (workers.empty() || task_count <= 1) {
+    for (size_t i = 0; i < task_count; i++) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = &task;
+    this->task_count = task_count;
+    next_task = 0;
+    busy_workers = workers.size();
+    generation++;
+  }
+  job_started.notify_all();
+  run_tasks();
+  std::unique_lock<std::mutex> lock(mutex);
+  job_finished.wait(lock, [&]() { return busy_workers == 0; });
+  this->task = nullptr;
+}
+
+std::pair<size_t, size_t> ThreadPool::get_range(size_t part, size_t part_count, size_t size) {
+  return { size * part / part_count, size * (part + 1) / part_count };
+}
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// a fixed set of worker threads which run the tasks 0, ..., task_count - 1 of one job at a time.
+// The tasks are taken in order by the next free thread, so the thread running a task is not
+// known: results stay deterministic if each task writes only its own part of the output, e.g. its
+// own buffer, and the parts are combined in the order of the tasks after run() returned.
+class ThreadPool {
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable job_started, job_finished;
+
+  // the current job, set by run(). Each new job increments generation
+  const std::function<void(size_t)> * task = nullptr;
+  size_t task_count = 0;
+  std::atomic<size_t> next_task = 0;
+  size_t generation = 0;
+  size_t busy_workers = 0;
+  bool stopping = false;
+
+  // the loop of each worker, which waits for the next job
+  void work();
+
+  // runs tasks of the current job until none are left
+  void run_tasks();
+public:
+  // thread_count includes the thread calling run(), so thread_count - 1 workers are started
+  explicit ThreadPool(size_t thread_count);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  size_t get_thread_count() const;
+
+  // runs task(0), ..., task(task_count - 1) on all threads including the calling one and returns
+  // after all tasks are finished. The tasks must not throw and must not call run() themselves
+  void run(size_t task_count, const std::function<void(size_t)> & task);
+
+  // returns the range [begin, end) of the part-th of part_count nearly equal parts of [0, size)
+  static std::pair<size_t, size_t> get_range(size_t part, size_t part_count, size_t size);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "thread_pool.h"
+#include "gtest/gtest.h"
+#include <numeric>
+
+
+namespace {
+
+TEST(THREAD_POOL, RunsEachTaskOnce) {
+  for (size_t thread_count : {1u, 2u, 5u}) {
+    ThreadPool thread_pool(thread_count);
+    EXPECT_EQ(thread_count, thread_pool.get_thread_count());
+    for (size_t task_count : {0u, 1u, 3u, 100u}) {
+      std::vector<int> runs(task_count, 0);
+      thread_pool.run(task_count, [&](size_t task) { runs[task]++; });
+      EXPECT_EQ(std::vector<int>(task_count, 1), runs);
+    }
+  }
+}
+
+TEST(THREAD_POOL, RunsManyJobs) {
+  ThreadPool thread_pool(4);
+  std::vector<long> sums(16);
+  for (long job = 0; job < 1000; job++) {
+    thread_pool.run(sums.size(), [&](size_t task) { sums[task] += job; });
+  }
+  EXPECT_EQ(std::vector<long>(sums.size(), 999 * 1000 / 2), sums);
+}
+
+TEST(THREAD_POOL, GetRange) {
+  size_t expected_begin = 0;
+  for (size_t part = 0; part < 7; part++) {
+    auto [begin, end] = ThreadPool::get_range(part, 7, 100);
+    EXPECT_EQ(expected_begin, begin);
+    EXPECT_LE(14u, end - begin);
+    EXPECT_GE(15u, end - begin);
+    expected_begin = end;
+  }
+  EXPECT_EQ(100u, expected_begin);
+  auto [begin, end] = ThreadPool::get_range(2, 4, 2);
+  EXPECT_EQ(begin, end);
+}
+
+}
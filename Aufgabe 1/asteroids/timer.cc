@@ -1,4 +1,5 @@
 #include "timer.h"
+#include <algorithm>
 #include <thread>
 #include <iostream>
 
@@ -38,7 +39,9 @@ void Timer::reset() {
 void Timer::tick_and_delay(float tick_time) {
   end = SDL_GetTicks64();
   Uint64 elapse = end - start;
-  SDL_Delay(abs(1000.0f * tick_time - elapse));
+  if (elapse < 1000.0f * tick_time) { // no delay after an overrun
+    SDL_Delay(1000.0f * tick_time - elapse);
+  }
   tick(tick_time);
 }
 
@@ -46,3 +49,55 @@ void Timer::tick_and_delay(float tick_time) {
 void Timer::tick(float tick_time) {
   time += tick_time;
 }
+
+
+FixedTimestep::FixedTimestep(float step, size_t max_steps) : step(step), max_steps(max_steps) { }
+
+float FixedTimestep::get_step() const {
+  return step;
+}
+
+size_t FixedTimestep::advance(float frame_time) {
+  accumulator += frame_time;
+  size_t steps = static_cast<size_t>(accumulator / step);
+  if (steps > max_steps) {
+    steps = max_steps;
+    accumulator = 0.0f;
+  } else {
+    accumulator -= steps * step;
+  }
+  accumulator = std::max(accumulator, 0.0f); // rounding
+  return steps;
+}
+
+float FixedTimestep::get_alpha() const {
+  return std::min(accumulator / step, 1.0f);
+}
+
+
+FramePacer::FramePacer(float frame_time, float spin_time)
+  : frame_duration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(frame_time))),
+    spin_duration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(spin_time))) {
+  frame_end = frame_start + frame_duration;
+}
+
+float FramePacer::get_frame_time() const {
+  return std::chrono::duration<float>(frame_duration).count();
+}
+
+float FramePacer::wait_for_next_frame() {
+  Clock::time_point now = Clock::now();
+  if (now < frame_end - spin_duration) {
+    std::this_thread::sleep_until(frame_end - spin_duration);
+  }
+  while ((now = Clock::now()) < frame_end) {
+    std::this_thread::yield();
+  }
+  float elapsed = std::chrono::duration<float>(now - frame_start).count();
+  frame_start = now;
+  frame_end += frame_duration;
+  if (frame_end < now) {
+    frame_end = now + frame_duration;
+  }
+  return elapsed;
+}
@@ -1,6 +1,8 @@
 #ifndef TIMER_H
 #define TIMER_H
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <SDL2/SDL.h>
 
@@ -36,4 +38,44 @@ public:
   void reset();
 };
 
+// decouples the simulation from the frame rate: the game is ticked with a fixed time step, as
+// often as the time of the rendered frames adds up to whole steps. The remaining time is a fraction
+// of a step, by which the displayed bodies are interpolated (see Body::get_interpolated_position).
+// At most max_steps are taken per frame and the rest of a longer frame is dropped, so a simulation
+// slower than real time can't fall further behind with each frame (a "spiral of death")
+class FixedTimestep {
+  float step;
+  size_t max_steps;
+  float accumulator = 0.0f;
+public:
+  FixedTimestep(float step, size_t max_steps = 5);
+
+  float get_step() const;
+
+  // adds the time of a frame in seconds and returns the number of steps to simulate
+  size_t advance(float frame_time);
+
+  // returns the fraction of a step between the last simulated step and now, in [0, 1)
+  float get_alpha() const;
+};
+
+// paces frames to a fixed frame time with std::chrono::steady_clock: wait_for_next_frame()
+// sleeps until spin_time before the end of the frame and spins for the rest, as the sleep may
+// wake up late by about a millisecond. An overrunning frame doesn't wait at all, and if it overran
+// by more than a frame, the following frames are paced from now on instead of catching up
+class FramePacer {
+  using Clock = std::chrono::steady_clock;
+  Clock::duration frame_duration;
+  Clock::duration spin_duration;
+  Clock::time_point frame_start = Clock::now();
+  Clock::time_point frame_end = frame_start;
+public:
+  FramePacer(float frame_time, float spin_time = 0.002f);
+
+  float get_frame_time() const;
+
+  // waits for the end of the current frame and returns the time in seconds since the last call
+  float wait_for_next_frame();
+};
+
 #endif
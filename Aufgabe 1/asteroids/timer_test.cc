@@ -0,0 +1,37 @@
+#include "timer.h"
+#include "gtest/gtest.h"
+
+
+namespace {
+
+TEST(FIXED_TIMESTEP, AdvanceTakesWholeSteps) {
+  FixedTimestep timestep(0.01f);
+  EXPECT_EQ(0u, timestep.advance(0.004f));
+  EXPECT_NEAR(0.4, timestep.get_alpha(), 0.0001);
+  EXPECT_EQ(1u, timestep.advance(0.007f));
+  EXPECT_NEAR(0.1, timestep.get_alpha(), 0.0001);
+  EXPECT_EQ(3u, timestep.advance(0.0295f));
+  EXPECT_NEAR(0.05, timestep.get_alpha(), 0.001);
+}
+
+// a frame much longer than a step doesn't let the simulation fall behind
+TEST(FIXED_TIMESTEP, AdvanceLimitsSteps) {
+  FixedTimestep timestep(0.01f, 4);
+  EXPECT_EQ(4u, timestep.advance(1.0f));
+  EXPECT_NEAR(0.0, timestep.get_alpha(), 0.0001);
+  EXPECT_EQ(1u, timestep.advance(0.01f));
+}
+
+TEST(FRAME_PACER, WaitsForTheFrameTime) {
+  FramePacer pacer(0.005f, 0.001f);
+  EXPECT_NEAR(0.005, pacer.get_frame_time(), 0.00001);
+  float total = 0.0f;
+  for (int frame = 0; frame < 10; frame++) {
+    total += pacer.wait_for_next_frame();
+  }
+  // the frames keep to their schedule, a late frame shortens the next one (with some slack for a busy machine)
+  EXPECT_LE(0.049f, total);
+  EXPECT_GT(0.1f, total);
+}
+
+}
@@ -0,0 +1,9 @@
+#include "vector_array.h"
+#include "vector_array.tcc"
+
+// contains template instantiations for the 2-, 3- and 4-dimensional cases
+//   to create pre-compiled object files
+
+template class VectorArray<float, 2u>;
+template class VectorArray<float, 3u>;
+template class VectorArray<float, 4u>;
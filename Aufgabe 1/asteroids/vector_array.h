@@ -0,0 +1,81 @@
+#ifndef VECTOR_ARRAY_H
+#define VECTOR_ARRAY_H
+
+#include "math.h"
+#include <vector>
+
+// A structure of arrays of Vectors: component i of all Vectors is stored contiguously,
+// so the bulk operations below process consecutive values of one component with the same
+// instruction. The compiler vectorizes these loops, the reductions (minimum, maximum) and
+// normalize use SSE explicitly for float.
+//
+// Use it instead of a std::vector<Vector> where the same operation is applied to many
+// Vectors, e.g. moving all positions by seconds * velocity:
+//   positions.axpy(seconds, velocities);
+template<class FLOAT_TYPE, size_t N>
+class VectorArray {
+  static_assert(N > 0u); // no zero length vectors allowed
+
+  // components[i][j] is the i-th component of the j-th Vector
+  std::array<std::vector<FLOAT_TYPE>, N> components;
+
+public:
+  // creates size Vectors with all components 0
+  explicit VectorArray(size_t size = 0);
+
+  // creates a VectorArray with the given Vectors
+  VectorArray(std::span<const Vector<FLOAT_TYPE, N>> vectors);
+
+  // returns the number of Vectors
+  size_t size() const;
+
+  // changes the number of Vectors, new Vectors have all components 0
+  void resize(size_t size);
+
+  // appends the given Vector
+  void push_back(Vector<FLOAT_TYPE, N> value);
+
+  // returns the i-th Vector
+  Vector<FLOAT_TYPE, N> operator[](size_t i) const;
+
+  // replaces the i-th Vector by value
+  void set(size_t i, Vector<FLOAT_TYPE, N> value);
+
+  // returns the values of the given component (axis) of all Vectors
+  std::span<FLOAT_TYPE> component(size_t axis);
+
+  // returns the values of the given component (axis) of all Vectors
+  std::span<const FLOAT_TYPE> component(size_t axis) const;
+
+  // adds factor * x[i] to the i-th Vector of this array for all i (a x plus y)
+  // x must have the same size as this array
+  void axpy(FLOAT_TYPE factor, const VectorArray & x);
+
+  // multiplies all Vectors by factor
+  void scale(FLOAT_TYPE factor);
+
+  // writes the scalar product of the i-th Vectors of this array and other to result[i]
+  // other and result must have (at least) the size of this array
+  void dot(const VectorArray & other, std::span<FLOAT_TYPE> result) const;
+
+  // writes the square of the length of the i-th Vector to result[i]
+  void square_of_lengths(std::span<FLOAT_TYPE> result) const;
+
+  // normalizes all Vectors to the length 1 (see Vector::normalize)
+  void normalize();
+
+  // returns the component-wise minimum of all Vectors, e.g. the lower corner of their bounding box
+  // the array must not be empty
+  Vector<FLOAT_TYPE, N> minimum() const;
+
+  // returns the component-wise maximum of all Vectors, e.g. the upper corner of their bounding box
+  // the array must not be empty
+  Vector<FLOAT_TYPE, N> maximum() const;
+};
+
+
+typedef VectorArray<float, 2u> VectorArray2df;
+typedef VectorArray<float, 3u> VectorArray3df;
+typedef VectorArray<float, 4u> VectorArray4df;
+
+#endif
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cassert>
+
+
+template <class FLOAT_TYPE, size_t N>
+VectorArray<FLOAT_TYPE, N>::VectorArray(size_t size) {
+  resize(size);
+}
+
+template <class FLOAT_TYPE, size_t N>
+VectorArray<FLOAT_TYPE, N>::VectorArray(std::span<const Vector<FLOAT_TYPE, N>> vectors) : VectorArray(vectors.size()) {
+  for (size_t j = 0; j < vectors.size(); j++) {
+    set(j, vectors[j]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+size_t VectorArray<FLOAT_TYPE, N>::size() const {
+  return components[0].size();
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::resize(size_t size) {
+  for (std::vector<FLOAT_TYPE> & component : components) {
+    component.resize(size, 0.0);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::push_back(Vector<FLOAT_TYPE, N> value) {
+  for (size_t i = 0; i < N; i++) {
+    components[i].push_back(value[i]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::operator[](size_t j) const {
+  Vector<FLOAT_TYPE, N> value;
+  for (size_t i = 0; i < N; i++) {
+    value[i] = components[i][j];
+  }
+  return value;
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::set(size_t j, Vector<FLOAT_TYPE, N> value) {
+  for (size_t i = 0; i < N; i++) {
+    components[i][j] = value[i];
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::component(size_t axis) {
+  return components[axis];
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<const FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::component(size_t axis) const {
+  return components[axis];
+}
+
+// the kernels below loop over raw pointers of one component at a time, so the compiler
+// needn't care about aliasing between the components and can vectorize each loop
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::axpy(FLOAT_TYPE factor, const VectorArray & x) {
+  assert(x.size() == size());
+  const size_t count = size();
+  for (size_t i = 0; i < N; i++) {
+    FLOAT_TYPE * __restrict y_i = components[i].data();
+    const FLOAT_TYPE * __restrict x_i = x.components[i].data();
+    for (size_t j = 0; j < count; j++) {
+      y_i[j] += factor * x_i[j];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::scale(FLOAT_TYPE factor) {
+  for (std::vector<FLOAT_TYPE> & component : components) {
+    for (FLOAT_TYPE & value : component) {
+      value *= factor;
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::dot(const VectorArray & other, std::span<FLOAT_TYPE> result) const {
+  assert(other.size() >= size() && result.size() >= size());
+  const size_t count = size();
+  FLOAT_TYPE * __restrict products = result.data();
+  std::fill_n(products, count, FLOAT_TYPE(0.0));
+  for (size_t i = 0; i < N; i++) {
+    const FLOAT_TYPE * __restrict a_i = components[i].data();
+    const FLOAT_TYPE * __restrict b_i = other.components[i].data();
+    for (size_t j = 0; j < count; j++) {
+      products[j] += a_i[j] * b_i[j];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::square_of_lengths(std::span<FLOAT_TYPE> result) const {
+  dot(*this, result);
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::normalize() {
+  const size_t count = size();
+  std::vector<FLOAT_TYPE> factors(count);
+  square_of_lengths(factors);
+  FLOAT_TYPE * __restrict factor = factors.data();
+  size_t j = 0;
+#if defined(__SSE__)
+  if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+    for (; j + 4 <= count; j += 4) {
+      __m128 square = _mm_loadu_ps(factor + j);
+      if constexpr (use_fast_approximations) {
+        __m128 estimate = _mm_rsqrt_ps(square); // one Newton step like fast_reciprocal_square_root
+        __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), square), _mm_mul_ps(estimate, estimate)));
+        _mm_storeu_ps(factor + j, _mm_mul_ps(estimate, correction));
+      } else {
+        _mm_storeu_ps(factor + j, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(square)));
+      }
+    }
+  }
+#endif
+  for (; j < count; j++) {
+    if constexpr (use_fast_approximations) {
+      factor[j] = fast_reciprocal_square_root(factor[j]);
+    } else {
+      factor[j] = 1 / square_root(factor[j]);
+    }
+  }
+  for (size_t i = 0; i < N; i++) {
+    FLOAT_TYPE * __restrict values = components[i].data();
+    for (size_t k = 0; k < count; k++) {
+      values[k] *= factor[k];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::minimum() const {
+  assert(size() > 0);
+  Vector<FLOAT_TYPE, N> minimum;
+  for (size_t i = 0; i < N; i++) {
+    const FLOAT_TYPE * values = components[i].data();
+    const size_t count = size();
+    FLOAT_TYPE result = values[0];
+    size_t j = 0;
+#if defined(__SSE__)
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      if (count >= 4) {
+        __m128 lanes = _mm_loadu_ps(values);
+        for (j = 4; j + 4 <= count; j += 4) {
+          lanes = _mm_min_ps(lanes, _mm_loadu_ps(values + j));
+        }
+        alignas(16) float reduced[4];
+        _mm_store_ps(reduced, lanes);
+        result = std::min({reduced[0], reduced[1], reduced[2], reduced[3]});
+      }
+    }
+#endif
+    for (; j < count; j++) {
+      result = std::min(result, values[j]);
+    }
+    minimum[i] = result;
+  }
+  return minimum;
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::maximum() const {
+  assert(size() > 0);
+  Vector<FLOAT_TYPE, N> maximum;
+  for (size_t i = 0; i < N; i++) {
+    const FLOAT_TYPE * values = components[i].data();
+    const size_t count = size();
+    FLOAT_TYPE result = values[0];
+    size_t j = 0;
+#if defined(__SSE__)
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      if (count >= 4) {
+        __m128 lanes = _mm_loadu_ps(values);
+        for (j = 4; j + 4 <= count; j += 4) {
+          lanes = _mm_max_ps(lanes, _mm_loadu_ps(values + j));
+        }
+        alignas(16) float reduced[4];
+        _mm_store_ps(reduced, lanes);
+        result = std::max({reduced[0], reduced[1], reduced[2], reduced[3]});
+      }
+    }
+#endif
+    for (; j < count; j++) {
+      result = std::max(result, values[j]);
+    }
+    maximum[i] = result;
+  }
+  return maximum;
+}
@@ -0,0 +1,68 @@
+#include "vector_array.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(VECTOR_ARRAY, SetAndGet3df) {
+  VectorArray3df array(5);
+  array.set(3, {1.0, 2.0, 3.0});
+  array.push_back({4.0, 5.0, 6.0});
+
+  EXPECT_EQ(6u, array.size());
+  EXPECT_NEAR(0.0, array[0][1], 0.00001);
+  EXPECT_NEAR(2.0, array[3][1], 0.00001);
+  EXPECT_NEAR(6.0, array[5][2], 0.00001);
+  EXPECT_NEAR(4.0, array.component(0)[5], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, AxpyAndScale2df) {
+  std::vector<Vector2df> positions = { {0.0, 0.0}, {1.0, 2.0}, {-3.0, 4.0}, {5.0, 5.0}, {1.0, -1.0} };
+  std::vector<Vector2df> velocities = { {1.0, 0.0}, {0.0, 1.0}, {2.0, 2.0}, {-1.0, -2.0}, {0.5, 0.5} };
+  VectorArray2df position_array(positions);
+  VectorArray2df velocity_array(velocities);
+  position_array.axpy(2.0f, velocity_array);
+  position_array.scale(0.5f);
+
+  for (size_t j = 0; j < positions.size(); j++) {
+    Vector2df expected = 0.5f * (positions[j] + 2.0f * velocities[j]);
+    EXPECT_NEAR(expected[0], position_array[j][0], 0.00001);
+    EXPECT_NEAR(expected[1], position_array[j][1], 0.00001);
+  }
+}
+
+TEST(VECTOR_ARRAY, DotAndNormalize3df) {
+  VectorArray3df array;
+  for (int j = 0; j < 11; j++) {
+    array.push_back({1.0f + j, 2.0f, -0.5f * j});
+  }
+  std::vector<float> squares(array.size());
+  array.square_of_lengths(squares);
+  array.normalize();
+
+  for (size_t j = 0; j < array.size(); j++) {
+    Vector3df expected = {1.0f + j, 2.0f, -0.5f * j};
+    EXPECT_NEAR(expected.square_of_length(), squares[j], 0.0001);
+    expected.normalize();
+    for (size_t i = 0; i < 3; i++) {
+      EXPECT_NEAR(expected[i], array[j][i], 0.00001);
+    }
+  }
+}
+
+TEST(VECTOR_ARRAY, MinimumMaximum3df) {
+  VectorArray3df array;
+  for (int j = 0; j < 13; j++) {
+    array.push_back({static_cast<float>(j % 5), -1.0f * j, 3.0f});
+  }
+  Vector3df minimum = array.minimum();
+  Vector3df maximum = array.maximum();
+
+  EXPECT_NEAR(0.0, minimum[0], 0.00001);
+  EXPECT_NEAR(-12.0, minimum[1], 0.00001);
+  EXPECT_NEAR(3.0, minimum[2], 0.00001);
+  EXPECT_NEAR(4.0, maximum[0], 0.00001);
+  EXPECT_NEAR(0.0, maximum[1], 0.00001);
+  EXPECT_NEAR(3.0, maximum[2], 0.00001);
+}
+
+}
@@ -0,0 +1,9 @@
+#include "acceleration.h"
+#include "acceleration.tcc"
+
+// contains template instantiations for triangle meshes
+
+template class PrimitiveList<float, 3u, Triangle3df>;
+template class KdTree<float, 3u, Triangle3df>;
+
+template std::unique_ptr<AccelerationStructure<float, 3u, Triangle3df>> make_acceleration_structure<float, 3u, Triangle3df>(AccelerationStructureType type, std::vector<Triangle3df> primitives);
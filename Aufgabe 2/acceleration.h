@@ -0,0 +1,101 @@
+#ifndef ACCELERATION_H
+#define ACCELERATION_H
+
+#include "geometry.h"
+#include <memory>
+#include <vector>
+
+// contains acceleration structures answering ray queries against many primitives
+//
+// a PRIMITIVE must provide (like Sphere, Plane, Box and Triangle do):
+//   FLOAT intersects(const Ray<FLOAT, N> &ray) const; // t > 0 or 0 if no intersection
+//   bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+//   AxisAlignedBoundingBox<FLOAT, N> get_bounding_box() const;
+
+
+// the query interface common to all acceleration structures
+template <class FLOAT, size_t N, class PRIMITIVE>
+class AccelerationStructure {
+public:
+  virtual ~AccelerationStructure() = default;
+
+  // returns the primitive with the nearest intersection (smallest t > 0) or nullptr if
+  // no primitive is hit, context is set to the context of the nearest intersection
+  virtual const PRIMITIVE * closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const = 0;
+
+  // returns true iff any primitive intersects the ray with 0 < t < t_max
+  // e.g. t_max = 1 for shadow rays pointing from a surface to a light source
+  virtual bool any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const = 0;
+};
+
+
+// no acceleration at all, every query tests every primitive
+template <class FLOAT, size_t N, class PRIMITIVE>
+class PrimitiveList : public AccelerationStructure<FLOAT, N, PRIMITIVE> {
+  std::vector<PRIMITIVE> primitives;
+public:
+  PrimitiveList(std::vector<PRIMITIVE> primitives);
+
+  const PRIMITIVE * closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const override;
+
+  bool any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const override;
+};
+
+
+// a k-d tree built with the surface area heuristic (SAH)
+// each inner node splits its box with an axis aligned plane, primitives overlapping
+// the plane are referenced by both children, so the leaves never overlap and
+// traversal can stop at the first leaf containing a hit
+// unbounded primitives (e.g. Plane) are kept in a separate list that is always tested
+template <class FLOAT, size_t N, class PRIMITIVE>
+class KdTree : public AccelerationStructure<FLOAT, N, PRIMITIVE> {
+  // costs of traversing an inner node and of an intersection test, relative to each other
+  static constexpr FLOAT TRAVERSAL_COST = 1.0;
+  static constexpr FLOAT INTERSECTION_COST = 1.5;
+  // SAH cost factor for splits that cut off empty space
+  static constexpr FLOAT EMPTY_BONUS = 0.8;
+
+  struct Node {
+    FLOAT split;          // position of the split plane
+    unsigned axis;        // split axis, N for leaves
+    unsigned index;       // inner node: index of the second child (the first child directly follows)
+                          // leaf: offset of its primitives in leaf_primitives
+    unsigned count;       // number of primitives of a leaf
+  };
+
+  std::vector<PRIMITIVE> primitives;
+  std::vector<Node> nodes;
+  std::vector<unsigned> leaf_primitives;
+  std::vector<unsigned> unbounded;
+  std::vector<AxisAlignedBoundingBox<FLOAT, N>> bounds; // bounding box of each primitive
+  Vector<FLOAT, N> lower, upper;                          // bounds of the tree
+
+  void build(const std::vector<unsigned> & indices, Vector<FLOAT, N> node_lower, Vector<FLOAT, N> node_upper, unsigned depth);
+
+  // returns the parametric interval [t_near, t_far] of the ray inside the bounds of the tree
+  bool clip(const Ray<FLOAT, N> &ray, FLOAT & t_near, FLOAT & t_far) const;
+
+public:
+  KdTree(std::vector<PRIMITIVE> primitives);
+
+  const PRIMITIVE * closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const override;
+
+  bool any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const override;
+
+  // number of nodes, e.g. for comparisons of different scenes
+  size_t get_no_of_nodes() const;
+};
+
+
+enum class AccelerationStructureType : short { list, kd_tree };
+
+// creates the acceleration structure of the given type for the primitives,
+// so the backend can be chosen at runtime
+template <class FLOAT, size_t N, class PRIMITIVE>
+std::unique_ptr<AccelerationStructure<FLOAT, N, PRIMITIVE>> make_acceleration_structure(AccelerationStructureType type, std::vector<PRIMITIVE> primitives);
+
+
+typedef KdTree<float, 3u, Triangle3df> TriangleKdTree3df;
+typedef PrimitiveList<float, 3u, Triangle3df> TriangleList3df;
+
+#endif
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+PrimitiveList<FLOAT, N, PRIMITIVE>::PrimitiveList(std::vector<PRIMITIVE> primitives)
+  : primitives(std::move(primitives))
+{
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+const PRIMITIVE * PrimitiveList<FLOAT, N, PRIMITIVE>::closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  const PRIMITIVE * closest = nullptr;
+  FLOAT closest_t = std::numeric_limits<FLOAT>::max();
+
+  for (const PRIMITIVE & primitive : primitives) {
+    Intersection_Context<FLOAT, N> temp_context;
+    if (primitive.intersects(ray, temp_context) && temp_context.t < closest_t) {
+      closest = &primitive;
+      closest_t = temp_context.t;
+      context = temp_context;
+    }
+  }
+  return closest;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool PrimitiveList<FLOAT, N, PRIMITIVE>::any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const {
+  for (const PRIMITIVE & primitive : primitives) {
+    FLOAT t = primitive.intersects(ray);
+    if (0 < t && t < t_max) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// N-dimensional analogue of half the surface area of a box with the given edge lengths
+// (half perimeter for N = 2), proportional to the probability that a random ray hits the box
+template <class FLOAT, size_t N>
+static FLOAT boundary_measure(Vector<FLOAT, N> extent) {
+  FLOAT measure = 0.0;
+  for (size_t i = 0; i < N; i++) {
+    FLOAT product = 1.0;
+    for (size_t j = 0; j < N; j++) {
+      if (j != i) {
+        product *= extent[j];
+      }
+    }
+    measure += product;
+  }
+  return measure;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+KdTree<FLOAT, N, PRIMITIVE>::KdTree(std::vector<PRIMITIVE> primitives)
+  : primitives(std::move(primitives))
+{
+  std::vector<unsigned> indices;
+  lower = {INFINITY};
+  upper = {-INFINITY};
+
+  bounds.reserve(this->primitives.size());
+  for (unsigned i = 0; i < this->primitives.size(); i++) {
+    AxisAlignedBoundingBox<FLOAT, N> box = this->primitives[i].get_bounding_box();
+    bounds.push_back(box);
+
+    bool finite = true;
+    for (size_t axis = 0; axis < N; axis++) {
+      finite &= std::isfinite(box.get_center()[axis] - box.get_half_edge_length()[axis])
+                  && std::isfinite(box.get_center()[axis] + box.get_half_edge_length()[axis]);
+    }
+    if ( ! finite ) {
+      unbounded.push_back(i);
+      continue;
+    }
+    indices.push_back(i);
+    for (size_t axis = 0; axis < N; axis++) {
+      lower[axis] = std::min(lower[axis], box.get_center()[axis] - box.get_half_edge_length()[axis]);
+      upper[axis] = std::max(upper[axis], box.get_center()[axis] + box.get_half_edge_length()[axis]);
+    }
+  }
+
+  if (indices.empty()) {
+    lower = {0.0};
+    upper = {0.0};
+  }
+  // depth limit as proposed by pbrt, capped so the traversal stack is large enough
+  unsigned max_depth = std::min(40.0, std::round(8.0 + 1.3 * std::log2(std::max<size_t>(1u, indices.size()))));
+  build(indices, lower, upper, max_depth);
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+void KdTree<FLOAT, N, PRIMITIVE>::build(const std::vector<unsigned> & indices, Vector<FLOAT, N> node_lower, Vector<FLOAT, N> node_upper, unsigned depth) {
+  size_t count = indices.size();
+  Vector<FLOAT, N> extent = node_upper - node_lower;
+  FLOAT total_measure = boundary_measure(extent);
+
+  FLOAT best_cost = INTERSECTION_COST * count; // cost of making this node a leaf
+  unsigned best_axis = N;
+  FLOAT best_split = 0.0;
+
+  if (count > 1 && depth > 0 && total_measure > 0.0) {
+    // sweep over the sorted start (true) and end (false) edges of the primitive bounds,
+    // clipped to the bounds of this node, and evaluate the SAH at each edge
+    std::vector<std::pair<FLOAT, bool>> edges;
+    edges.reserve(2 * count);
+    for (size_t axis = 0; axis < N; axis++) {
+      edges.clear();
+      for (unsigned index : indices) {
+        FLOAT center = bounds[index].get_center()[axis];
+        FLOAT half_edge_length = bounds[index].get_half_edge_length()[axis];
+        edges.push_back( {std::max(center - half_edge_length, node_lower[axis]), true} );
+        edges.push_back( {std::min(center + half_edge_length, node_upper[axis]), false} );
+      }
+      // at equal positions start edges come first
+      std::sort(edges.begin(), edges.end(), [](const std::pair<FLOAT, bool> & e1, const std::pair<FLOAT, bool> & e2) {
+        return e1.first < e2.first || (e1.first == e2.first && e1.second > e2.second);
+      });
+
+      size_t below = 0, above = count;
+      for (const auto & edge : edges) {
+        if ( ! edge.second ) {
+          above--;
+        }
+        if (node_lower[axis] < edge.first && edge.first < node_upper[axis]) {
+          Vector<FLOAT, N> extent_below = extent, extent_above = extent;
+          extent_below[axis] = edge.first - node_lower[axis];
+          extent_above[axis] = node_upper[axis] - edge.first;
+          FLOAT bonus = (below == 0 || above == 0) ? EMPTY_BONUS : 1.0;
+          FLOAT cost = TRAVERSAL_COST + INTERSECTION_COST * bonus
+                         * (boundary_measure(extent_below) * below + boundary_measure(extent_above) * above) / total_measure;
+          if (cost < best_cost) {
+            best_cost = cost;
+            best_axis = axis;
+            best_split = edge.first;
+          }
+        }
+        if (edge.second) {
+          below++;
+        }
+      }
+    }
+  }
+
+  if (best_axis == N) {
+    nodes.push_back( Node{0.0, N, static_cast<unsigned>(leaf_primitives.size()), static_cast<unsigned>(count)} );
+    leaf_primitives.insert(leaf_primitives.end(), indices.begin(), indices.end());
+    return;
+  }
+
+  // primitives overlapping the split plane are put into both children
+  std::vector<unsigned> indices_below, indices_above;
+  for (unsigned index : indices) {
+    FLOAT minimum = bounds[index].get_center()[best_axis] - bounds[index].get_half_edge_length()[best_axis];
+    FLOAT maximum = bounds[index].get_center()[best_axis] + bounds[index].get_half_edge_length()[best_axis];
+    if (minimum < best_split || maximum <= best_split) {
+      indices_below.push_back(index);
+    }
+    if (maximum > best_split || minimum >= best_split) {
+      indices_above.push_back(index);
+    }
+  }
+
+  size_t node = nodes.size();
+  nodes.push_back( Node{best_split, best_axis, 0, 0} );
+
+  Vector<FLOAT, N> split_upper = node_upper, split_lower = node_lower;
+  split_upper[best_axis] = best_split;
+  split_lower[best_axis] = best_split;
+  build(indices_below, node_lower, split_upper, depth - 1);
+  nodes[node].index = nodes.size();
+  build(indices_above, split_lower, node_upper, depth - 1);
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool KdTree<FLOAT, N, PRIMITIVE>::clip(const Ray<FLOAT, N> &ray, FLOAT & t_near, FLOAT & t_far) const {
+  t_near = 0.0;
+  t_far = INFINITY;
+  for (size_t axis = 0; axis < N; axis++) {
+    FLOAT inverse_direction = static_cast<FLOAT>(1.0) / ray.direction[axis];
+    FLOAT t0 = (lower[axis] - ray.origin[axis]) * inverse_direction;
+    FLOAT t1 = (upper[axis] - ray.origin[axis]) * inverse_direction;
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    // NaN (ray parallel to and on a face) leaves the interval unchanged
+    t_near = std::max(t_near, t0);
+    t_far = std::min(t_far, t1);
+  }
+  return t_near <= t_far;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+const PRIMITIVE * KdTree<FLOAT, N, PRIMITIVE>::closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  const PRIMITIVE * closest = nullptr;
+  FLOAT closest_t = std::numeric_limits<FLOAT>::max();
+
+  for (unsigned index : unbounded) {
+    Intersection_Context<FLOAT, N> temp_context;
+    if (primitives[index].intersects(ray, temp_context) && temp_context.t < closest_t) {
+      closest = &primitives[index];
+      closest_t = temp_context.t;
+      context = temp_context;
+    }
+  }
+
+  FLOAT t_near, t_far;
+  if ( ! clip(ray, t_near, t_far) ) {
+    return closest;
+  }
+
+  struct Entry {
+    size_t node;
+    FLOAT t_near, t_far;
+  } stack[64];
+  size_t top = 0;
+  size_t node = 0;
+
+  while (t_near <= closest_t) {
+    const Node & current = nodes[node];
+    if (current.axis < N) {
+      FLOAT origin = ray.origin[current.axis];
+      if (ray.direction[current.axis] == 0.0) {
+        // parallel to the split plane the ray stays in the children containing its origin, in both if it
+        // lies in the plane: the primitives starting at the plane are only in the child above it
+        if (origin == current.split) {
+          stack[top++] = Entry{current.index, t_near, t_far};
+        }
+        node = origin <= current.split ? node + 1 : current.index;
+        continue;
+      }
+      FLOAT t_split = (current.split - origin) / ray.direction[current.axis];
+      bool below_first = origin < current.split || (origin == current.split && ray.direction[current.axis] <= 0.0);
+      size_t first = below_first ? node + 1 : current.index;
+      size_t second = below_first ? current.index : node + 1;
+
+      if (t_split > t_far || t_split <= 0.0) {
+        node = first;
+      } else if (t_split < t_near) {
+        node = second;
+      } else {
+        stack[top++] = Entry{second, t_split, t_far};
+        node = first;
+        t_far = t_split;
+      }
+      continue;
+    }
+
+    for (unsigned i = current.index; i < current.index + current.count; i++) {
+      const PRIMITIVE & primitive = primitives[leaf_primitives[i]];
+      Intersection_Context<FLOAT, N> temp_context;
+      if (primitive.intersects(ray, temp_context) && temp_context.t < closest_t) {
+        closest = &primitive;
+        closest_t = temp_context.t;
+        context = temp_context;
+      }
+    }
+    // a hit is only beaten by a leaf starting before it, the loop condition checks the t_near of the
+    // next leaf (a ray in a split plane visits both children with the same interval)
+    if (top == 0) {
+      break;
+    }
+    top--;
+    node = stack[top].node;
+    t_near = stack[top].t_near;
+    t_far = stack[top].t_far;
+  }
+  return closest;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool KdTree<FLOAT, N, PRIMITIVE>::any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const {
+  for (unsigned index : unbounded) {
+    FLOAT t = primitives[index].intersects(ray);
+    if (0 < t && t < t_max) {
+      return true;
+    }
+  }
+
+  FLOAT t_near, t_far;
+  if ( ! clip(ray, t_near, t_far) || t_near >= t_max ) {
+    return false;
+  }
+  t_far = std::min(t_far, t_max);
+
+  struct Entry {
+    size_t node;
+    FLOAT t_near, t_far;
+  } stack[64];
+  size_t top = 0;
+  size_t node = 0;
+
+  while (true) {
+    const Node & current = nodes[node];
+    if (current.axis < N) {
+      FLOAT origin = ray.origin[current.axis];
+      if (ray.direction[current.axis] == 0.0) {
+        // parallel to the split plane the ray stays in the children containing its origin, in both if it
+        // lies in the plane: the primitives starting at the plane are only in the child above it
+        if (origin == current.split) {
+          stack[top++] = Entry{current.index, t_near, t_far};
+        }
+        node = origin <= current.split ? node + 1 : current.index;
+        continue;
+      }
+      FLOAT t_split = (current.split - origin) / ray.direction[current.axis];
+      bool below_first = origin < current.split || (origin == current.split && ray.direction[current.axis] <= 0.0);
+      size_t first = below_first ? node + 1 : current.index;
+      size_t second = below_first ? current.index : node + 1;
+
+      if (t_split > t_far || t_split <= 0.0) {
+        node = first;
+      } else if (t_split < t_near) {
+        node = second;
+      } else {
+        stack[top++] = Entry{second, t_split, t_far};
+        node = first;
+        t_far = t_split;
+      }
+      continue;
+    }
+
+    for (unsigned i = current.index; i < current.index + current.count; i++) {
+      FLOAT t = primitives[leaf_primitives[i]].intersects(ray);
+      if (0 < t && t < t_max) {
+        return true;
+      }
+    }
+    if (top == 0) {
+      return false;
+    }
+    top--;
+    node = stack[top].node;
+    t_near = stack[top].t_near;
+    t_far = stack[top].t_far;
+  }
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+size_t KdTree<FLOAT, N, PRIMITIVE>::get_no_of_nodes() const {
+  return nodes.size();
+}
+
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+std::unique_ptr<AccelerationStructure<FLOAT, N, PRIMITIVE>> make_acceleration_structure(AccelerationStructureType type, std::vector<PRIMITIVE> primitives) {
+  switch (type) {
+    case AccelerationStructureType::kd_tree:
+      return std::make_unique<KdTree<FLOAT, N, PRIMITIVE>>(std::move(primitives));
+    case AccelerationStructureType::list:
+      break;
+  }
+  return std::make_unique<PrimitiveList<FLOAT, N, PRIMITIVE>>(std::move(primitives));
+}
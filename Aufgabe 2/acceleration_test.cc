@@ -0,0 +1,106 @@
+#include "acceleration.h"
+#include "gtest/gtest.h"
+#include <random>
+
+namespace {
+
+std::vector<Triangle3df> random_triangles(size_t count) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < count; i++) {
+    Vector3df a = {position(generator), position(generator), position(generator)};
+    triangles.push_back( Triangle3df{ a,
+                                      a + Vector3df{offset(generator), offset(generator), offset(generator)},
+                                      a + Vector3df{offset(generator), offset(generator), offset(generator)} } );
+  }
+  return triangles;
+}
+
+TEST(KDTREE, ClosestHitSingleTriangle) {
+  TriangleKdTree3df tree( { Triangle3df{ {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0} } } );
+  Ray3df ray{ {1.0, 1.0, 2.0}, {0.0, 0.0, -1.0} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_NE(nullptr, tree.closest_hit(ray, context) );
+  EXPECT_NEAR(2.0, context.t, 0.000001 );
+  EXPECT_NEAR(1.0, context.intersection[0], 0.000001 );
+}
+
+TEST(KDTREE, ClosestHitNearestTriangle) {
+  TriangleKdTree3df tree( { Triangle3df{ {-1.0, -1.0, -5.0}, {-1.0, 3.0, -5.0},{3.0, -1.0, -5.0} },
+                            Triangle3df{ {-1.0, -1.0, -2.0}, {-1.0, 3.0, -2.0},{3.0, -1.0, -2.0} },
+                            Triangle3df{ {-1.0, -1.0, -8.0}, {-1.0, 3.0, -8.0},{3.0, -1.0, -8.0} } } );
+  Ray3df ray{ {0.0, 0.0, 0.0}, {0.0, 0.0, -1.0} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_NE(nullptr, tree.closest_hit(ray, context) );
+  EXPECT_NEAR(2.0, context.t, 0.000001 );
+}
+
+TEST(KDTREE, NoHit) {
+  TriangleKdTree3df tree( random_triangles(100) );
+  Ray3df ray{ {0.0, 20.0, 0.0}, {0.0, 1.0, 0.0} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_EQ(nullptr, tree.closest_hit(ray, context) );
+  EXPECT_FALSE( tree.any_hit(ray, INFINITY) );
+}
+
+TEST(KDTREE, AnyHitWithMaximumDistance) {
+  TriangleKdTree3df tree( { Triangle3df{ {-1.0, -1.0, -5.0}, {-1.0, 3.0, -5.0},{3.0, -1.0, -5.0} } } );
+  Ray3df ray{ {0.0, 0.0, 0.0}, {0.0, 0.0, -1.0} };
+
+  EXPECT_TRUE( tree.any_hit(ray, 6.0f) );
+  EXPECT_FALSE( tree.any_hit(ray, 4.0f) );
+}
+
+TEST(KDTREE, SameHitsAsPrimitiveList) {
+  auto expect_same_hits = [](const std::vector<Triangle3df> & triangles, const std::vector<Ray3df> & rays) {
+    auto tree = make_acceleration_structure<float, 3u>(AccelerationStructureType::kd_tree, triangles);
+    auto list = make_acceleration_structure<float, 3u>(AccelerationStructureType::list, triangles);
+    size_t hits = 0;
+    for (const Ray3df & ray : rays) {
+      Intersection_Context<float,3u> tree_context, list_context;
+      const Triangle3df * tree_hit = tree->closest_hit(ray, tree_context);
+      const Triangle3df * list_hit = list->closest_hit(ray, list_context);
+
+      ASSERT_EQ(list_hit == nullptr, tree_hit == nullptr);
+      if (list_hit != nullptr) {
+        EXPECT_NEAR(list_context.t, tree_context.t, 0.00001);
+        hits++;
+      }
+      EXPECT_EQ(list->any_hit(ray, 1.0f), tree->any_hit(ray, 1.0f));
+      EXPECT_EQ(list->any_hit(ray, INFINITY), tree->any_hit(ray, INFINITY));
+    }
+    EXPECT_LT(0u, hits);
+  };
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  std::vector<Ray3df> rays;
+  for (size_t i = 0; i < 1000; i++) {
+    rays.push_back( Ray3df{ {15.0f * distribution(generator), 15.0f * distribution(generator), 15.0f * distribution(generator)},
+                            {distribution(generator), distribution(generator), distribution(generator)} } );
+  }
+  expect_same_hits(random_triangles(2000), rays);
+
+  // a scene symmetric to the plane x = 0 like the Cornell box: the triangles touch the plane from both
+  // sides with an edge in it, so the tree splits at x = 0, and the rays inside the plane hit these edges
+  std::vector<Triangle3df> symmetric_triangles;
+  for (size_t i = 0; i < 500; i++) {
+    Vector3df a = {0.0f, 10.0f * distribution(generator), 10.0f * distribution(generator)};
+    Vector3df b = a + Vector3df{0.0f, distribution(generator), distribution(generator)};
+    Vector3df c = a + Vector3df{1.5f + distribution(generator), distribution(generator), distribution(generator)};
+    symmetric_triangles.push_back( Triangle3df{a, b, c} );
+    symmetric_triangles.push_back( Triangle3df{a, b, {-c[0], c[1], c[2]}} );
+  }
+  rays.clear();
+  for (size_t i = 0; i < 1000; i++) {
+    rays.push_back( Ray3df{ {0.0f, 15.0f * distribution(generator), 15.0f * distribution(generator)},
+                            {0.0f, distribution(generator), distribution(generator)} } );
+  }
+  expect_same_hits(symmetric_triangles, rays);
+}
+}
@@ -0,0 +1,116 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "math.h"
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// helpers shared by the *_bench targets, which are google benchmark executables.
+// Every benchmark runs its operation over a data set twice: once with a data set fitting into
+// the L1 data cache and once with a data set exceeding the last level cache, each with all
+// distributions (e.g. hit and miss) it is registered with. The benchmark arguments are the
+// number of elements and the index of the distribution, the distribution name is the label.
+// ns_per_op and items_per_second (operations per second) are reported for each run, use
+//   ./math_bench --benchmark_format=json > math_bench.json
+// to compare two builds.
+
+
+// returns the number of elements with the given size in bytes which fill half of the L1 data cache
+inline size_t l1_sized(size_t element_bytes) {
+  long l1_bytes = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  if (l1_bytes <= 0) {
+    l1_bytes = 32 * 1024;
+  }
+  return std::max<size_t>(1, l1_bytes / 2 / element_bytes);
+}
+
+// returns the number of elements with the given size in bytes which fill twice the last level cache
+inline size_t beyond_llc_sized(size_t element_bytes) {
+  long llc_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (llc_bytes <= 0) {
+    llc_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  }
+  if (llc_bytes <= 0) {
+    llc_bytes = 32 * 1024 * 1024;
+  }
+  return 2 * llc_bytes / element_bytes;
+}
+
+// registers function for both data set sizes and the given distributions
+inline void register_benchmark(const std::string & name, void (*function)(benchmark::State &),
+                               size_t element_bytes, std::vector<std::string> distributions = {"uniform"}) {
+  for (size_t size : {l1_sized(element_bytes), beyond_llc_sized(element_bytes)}) {
+    for (size_t distribution = 0; distribution < distributions.size(); distribution++) {
+      benchmark::RegisterBenchmark(name.c_str(), [function, label = distributions[distribution]](benchmark::State & state) {
+        state.SetLabel(label);
+        function(state);
+      })->Args({static_cast<int64_t>(size), static_cast<int64_t>(distribution)})->Unit(benchmark::kNanosecond);
+    }
+  }
+}
+
+// data_set seeds it before each data set is generated, so each run measures the same values
+inline std::mt19937 & random_generator() {
+  static std::mt19937 generator(42);
+  return generator;
+}
+
+// the last data set returned by data_set, for all benchmarks
+struct Cached_Data_Set {
+  std::string key;
+  std::shared_ptr<void> data;
+};
+inline Cached_Data_Set cached_data_set;
+
+// returns the data set for the current arguments of state, generate(size, distribution) is only
+// called if the previous call had other arguments. google benchmark calls a benchmark function
+// several times until its timing is stable, but only the last data set is kept, so the data
+// sets exceeding the last level cache don't pile up.
+template <class DATA, class GENERATOR>
+const DATA & data_set(const std::string & name, const benchmark::State & state, GENERATOR generate) {
+  std::string key = name + "/" + std::to_string(state.range(0)) + "/" + std::to_string(state.range(1));
+  if (key != cached_data_set.key) {
+    cached_data_set.data.reset(); // release the previous data set before the next one is generated
+    random_generator().seed(42);
+    cached_data_set.data = std::make_shared<DATA>(generate(state.range(0), state.range(1)));
+    cached_data_set.key = key;
+  }
+  return *static_cast<const DATA *>(cached_data_set.data.get());
+}
+
+// reports ns_per_op and items_per_second for operations_per_iteration operations in each iteration
+// (the console output shows ns_per_op with the unit "s" of inverted rates, the JSON output the plain number)
+inline void report_operations(benchmark::State & state, size_t operations_per_iteration) {
+  int64_t operations = state.iterations() * operations_per_iteration;
+  state.SetItemsProcessed(operations);
+  state.counters["ns_per_op"] = benchmark::Counter(operations * 1e-9, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+
+// returns a vector with components uniformly distributed in [-range, range]
+template <size_t N>
+Vector<float, N> random_vector(float range = 1.0f) {
+  std::uniform_real_distribution<float> distribution(-range, range);
+  Vector<float, N> vector;
+  for (size_t i = 0; i < N; i++) {
+    vector[i] = distribution(random_generator());
+  }
+  return vector;
+}
+
+// returns a random vector of length 1
+template <size_t N>
+Vector<float, N> random_direction() {
+  Vector<float, N> direction;
+  do {
+    direction = random_vector<N>();
+  } while (direction.square_of_length() < 0.01f);
+  direction.normalize();
+  return direction;
+}
+
+#endif
@@ -12,6 +12,12 @@ template class AxisAlignedBoundingBox<float, 3u>;
 template class Sphere<float, 2u>;
 template class Sphere<float, 3u>; 
 
+template class Plane<float, 2u>;
+template class Plane<float, 3u>;
+
+template class Box<float, 2u>;
+template class Box<float, 3u>;
+
 template class Triangle<float, 3u>; 
 
 template bool refract<float, 3u>(float refraction_index, Vector<float, 3u> normal, Vector<float, 3u> direction, Vector<float, 3> & transmission);
@@ -3,6 +3,7 @@
 
 
 #include "math.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -60,8 +61,12 @@ protected:
   Vector<FLOAT,N> center,
                   half_edge_length;
 public:
-  AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length);
-  bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const;
+  constexpr AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length);
+  constexpr bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const;
+
+  constexpr Vector<FLOAT,N> get_center() const;
+
+  constexpr Vector<FLOAT,N> get_half_edge_length() const;
 
   // checks if this aabb is intersected by the given ray
   bool intersects(Ray<FLOAT,N> ray) const;
@@ -81,32 +86,83 @@ class Sphere {
 protected:
   Vector<FLOAT,N> center;
 public:
-  Sphere(Vector<FLOAT,N> center, FLOAT radius);
+  constexpr Sphere(Vector<FLOAT,N> center, FLOAT radius);
 
   // returns true iff the given ray intersects this sphere
   // context.intersection is set to the intersection point,
   // context.normal is set to the intersection normal facing away from the surface
   // context.t is set to the value with: ray.origin + t * ray.direction == intersection
-  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+  constexpr bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
 
   // returns a value t such that ray.origin + t * ray.direction is the intersection point
   // t is zero if no intersection occured
-  FLOAT intersects(const Ray<FLOAT, N> &ray) const;
+  constexpr FLOAT intersects(const Ray<FLOAT, N> &ray) const;
 
   // -------------------------
 
   // returns true iff this Sphere intersects with the given sphere
 
-  bool intersects(Sphere<FLOAT, N> sphere) const;
+  constexpr bool intersects(Sphere<FLOAT, N> sphere) const;
 
 
   // returns true iff the given point is inside this Sphere or on its surface
 
-  bool inside(const Vector<FLOAT, N> p) const;
+  constexpr bool inside(const Vector<FLOAT, N> p) const;
+
+  // returns the smallest axis aligned bounding box containing this Sphere
+  constexpr AxisAlignedBoundingBox<FLOAT, N> get_bounding_box() const;
 
     FLOAT radius;
 };
 
+// an infinite plane through the given point, the normal is normalized by the constructor
+// in contrast to a giant sphere the intersection is a single division and stays exact
+// for large distances
+template <class FLOAT, size_t N>
+class Plane {
+protected:
+  Vector<FLOAT,N> point,
+                  normal;
+public:
+  constexpr Plane(Vector<FLOAT,N> point, Vector<FLOAT,N> normal);
+
+  // returns a value t > 0 such that ray.origin + t * ray.direction is the intersection point
+  // t is zero if no intersection occured (ray parallel to or pointing away from the plane)
+  FLOAT intersects(const Ray<FLOAT, N> &ray) const;
+
+  // returns true iff the given ray intersects this plane
+  // context.normal is the plane normal facing the side of ray.origin, so both sides can be lit
+  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns the bounding box of this plane
+  // the box is infinite in all directions except along an axis parallel to the normal,
+  // where it has no thickness, so acceleration structures should keep planes apart
+  constexpr AxisAlignedBoundingBox<FLOAT, N> get_bounding_box() const;
+};
+
+// a solid axis aligned box, e.g. for walls of finite size
+// uses the same center and half_edge_length representation as AxisAlignedBoundingBox
+template <class FLOAT, size_t N>
+class Box : public AxisAlignedBoundingBox<FLOAT, N> {
+public:
+  constexpr Box(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length);
+
+  // returns a value t > 0 such that ray.origin + t * ray.direction is the nearest intersection point
+  // if the ray starts inside the box, the exit point is returned
+  // t is zero if no intersection occured
+  FLOAT intersects(const Ray<FLOAT, N> &ray) const;
+
+  // returns true iff the given ray intersects this box
+  // context.normal is the normal of the face that had been hit, pointing to the inside
+  // if the ray starts inside the box (same convention as Sphere)
+  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns true iff the given box overlaps this box
+  constexpr bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const;
+
+  constexpr AxisAlignedBoundingBox<FLOAT, N> get_bounding_box() const;
+};
+
 // -------------------------
 
 template <class FLOAT, size_t N>
@@ -117,15 +173,15 @@ protected:
 public:
   // creates a triangle with the given edge points a,b,c
   // the normals point away from the surface given by clockwise orientation of a,b,c
-  Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c);
+  constexpr Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c);
 
   // creates a triangle with the given edge points a,b,c
   // the normals of the edges are set to the given normal vector
-  Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal);
+  constexpr Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal);
 
   // creates a triangle with the given edge points a,b,c
   // the normal of each edge a,b, and c are set to na, nb, and nc
-  Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc);
+  constexpr Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc);
 
   // returns true if this Triangle intersects the given ray
   // if an intersection occured, than intersection is set to the intersection point
@@ -140,9 +196,178 @@ public:
   //   context.t is set to a value with intersection = ray.origin + t * ray.direction
   //   context.normal points away from the surface (clockwise order of a,b, and c)
   bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns a value t such that ray.origin + t * ray.direction is the intersection point
+  // t is zero if no intersection occured
+  FLOAT intersects(const Ray<FLOAT, N> &ray) const;
+
+  // returns the smallest axis aligned bounding box containing the points a, b, and c
+  constexpr AxisAlignedBoundingBox<FLOAT, N> get_bounding_box() const;
 };
 
 
+// ----------------------------------------------------------------------------
+// constexpr members of the shapes
+//
+// Like the constexpr members of Vector they live in the header; the ray intersections
+// of AxisAlignedBoundingBox, Plane, Box and Triangle use std::fabs or the slab method
+// and stay in geometry.tcc.
+
+template <class FLOAT, size_t N>
+constexpr AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
+  : center(center), half_edge_length(half_edge_length)
+{
+}
+
+template <class FLOAT, size_t N>
+constexpr Vector<FLOAT,N> AxisAlignedBoundingBox<FLOAT, N>::get_center() const {
+  return center;
+}
+
+template <class FLOAT, size_t N>
+constexpr Vector<FLOAT,N> AxisAlignedBoundingBox<FLOAT, N>::get_half_edge_length() const {
+  return half_edge_length;
+}
+
+template <class FLOAT, size_t N>
+constexpr bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
+  bool intersects = true;
+  for (size_t i = 0; i < N; i++) {
+    intersects &= (center[i] - half_edge_length[i] - aabb.half_edge_length[i] <= aabb.center[i])
+                     & (aabb.center[i] <= center[i] + half_edge_length[i] + aabb.half_edge_length[i]);
+  }
+  return intersects;
+}
+
+template <class FLOAT, size_t N>
+constexpr Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
+ : center(center), radius(radius)
+{
+}
+
+// returns true iff this Sphere intersects with the given sphere
+// | Center von B - Center von A | <= | Radius von a + Radius von b |
+template <class FLOAT, size_t N>
+constexpr bool Sphere<FLOAT,N>::intersects(Sphere<FLOAT, N> sphere) const {
+    Vector<FLOAT, N> distanceVector = sphere.center - this->center; // | Center von B - Center von A |
+    FLOAT totalRadius = this->radius + sphere.radius; // | Radius von a + Radius von b |
+    return distanceVector.square_of_length() <= totalRadius * totalRadius;
+}
+
+// returns true iff the given point is inside this Sphere or on its surface
+// Punkt P mit (x,y,z). Zentrum von Kugel C mit (a, b, c), Radius r
+// Wurzel[ (x-a)² + (y-b)² + (z-c)² ] <= r
+// | Punkt - Zentrum | <= r
+template <class FLOAT, size_t N>
+constexpr bool Sphere<FLOAT,N>::inside(Vector<FLOAT, N> p) const {
+    Vector<FLOAT, N> distanceVector = p - this->center;
+    return distanceVector.square_of_length() <= this->radius * this->radius; // no square root needed
+}
+
+template <class FLOAT, size_t N>
+constexpr AxisAlignedBoundingBox<FLOAT, N> Sphere<FLOAT,N>::get_bounding_box() const {
+  return AxisAlignedBoundingBox<FLOAT, N>(center, Vector<FLOAT, N>{radius});
+}
+
+// solution via
+// (g(t) - center )^2  = ( (ray.origin - center) + t ray.direction)^2 = r^2
+// and abc-formula
+template <class FLOAT, size_t N>
+constexpr FLOAT Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
+  Vector<FLOAT,N> om = ray.origin - center;
+  FLOAT  a = ray.direction * ray.direction,
+         b = 2.0 * (om * ray.direction),
+         c = om * om - radius * radius,
+         d = b * b - 4.0 * a * c;
+  if (d < 0) {
+   return 0;
+  }
+  d = square_root(d);
+  if ( inside( ray.origin ) ) {
+    return 0.5 * std::max(-b + d, -b - d) / a;
+  }
+  return 0.5 * std::min( std::max<FLOAT>(0.0, (-b + d)) , (-b - d) ) / a;
+}
+
+template <class FLOAT, size_t N>
+constexpr bool Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  FLOAT t = intersects(ray);
+  if (t <= 0.0) {
+    return false;
+  }
+  context.t = t;
+  context.intersection = ray.origin + t * ray.direction;
+  context.normal = context.intersection - center;
+  context.normal.normalize();
+  if ( inside( ray.origin ) ) {
+    context.normal = static_cast<FLOAT>(-1.0) * context.normal; // ray starts inside sphere, normal points to the inside;
+  }
+  return true;
+}
+
+template <class FLOAT, size_t N>
+constexpr Plane<FLOAT,N>::Plane(Vector<FLOAT,N> point, Vector<FLOAT,N> normal)
+ : point(point), normal(normal)
+{
+  this->normal.normalize();
+}
+
+template <class FLOAT, size_t N>
+constexpr AxisAlignedBoundingBox<FLOAT, N> Plane<FLOAT,N>::get_bounding_box() const {
+  Vector<FLOAT, N> half_edge_length{INFINITY};
+  size_t non_zero_components = 0;
+  for (size_t i = 0; i < N; i++) {
+    non_zero_components += normal[i] != 0.0;
+  }
+  for (size_t i = 0; i < N; i++) {
+    if ( non_zero_components == 1 && normal[i] != 0.0 ) {
+      half_edge_length[i] = 0.0; // axis aligned plane
+    }
+  }
+  return AxisAlignedBoundingBox<FLOAT, N>(point, half_edge_length);
+}
+
+template <class FLOAT, size_t N>
+constexpr Box<FLOAT,N>::Box(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
+ : AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length)
+{
+}
+
+template <class FLOAT, size_t N>
+constexpr bool Box<FLOAT,N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
+  return AxisAlignedBoundingBox<FLOAT, N>::intersects(aabb);
+}
+
+template <class FLOAT, size_t N>
+constexpr AxisAlignedBoundingBox<FLOAT, N> Box<FLOAT,N>::get_bounding_box() const {
+  return *this;
+}
+
+template <class FLOAT, size_t N>
+constexpr Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc)
+ : a(a), b(b), c(c), na(na), nb(nb), nc(nc) { }
+
+template <class FLOAT, size_t N>
+constexpr Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal)
+ : Triangle<FLOAT, N>::Triangle(a, b, c, normal, normal, normal) { }
+
+template <class FLOAT, size_t N>
+constexpr Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c)
+  :  Triangle<FLOAT, N>::Triangle(a, b, c, (c - a).cross_product(b - a) ) { }
+
+template <class FLOAT, size_t N>
+constexpr AxisAlignedBoundingBox<FLOAT, N> Triangle<FLOAT, N>::get_bounding_box() const {
+  Vector<FLOAT, N> center{}, half_edge_length{};
+  for (size_t i = 0; i < N; i++) {
+    FLOAT minimum = std::min( {a[i], b[i], c[i]} );
+    FLOAT maximum = std::max( {a[i], b[i], c[i]} );
+    center[i] = static_cast<FLOAT>(0.5) * (minimum + maximum);
+    half_edge_length[i] = static_cast<FLOAT>(0.5) * (maximum - minimum);
+  }
+  return AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length);
+}
+
+
 typedef Ray<float, 2u> Ray2df;
 typedef Ray<float, 3u> Ray3df;
 
@@ -152,6 +377,12 @@ typedef AxisAlignedBoundingBox<float, 3u> AABB3df;
 typedef Sphere<float, 2u> Sphere2df;
 typedef Sphere<float, 3u> Sphere3df;
 
+typedef Plane<float, 2u> Plane2df;
+typedef Plane<float, 3u> Plane3df;
+
+typedef Box<float, 2u> Box2df;
+typedef Box<float, 3u> Box3df;
+
 typedef Triangle<float, 3u> Triangle3df;
 
 
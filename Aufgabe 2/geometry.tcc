@@ -1,20 +1,3 @@
-template <class FLOAT, size_t N>
-AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
-  : center(center), half_edge_length(half_edge_length)
-{
-}
-
-
-template <class FLOAT, size_t N>
-bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
-  bool intersects = true;
-  for (size_t i = 0; i < N; i++) {
-    intersects &= (center[i] - half_edge_length[i] - aabb.half_edge_length[i] <= aabb.center[i])
-                     & (aabb.center[i] <= center[i] + half_edge_length[i] + aabb.half_edge_length[i]);
-  }
-  return intersects;
-}
-
 template <class FLOAT, size_t N>
 bool AxisAlignedBoundingBox<FLOAT, N>::intersects(Ray<FLOAT,N> ray) const {
     FLOAT tmin;
@@ -66,87 +49,80 @@ Vector<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::sweep_intersects(AxisAlignedB
 }
 
 
-
-template <class FLOAT, size_t N>
-Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
- : center(center), radius(radius)
-{
-}
-
 // --------------------------------
 
-// returns true iff this Sphere intersects with the given sphere
-// | Center von B - Center von A | <= | Radius von a + Radius von b |
+// solution via
+// (ray.origin + t ray.direction - point) * normal = 0
 template <class FLOAT, size_t N>
-bool Sphere<FLOAT,N>::intersects(Sphere<FLOAT, N> sphere) const {
-    Vector<FLOAT, N> distanceVector = sphere.center - this->center; // | Center von B - Center von A |
-    FLOAT totalRadius = this->radius + sphere.radius; // | Radius von a + Radius von b |
-    return distanceVector.square_of_length() <= totalRadius * totalRadius;
+FLOAT Plane<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
+  const FLOAT EPSILON = 10e-7;
+  FLOAT normal_ray_product = normal * ray.direction;
+  if ( std::fabs(normal_ray_product) < EPSILON ) {
+    return 0; // ray is parallel to the plane
+  }
+  FLOAT t = ( normal * (point - ray.origin) ) / normal_ray_product;
+  return std::max<FLOAT>(0.0, t);
 }
 
-// returns true iff the given point is inside this Sphere or on its surface
-// Punkt P mit (x,y,z). Zentrum von Kugel C mit (a, b, c), Radius r
-// Wurzel[ (x-a)² + (y-b)² + (z-c)² ] <= r
-// | Punkt - Zentrum | <= r
 template <class FLOAT, size_t N>
-bool Sphere<FLOAT,N>::inside(Vector<FLOAT, N> p) const {
-    Vector<FLOAT, N> distanceVector = p - this->center;
-    return distanceVector.length() <= this->radius;
+bool Plane<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  FLOAT t = intersects(ray);
+  if (t <= 0.0) {
+    return false;
+  }
+  context.t = t;
+  context.intersection = ray.origin + t * ray.direction;
+  context.normal = normal;
+  if ( normal * ray.direction > 0.0 ) {
+    context.normal = static_cast<FLOAT>(-1.0) * normal; // hit from the back side
+  }
+  return true;
 }
 
 
-// --------------------------------
-
-// solution via
-// (g(t) - center )^2  = ( (ray.origin - center) + t ray.direction)^2 = r^2
-// and abc-formula
-
+// slab method: intersection of the N intervals [tmin, tmax] of the ray between the two faces of each axis
 template <class FLOAT, size_t N>
-FLOAT Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
-  Vector<FLOAT,N> om = ray.origin - center;
-  FLOAT  a = ray.direction * ray.direction,
-         b = 2.0 * (om * ray.direction),
-         c = om * om - radius * radius,
-         d = b * b - 4.0 * a * c;
-  if (d < 0) {
-   return 0;
+FLOAT Box<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
+  FLOAT tminimum = -INFINITY;
+  FLOAT tmaximum = INFINITY;
+
+  for (size_t i = 0; i < N; i++) {
+    FLOAT tmin = (this->center[i] - ray.origin[i] - this->half_edge_length[i]) / ray.direction[i];
+    FLOAT tmax = (this->center[i] - ray.origin[i] + this->half_edge_length[i]) / ray.direction[i];
+    tminimum = std::max(tminimum, std::min(tmin, tmax) );
+    tmaximum = std::min(tmaximum, std::max(tmin, tmax) );
   }
-  d = sqrt(d);
-  if ( inside( ray.origin ) ) {
-    return 0.5 * std::max(-b + d, -b - d) / a;
+  if (tmaximum < tminimum || tmaximum <= 0.0) {
+    return 0;
   }
-  return 0.5 * std::min( std::max<FLOAT>(0.0, (-b + d)) , (-b - d) ) / a;
+  return tminimum > 0.0 ? tminimum : tmaximum; // tminimum <= 0: ray starts inside the box
 }
 
 template <class FLOAT, size_t N>
-bool Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+bool Box<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
   FLOAT t = intersects(ray);
   if (t <= 0.0) {
     return false;
   }
   context.t = t;
   context.intersection = ray.origin + t * ray.direction;
-  context.normal = context.intersection - center;
-  context.normal.normalize();
-  if ( inside( ray.origin ) ) {
-    context.normal = static_cast<FLOAT>(-1.0) * context.normal; // ray starts inside sphere, normal points to the inside;
+
+  // the hit face is the one whose plane is closest to the intersection point
+  size_t axis = 0;
+  FLOAT minimal_distance = INFINITY;
+  for (size_t i = 0; i < N; i++) {
+    FLOAT distance = std::fabs( std::fabs(context.intersection[i] - this->center[i]) - this->half_edge_length[i] );
+    if (distance < minimal_distance) {
+      minimal_distance = distance;
+      axis = i;
+    }
   }
+  context.normal = {0.0};
+  // entering: the face points against the ray, leaving: normal points to the inside
+  context.normal[axis] = ray.direction[axis] > 0.0 ? -1.0 : 1.0;
   return true;
 }
 
-template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc)
- : a(a), b(b), c(c), na(na), nb(nb), nc(nc) { }
-
-
-template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal)
- : Triangle<FLOAT, N>::Triangle(a, b, c, normal, normal, normal) { }
-
-template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c)
-  :  Triangle<FLOAT, N>::Triangle(a, b, c, (c - a).cross_product(b - a) ) { }
-
 
 template <class FLOAT, size_t N>
 bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
@@ -154,10 +130,16 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Conte
 }
 
 
+template <class FLOAT, size_t N>
+FLOAT Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray) const {
+  Intersection_Context<FLOAT, N> context;
+  return intersects(ray, context) ? context.t : 0;
+}
+
 template <class FLOAT, size_t N>
 bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
     const FLOAT EPSILON = 10e-7;
-    normal =  (b-a).cross_product(c-a);  // points away from triangle surface (clockwise order)
+    normal = (b - a).cross_product(c - a);  // points away from triangle surface (clockwise order)
 
     FLOAT normalRayProduct =  normal * ray.direction;
     FLOAT area = normal.length(); // used for u-v-parameter calculation
@@ -176,20 +158,20 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> &
 
     p = ray.origin + t * ray.direction;
 
-    Vector<FLOAT, N> vector = (b - a).cross_product(p - a );
+    Vector<FLOAT, N> vector = (b - a).cross_product(p - a);
     if ( normal * vector < 0.0 ) {
       return false;
     }
 
 
-    vector = (c - b).cross_product(p - b );
+    vector = (c - b).cross_product(p - b);
     if ( normal * vector < 0.0 ) {
       return false;
     }
 
     u = vector.length()  / area;
 
-    vector = (a-c).cross_product(p - c );
+    vector = (a - c).cross_product(p - c);
     if (normal * vector < 0.0 ) {
       return false;
     }
@@ -199,6 +181,7 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> &
     return true;
 }
 
+
 template <class FLOAT, size_t N>
 bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> direction, Vector<FLOAT, N> & transmission) {
    FLOAT cos_theta = direction * normal; // both vectors need to be normalized
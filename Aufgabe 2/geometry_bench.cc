@@ -0,0 +1,209 @@
+#include "geometry.h"
+#include "bench.h"
+
+// microbenchmarks of the ray intersections and refract, see bench.h
+// the intersection benchmarks run with a data set where every ray hits its shape ("hit") and
+// one where every ray misses it ("miss"), as both take different paths through the tests
+
+namespace {
+
+const std::vector<std::string> HIT_OR_MISS = {"hit", "miss"};
+const size_t HIT = 0;
+
+// returns a random direction perpendicular to the given direction
+Vector3df random_perpendicular(Vector3df direction) {
+  Vector3df perpendicular;
+  do {
+    Vector3df random = random_direction<3>();
+    perpendicular = random - (random * direction) * direction;
+  } while (perpendicular.square_of_length() < 0.01f);
+  perpendicular.normalize();
+  return perpendicular;
+}
+
+// returns a random ray together with the point at a random distance on it (the center of the shape)
+// and a unit vector perpendicular to the ray
+struct Random_Ray {
+  Ray3df ray;
+  Vector3df target, perpendicular;
+};
+
+Random_Ray random_ray() {
+  std::uniform_real_distribution<float> distance(2.0f, 20.0f);
+  Random_Ray random;
+  random.ray = {random_vector<3>(10.0f), random_direction<3>()};
+  random.target = random.ray.origin + distance(random_generator()) * random.ray.direction;
+  random.perpendicular = random_perpendicular(random.ray.direction);
+  return random;
+}
+
+template <class SHAPE>
+struct Shapes_And_Rays {
+  std::vector<SHAPE> shapes;
+  std::vector<Ray3df> rays;
+};
+
+// runs operation(shapes[i], rays[i]) for all pairs of the data set
+template <class SHAPE, class OPERATION>
+void over_shapes_and_rays(benchmark::State & state, const Shapes_And_Rays<SHAPE> & data, OPERATION operation) {
+  const size_t size = data.shapes.size();
+  for (auto _ : state) {
+    for (size_t i = 0; i < size; i++) {
+      auto result = operation(data.shapes[i], data.rays[i]);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  report_operations(state, size);
+}
+
+// spheres with radius 1, the rays pass the center at distance 0.5 (hit) or 2 (miss)
+Shapes_And_Rays<Sphere3df> generate_spheres(size_t size, size_t distribution) {
+  Shapes_And_Rays<Sphere3df> data;
+  for (size_t i = 0; i < size; i++) {
+    Random_Ray random = random_ray();
+    float offset = distribution == HIT ? 0.5f : 2.0f;
+    data.shapes.push_back(Sphere3df(random.target + offset * random.perpendicular, 1.0f));
+    data.rays.push_back(random.ray);
+  }
+  return data;
+}
+
+void sphere_intersects(benchmark::State & state) {
+  const auto & data = data_set<Shapes_And_Rays<Sphere3df>>("spheres", state, generate_spheres);
+  over_shapes_and_rays(state, data, [](const Sphere3df & sphere, const Ray3df & ray) { return sphere.intersects(ray); });
+}
+
+void sphere_intersects_with_context(benchmark::State & state) {
+  const auto & data = data_set<Shapes_And_Rays<Sphere3df>>("spheres", state, generate_spheres);
+  over_shapes_and_rays(state, data, [](const Sphere3df & sphere, const Ray3df & ray) {
+    Intersection_Context<float, 3> context;
+    bool hit = sphere.intersects(ray, context);
+    return hit ? context.normal : Vector3df{0.0f, 0.0f, 0.0f};
+  });
+}
+
+// triangles perpendicular to the rays, containing the ray's target point (hit) or shifted aside (miss)
+Shapes_And_Rays<Triangle3df> generate_triangles(size_t size, size_t distribution) {
+  Shapes_And_Rays<Triangle3df> data;
+  for (size_t i = 0; i < size; i++) {
+    Random_Ray random = random_ray();
+    Vector3df u = random.perpendicular;
+    Vector3df v = random_perpendicular(random.ray.direction);
+    Vector3df center = random.target + (distribution == HIT ? 0.0f : 3.0f) * u;
+    data.shapes.push_back(Triangle3df(center - u - v, center + u - v, center + v));
+    data.rays.push_back(random.ray);
+  }
+  return data;
+}
+
+void triangle_intersects(benchmark::State & state) {
+  const auto & data = data_set<Shapes_And_Rays<Triangle3df>>("triangles", state, generate_triangles);
+  over_shapes_and_rays(state, data, [](const Triangle3df & triangle, const Ray3df & ray) { return triangle.intersects(ray); });
+}
+
+void triangle_intersects_with_context(benchmark::State & state) {
+  const auto & data = data_set<Shapes_And_Rays<Triangle3df>>("triangles", state, generate_triangles);
+  over_shapes_and_rays(state, data, [](const Triangle3df & triangle, const Ray3df & ray) {
+    Intersection_Context<float, 3> context;
+    bool hit = triangle.intersects(ray, context);
+    return hit ? context.normal : Vector3df{0.0f, 0.0f, 0.0f};
+  });
+}
+
+// cubes with half edge length 1, the rays pass the center (hit) or at distance 3 (miss)
+Shapes_And_Rays<AABB3df> generate_boxes(size_t size, size_t distribution) {
+  Shapes_And_Rays<AABB3df> data;
+  for (size_t i = 0; i < size; i++) {
+    Random_Ray random = random_ray();
+    float offset = distribution == HIT ? 0.0f : 3.0f;
+    data.shapes.push_back(AABB3df(random.target + offset * random.perpendicular, {1.0f, 1.0f, 1.0f}));
+    data.rays.push_back(random.ray);
+  }
+  return data;
+}
+
+void aabb_intersects_ray(benchmark::State & state) {
+  const auto & data = data_set<Shapes_And_Rays<AABB3df>>("boxes", state, generate_boxes);
+  over_shapes_and_rays(state, data, [](const AABB3df & aabb, const Ray3df & ray) { return aabb.intersects(ray); });
+}
+
+// pairs of cubes with half edge length 1, overlapping (hit) or separated along one axis (miss)
+std::vector<std::array<AABB3df, 2>> generate_box_pairs(size_t size, size_t distribution) {
+  std::uniform_int_distribution<size_t> axis(0, 2);
+  std::vector<std::array<AABB3df, 2>> pairs;
+  for (size_t i = 0; i < size; i++) {
+    Vector3df center = random_vector<3>(10.0f);
+    Vector3df offset = random_vector<3>(1.5f);
+    if (distribution != HIT) {
+      offset[axis(random_generator())] = 3.0f;
+    }
+    pairs.push_back({AABB3df(center, {1.0f, 1.0f, 1.0f}), AABB3df(center + offset, {1.0f, 1.0f, 1.0f})});
+  }
+  return pairs;
+}
+
+void aabb_intersects_aabb(benchmark::State & state) {
+  const auto & pairs = data_set<std::vector<std::array<AABB3df, 2>>>("box_pairs", state, generate_box_pairs);
+  for (auto _ : state) {
+    for (const std::array<AABB3df, 2> & pair : pairs) {
+      bool overlap = pair[0].intersects(pair[1]);
+      benchmark::DoNotOptimize(overlap);
+    }
+  }
+  report_operations(state, pairs.size());
+}
+
+const std::vector<std::string> TRANSMISSION_OR_REFLECTION = {"transmission", "total_internal_reflection"};
+
+// directions hitting a surface at angles of incidence between 50 and 85 degrees. Entering a denser
+// material (refraction index 1/1.5) they are transmitted, leaving it (refraction index 1.5) the
+// critical angle is 42 degrees and they are reflected
+struct Refractions {
+  float refraction_index;
+  std::vector<Vector3df> normals, directions;
+};
+
+Refractions generate_refractions(size_t size, size_t distribution) {
+  std::uniform_real_distribution<float> angle(50.0f * PI / 180.0f, 85.0f * PI / 180.0f);
+  Refractions refractions;
+  refractions.refraction_index = distribution == 0 ? 1.0f / 1.5f : 1.5f;
+  for (size_t i = 0; i < size; i++) {
+    Vector3df normal = random_direction<3>();
+    float incidence = angle(random_generator());
+    Vector3df direction = -std::cos(incidence) * normal + std::sin(incidence) * random_perpendicular(normal);
+    refractions.normals.push_back(normal);
+    refractions.directions.push_back(direction);
+  }
+  return refractions;
+}
+
+void refract_direction(benchmark::State & state) {
+  const Refractions & refractions = data_set<Refractions>("refractions", state, generate_refractions);
+  const size_t size = refractions.normals.size();
+  for (auto _ : state) {
+    for (size_t i = 0; i < size; i++) {
+      Vector3df transmission;
+      bool transmitted = refract(refractions.refraction_index, refractions.normals[i], refractions.directions[i], transmission);
+      benchmark::DoNotOptimize(transmitted);
+      benchmark::DoNotOptimize(transmission);
+    }
+  }
+  report_operations(state, size);
+}
+
+}
+
+int main(int argc, char ** argv) {
+  register_benchmark("sphere_intersects", sphere_intersects, sizeof(Sphere3df) + sizeof(Ray3df), HIT_OR_MISS);
+  register_benchmark("sphere_intersects_with_context", sphere_intersects_with_context, sizeof(Sphere3df) + sizeof(Ray3df), HIT_OR_MISS);
+  register_benchmark("triangle_intersects", triangle_intersects, sizeof(Triangle3df) + sizeof(Ray3df), HIT_OR_MISS);
+  register_benchmark("triangle_intersects_with_context", triangle_intersects_with_context, sizeof(Triangle3df) + sizeof(Ray3df), HIT_OR_MISS);
+  register_benchmark("aabb_intersects_ray", aabb_intersects_ray, sizeof(AABB3df) + sizeof(Ray3df), HIT_OR_MISS);
+  register_benchmark("aabb_intersects_aabb", aabb_intersects_aabb, 2 * sizeof(AABB3df), HIT_OR_MISS);
+  register_benchmark("refract", refract_direction, 2 * sizeof(Vector3df), TRANSMISSION_OR_REFLECTION);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -268,6 +268,85 @@ TEST(SPHERE, NotInside_1) {
   EXPECT_FALSE( sphere.inside( Vector3df{-0.5f, 0.0f, 0.0f}) );
 }
 
+TEST(SPHERE, BoundingBox3df) {
+  Sphere3df sphere = { {1.0f, 2.0f, 3.0f}, 2.0f };
+  AABB3df box = sphere.get_bounding_box();
+
+  EXPECT_NEAR( 1.0, box.get_center()[0], 0.000001 );
+  EXPECT_NEAR( 3.0, box.get_center()[2], 0.000001 );
+  EXPECT_NEAR( 2.0, box.get_half_edge_length()[0], 0.000001 );
+  EXPECT_NEAR( 2.0, box.get_half_edge_length()[2], 0.000001 );
+}
+
+TEST(PLANE, Intersects3dfWithRay_1) {
+  Plane3df plane = { {0.0f, -10.0f, 0.0f}, {0.0f, 1.0f, 0.0f} };
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {0.0f, -2.0f, 0.0f} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_TRUE( plane.intersects(ray, context) );
+  EXPECT_NEAR( 5.0, context.t, 0.000001 );
+  EXPECT_NEAR(-10.0, context.intersection[1], 0.000001 );
+  EXPECT_NEAR( 1.0, context.normal[1], 0.000001 );
+}
+
+TEST(PLANE, Intersects3dfWithRayFromBehind) {
+  Plane3df plane = { {0.0f, 0.0f, -50.0f}, {0.0f, 0.0f, 1.0f} };
+  Ray3df ray{ {1.0f, 2.0f, -60.0f}, {0.0f, 0.0f, 1.0f} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_TRUE( plane.intersects(ray, context) );
+  EXPECT_NEAR( 10.0, context.t, 0.000001 );
+  EXPECT_NEAR(-1.0, context.normal[2], 0.000001 );
+}
+
+TEST(PLANE, NotIntersects3dfWithRay) {
+  Plane3df plane = { {0.0f, -10.0f, 0.0f}, {0.0f, 1.0f, 0.0f} };
+  Ray3df parallel{ {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} };
+  Ray3df away{ {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f} };
+
+  EXPECT_NEAR( 0.0, plane.intersects(parallel), 0.000001 );
+  EXPECT_NEAR( 0.0, plane.intersects(away), 0.000001 );
+}
+
+TEST(PLANE, BoundingBox3df) {
+  Plane3df plane = { {0.0f, -10.0f, 0.0f}, {0.0f, 3.0f, 0.0f} };
+  AABB3df box = plane.get_bounding_box();
+
+  EXPECT_NEAR( 0.0, box.get_half_edge_length()[1], 0.000001 );
+  EXPECT_TRUE( std::isinf(box.get_half_edge_length()[0]) );
+}
+
+TEST(BOX, Intersects3dfWithRay_1) {
+  Box3df box = { {0.0f, 0.0f, -5.0f}, {1.0f, 2.0f, 1.0f} };
+  Ray3df ray{ {0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, -1.0f} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_TRUE( box.intersects(ray, context) );
+  EXPECT_NEAR( 4.0, context.t, 0.000001 );
+  EXPECT_NEAR(-4.0, context.intersection[2], 0.000001 );
+  EXPECT_NEAR( 0.0, context.normal[0], 0.000001 );
+  EXPECT_NEAR( 1.0, context.normal[2], 0.000001 );
+}
+
+TEST(BOX, Intersects3dfWithRayFromInside) {
+  Box3df box = { {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f} };
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f} };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_TRUE( box.intersects(ray, context) );
+  EXPECT_NEAR( 0.5, context.t, 0.000001 );
+  EXPECT_NEAR(-1.0, context.normal[0], 0.000001 );
+}
+
+TEST(BOX, NotIntersects3dfWithRay) {
+  Box3df box = { {0.0f, 0.0f, -5.0f}, {1.0f, 1.0f, 1.0f} };
+  Ray3df miss{ {3.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f} };
+  Ray3df behind{ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+
+  EXPECT_NEAR( 0.0, box.intersects(miss), 0.000001 );
+  EXPECT_NEAR( 0.0, box.intersects(behind), 0.000001 );
+}
+
     TEST(TRIANGLE, Intersects3dfWithRay_1) {
         Triangle3df triangle = { {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0}  };
         Ray3df ray{ {0.0, 0.0, 2.0}, {0.0, 0.0, -1.0} };
@@ -481,6 +560,17 @@ TEST(SPHERE, NotInside_1) {
     }
 
 
+// evaluated at compile time
+    TEST(SPHERE, ConstexprIntersects3dfWithRay) {
+        constexpr Sphere3df sphere = { {0.0f, 0.0f, -5.0f}, 1.0f };
+        constexpr Ray3df ray = { {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f} };
+        constexpr float t = sphere.intersects(ray);
+        static_assert(t > 3.99f && t < 4.01f);
+        static_assert(sphere.inside({0.0f, 0.5f, -5.0f}));
+        EXPECT_NEAR(4.0, t, 0.00001);
+    }
+
+
 // -------------------------------------------
 
 
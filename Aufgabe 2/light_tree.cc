@@ -0,0 +1,7 @@
+#include "light_tree.h"
+#include "light_tree.tcc"
+
+// contains template instantiations for the lights of the raytracer
+
+template struct PointLight<float, 3u>;
+template class LightTree<float, 3u>;
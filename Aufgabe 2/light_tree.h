@@ -0,0 +1,56 @@
+#ifndef LIGHT_TREE_H
+#define LIGHT_TREE_H
+
+#include "math.h"
+#include <vector>
+
+// a point light, its contribution to a surface point x with normal n is
+//   intensity * max(0, n * (position - x)) / |position - x|^3
+// i.e. the cosine of the angle of incidence with an inverse square falloff
+template <class FLOAT, size_t N>
+struct PointLight {
+  Vector<FLOAT, N> position;
+  FLOAT intensity;
+};
+
+
+// a binary tree (light BVH) over point lights for scenes with many lights
+// sample() draws a light with a probability proportional to the estimated contribution of the
+// lights of each subtree (their total intensity over the squared distance to their bounding box),
+// subtrees lying completely behind the surface are never drawn. Weighting the contribution of
+// the drawn light with 1 / pdf estimates the sum of the contributions of all lights
+template <class FLOAT, size_t N>
+class LightTree {
+  struct Node {
+    Vector<FLOAT, N> lower, upper; // bounds of the positions of the lights of the subtree
+    FLOAT intensity = 0.0;         // total intensity of the lights of the subtree
+    int left = -1, right = -1;     // children, -1 in a leaf
+    int light = -1;                // index of the light of a leaf, -1 in inner nodes
+  };
+
+  std::vector<PointLight<FLOAT, N>> lights;
+  std::vector<Node> nodes;
+
+  // splits the lights at the median of the longest axis of their bounds, returns the index of the node
+  int build(std::vector<int> & indices, size_t begin, size_t end);
+
+  // estimated contribution of the lights of node to point with normal, 0 if they are all behind the surface
+  FLOAT importance(const Node & node, Vector<FLOAT, N> point, Vector<FLOAT, N> normal) const;
+
+public:
+  LightTree(std::vector<PointLight<FLOAT, N>> lights);
+
+  const std::vector<PointLight<FLOAT, N>> & get_lights() const;
+
+  size_t size() const;
+
+  // draws a light for point with normal with a random number in [0, 1), pdf is set to the probability
+  // of drawing it. Returns nullptr if no light can illuminate the point
+  const PointLight<FLOAT, N> * sample(Vector<FLOAT, N> point, Vector<FLOAT, N> normal, FLOAT random, FLOAT & pdf) const;
+};
+
+
+typedef PointLight<float, 3u> PointLight3df;
+typedef LightTree<float, 3u> LightTree3df;
+
+#endif
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+template <class FLOAT, size_t N>
+LightTree<FLOAT, N>::LightTree(std::vector<PointLight<FLOAT, N>> lights)
+  : lights(std::move(lights))
+{
+  if (!this->lights.empty()) {
+    std::vector<int> indices(this->lights.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+      indices[i] = i;
+    }
+    nodes.reserve(2 * this->lights.size());
+    build(indices, 0, indices.size());
+  }
+}
+
+template <class FLOAT, size_t N>
+int LightTree<FLOAT, N>::build(std::vector<int> & indices, size_t begin, size_t end) {
+  Node node;
+  node.lower = lights[indices[begin]].position;
+  node.upper = lights[indices[begin]].position;
+  for (size_t i = begin; i < end; i++) {
+    const PointLight<FLOAT, N> & light = lights[indices[i]];
+    for (size_t axis = 0; axis < N; axis++) {
+      node.lower[axis] = std::min(node.lower[axis], light.position[axis]);
+      node.upper[axis] = std::max(node.upper[axis], light.position[axis]);
+    }
+    node.intensity += light.intensity;
+  }
+
+  int index = nodes.size();
+  nodes.push_back(node);
+  if (end - begin == 1) {
+    nodes[index].light = indices[begin];
+    return index;
+  }
+
+  size_t axis = 0;
+  for (size_t i = 1; i < N; i++) {
+    if (node.upper[i] - node.lower[i] > node.upper[axis] - node.lower[axis]) {
+      axis = i;
+    }
+  }
+  size_t middle = begin + (end - begin) / 2;
+  std::nth_element(indices.begin() + begin, indices.begin() + middle, indices.begin() + end,
+                   [&](int a, int b) { return lights[a].position[axis] < lights[b].position[axis]; });
+
+  int left = build(indices, begin, middle);
+  int right = build(indices, middle, end);
+  nodes[index].left = left;
+  nodes[index].right = right;
+  return index;
+}
+
+template <class FLOAT, size_t N>
+FLOAT LightTree<FLOAT, N>::importance(const Node & node, Vector<FLOAT, N> point, Vector<FLOAT, N> normal) const {
+  // the cosine bound is the largest n * (position - point) over the box, the squared distance
+  // the one of the nearest point of the box, at least its squared half diagonal for a box around point
+  FLOAT square_of_distance = 0.0;
+  FLOAT square_of_half = 0.0;
+  FLOAT max_cos = 0.0;
+  for (size_t axis = 0; axis < N; axis++) {
+    FLOAT center = 0.5f * (node.lower[axis] + node.upper[axis]);
+    FLOAT half = 0.5f * (node.upper[axis] - node.lower[axis]);
+    FLOAT d = std::max<FLOAT>(0.0, std::fabs(point[axis] - center) - half);
+    square_of_distance += d * d;
+    square_of_half += half * half;
+    max_cos += normal[axis] * (center - point[axis]) + std::fabs(normal[axis]) * half;
+  }
+  if (max_cos <= 0.0) {
+    return 0.0;
+  }
+  return node.intensity / std::max<FLOAT>({square_of_distance, square_of_half, 1e-4f});
+}
+
+template <class FLOAT, size_t N>
+const std::vector<PointLight<FLOAT, N>> & LightTree<FLOAT, N>::get_lights() const {
+  return lights;
+}
+
+template <class FLOAT, size_t N>
+size_t LightTree<FLOAT, N>::size() const {
+  return lights.size();
+}
+
+template <class FLOAT, size_t N>
+const PointLight<FLOAT, N> * LightTree<FLOAT, N>::sample(Vector<FLOAT, N> point, Vector<FLOAT, N> normal, FLOAT random, FLOAT & pdf) const {
+  pdf = 1.0;
+  if (nodes.empty()) {
+    return nullptr;
+  }
+  int index = 0;
+  while (nodes[index].light < 0) {
+    FLOAT w_left = importance(nodes[nodes[index].left], point, normal);
+    FLOAT w_right = importance(nodes[nodes[index].right], point, normal);
+    if (w_left + w_right <= 0.0) {
+      return nullptr;
+    }
+    // the random number is rescaled to [0, 1) within the chosen child for the next decision
+    FLOAT p_left = w_left / (w_left + w_right);
+    if (random < p_left || w_right <= 0.0) {
+      index = nodes[index].left;
+      pdf *= p_left;
+      random = random / p_left;
+    } else {
+      index = nodes[index].right;
+      pdf *= 1.0f - p_left;
+      random = (random - p_left) / (1.0f - p_left);
+    }
+  }
+  return &lights[nodes[index].light];
+}
@@ -0,0 +1,83 @@
+#include "light_tree.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+
+namespace {
+
+std::vector<PointLight3df> random_lights(size_t count) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> intensity(0.5f, 2.0f);
+  std::vector<PointLight3df> lights;
+  for (size_t i = 0; i < count; i++) {
+    lights.push_back( PointLight3df{ {position(generator), position(generator), position(generator)}, intensity(generator) } );
+  }
+  return lights;
+}
+
+// the unshadowed contribution of light to point with normal, see PointLight
+double contribution(const PointLight3df & light, Vector3df point, Vector3df normal) {
+  Vector3df to_light = light.position - point;
+  double cos_angle = normal * to_light;
+  if (cos_angle <= 0.0) {
+    return 0.0;
+  }
+  double distance = to_light.length();
+  return light.intensity * cos_angle / (distance * distance * distance);
+}
+
+TEST(LIGHT_TREE, SampledEstimateAveragesToSumOverAllLights) {
+  std::vector<PointLight3df> lights = random_lights(1000);
+  LightTree3df tree(lights);
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> random(0.0f, 1.0f);
+
+  for (Vector3df point : {Vector3df{0.0f, 0.0f, 0.0f}, Vector3df{5.0f, -3.0f, 2.0f}, Vector3df{0.0f, -12.0f, 0.0f}}) {
+    Vector3df normal = {0.0f, 1.0f, 0.0f};
+    double sum = 0.0;
+    for (const PointLight3df & light : lights) {
+      sum += contribution(light, point, normal);
+    }
+
+    const size_t samples = 100000;
+    double estimate = 0.0;
+    for (size_t i = 0; i < samples; i++) {
+      float pdf;
+      const PointLight3df * light = tree.sample(point, normal, random(generator), pdf);
+      ASSERT_NE(nullptr, light);
+      ASSERT_GT(pdf, 0.0f);
+      estimate += contribution(*light, point, normal) / pdf;
+    }
+    estimate /= samples;
+
+    EXPECT_GT(sum, 0.0);
+    EXPECT_NEAR(sum, estimate, 0.02 * sum);
+  }
+}
+
+TEST(LIGHT_TREE, LightsBehindTheSurfaceAreNotSampled) {
+  std::vector<PointLight3df> lights = random_lights(100);
+  LightTree3df tree(lights);
+  Vector3df normal = {0.0f, 1.0f, 0.0f};
+  float pdf;
+
+  // all lights are below y = 10
+  EXPECT_EQ(nullptr, tree.sample({0.0f, 10.0f, 0.0f}, normal, 0.5f, pdf));
+
+  for (float random = 0.0f; random < 1.0f; random += 0.01f) {
+    const PointLight3df * light = tree.sample({0.0f, 5.0f, 0.0f}, normal, random, pdf);
+    ASSERT_NE(nullptr, light);
+    EXPECT_GT(light->position[1], 5.0f);
+  }
+}
+
+TEST(LIGHT_TREE, SingleLight) {
+  LightTree3df tree( { PointLight3df{ {0.0f, 8.0f, 0.0f}, 1.0f } } );
+  float pdf = 0.0f;
+
+  EXPECT_NE(nullptr, tree.sample({0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.3f, pdf));
+  EXPECT_EQ(1.0f, pdf);
+}
+
+}
@@ -2,64 +2,12 @@
 
 #include <random>
 
-template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) {
-  auto iterator = values.begin();
-  for (size_t i = 0u; i < N; i++) {
-    if ( iterator != values.end()) {
-      vector[i] = *iterator++;
-    } else {
-      vector[i] = (i > 0 ? vector[i - 1] : 0.0);
-    }
-  }
-}
 
 template <class FLOAT_TYPE, size_t N>
 Vector<FLOAT_TYPE, N>::Vector(FLOAT_TYPE angle ) {
-  *this = { static_cast<FLOAT_TYPE>( cos(angle) ), static_cast<FLOAT_TYPE>(sin(angle)) };
-}
-
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] += addend.vector[i];
-  }
-  return *this;
-}
-
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] -= minuend.vector[i];
-  }
-  return *this;
+  *this = { cosine(angle), sine(angle) };
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] *= factor;
-  }
-  return *this;
-}
-
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] /= factor;
-  }
-  return *this;
-}
-
-
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
-  Vector<FLOAT_TYPE, N> scalar_product = value;
-
-  scalar_product *= scalar;
-
-  return scalar_product;
-}
 
 // ----------------------------------------------------------------------------
 // neue Methode für Raytracing Aufgabe
@@ -78,97 +26,230 @@ Vector<FLOAT_TYPE, N> operator/(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value)
 // ----------------------------------------------------------------------------
 
 
-
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
-  Vector<FLOAT_TYPE, N> sum = value;
-  sum += addend;
-  return sum;
+template <class FLOAT_TYPE, size_t N>
+FLOAT_TYPE Vector<FLOAT_TYPE, N>::angle(size_t axis_1, size_t axis_2) const {
+  Vector<FLOAT_TYPE, N> normalized = (1.0f / length()) * *this;
+  return atan2( normalized[axis_2], normalized[axis_1] );
 }
 
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
-  Vector<FLOAT_TYPE, N> difference = value;
-  difference -= minuend;
-  return difference;
-}
 
-template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
-  return vector[i];
+#if defined(__SSE2__)
+// ----------------------------------------------------------------------------
+// SSE implementation of Vector<float, 3> and Vector<float, 4>
+// (the constexpr members are defined in math.h)
+
+template <size_t N> requires sse_dimension<N>
+Vector<float, N>::Vector(float angle ) {
+  *this = { cosine(angle), sine(angle) };
 }
 
-template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
-  return vector[i];
+template <size_t N> requires sse_dimension<N>
+float Vector<float, N>::angle(size_t axis_1, size_t axis_2) const {
+  Vector<float, N> normalized = (1.0f / length()) * *this;
+  return atan2( normalized[axis_2], normalized[axis_1] );
 }
 
+// ----------------------------------------------------------------------------
+#endif
 
-template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
-  assert(N >= 3u);
-  return {this->vector[1] * v.vector[2] - this->vector[2] * v.vector[1],
-          this->vector[0] * v.vector[2] - this->vector[2] * v.vector[0],
-          this->vector[0] * v.vector[1] - this->vector[1] * v.vector[0] };
-}
 
+// ----------------------------------------------------------------------------
+// Matrix
+// (the constexpr members are defined in math.h)
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::rotation(FLOAT_TYPE angle) requires is_affine && (D >= 2u) {
+  Matrix<FLOAT_TYPE, R, C> rotation = identity();
+  FLOAT_TYPE cos_angle = cosine(angle);
+  FLOAT_TYPE sin_angle = sine(angle);
+  rotation.rows[0][0] = cos_angle;
+  rotation.rows[0][1] = -sin_angle;
+  rotation.rows[1][0] = sin_angle;
+  rotation.rows[1][1] = cos_angle;
+  return rotation;
+}
 
-// neue Methoden!!!!
-// Länge eines Vektors: Vektor v-> = (1 2 3),
-// Länge = Betrag von v-> = Wurzel von (1^2 + 2^2 + 3^2)
-template <class FLOAT_TYPE, size_t N>
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::length() const {
-    /*FLOAT_TYPE sum_of_squares = 0.0;
-    for (size_t i = 0u; i < N; i++) {
-        sum_of_squares += vector[i] * vector[i];
-    }
-    return sqrt(sum_of_squares);*/
-    return std::sqrt(square_of_length());
+// Rodrigues' rotation formula
+template <class FLOAT_TYPE, size_t R, size_t C>
+Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::rotation(Vector<FLOAT_TYPE, 3u> axis, FLOAT_TYPE angle) requires is_affine && (D == 3u) {
+  Matrix<FLOAT_TYPE, R, C> rotation = identity();
+  FLOAT_TYPE cos_angle = cosine(angle);
+  FLOAT_TYPE sin_angle = sine(angle);
+  FLOAT_TYPE x = axis[0], y = axis[1], z = axis[2];
+  rotation.rows[0][0] = cos_angle + x * x * (1 - cos_angle);
+  rotation.rows[0][1] = x * y * (1 - cos_angle) - z * sin_angle;
+  rotation.rows[0][2] = x * z * (1 - cos_angle) + y * sin_angle;
+  rotation.rows[1][0] = y * x * (1 - cos_angle) + z * sin_angle;
+  rotation.rows[1][1] = cos_angle + y * y * (1 - cos_angle);
+  rotation.rows[1][2] = y * z * (1 - cos_angle) - x * sin_angle;
+  rotation.rows[2][0] = z * x * (1 - cos_angle) - y * sin_angle;
+  rotation.rows[2][1] = z * y * (1 - cos_angle) + x * sin_angle;
+  rotation.rows[2][2] = cos_angle + z * z * (1 - cos_angle);
+  return rotation;
 }
 
-template <class FLOAT_TYPE, size_t N>
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const {
-    FLOAT_TYPE sum_of_squares = 0.0;
-    for (size_t i = 0u; i < N; i++) {
-        sum_of_squares += vector[i] * vector[i];
+// Gaussian elimination with partial pivoting, the determinant is the product of the pivots
+template <class FLOAT_TYPE, size_t R, size_t C>
+FLOAT_TYPE Matrix<FLOAT_TYPE, R, C>::determinant() const requires (R == C) {
+  Matrix<FLOAT_TYPE, R, C> matrix = *this;
+  FLOAT_TYPE determinant = 1.0;
+  for (size_t k = 0; k < R; k++) {
+    size_t pivot = k;
+    for (size_t i = k + 1; i < R; i++) {
+      if (std::fabs(matrix.rows[i][k]) > std::fabs(matrix.rows[pivot][k])) {
+        pivot = i;
+      }
+    }
+    if (matrix.rows[pivot][k] == 0.0) {
+      return 0.0;
     }
-    return sum_of_squares;
+    if (pivot != k) {
+      std::swap(matrix.rows[pivot], matrix.rows[k]);
+      determinant = -determinant;
+    }
+    determinant *= matrix.rows[k][k];
+    for (size_t i = k + 1; i < R; i++) {
+      matrix.rows[i] -= (matrix.rows[i][k] / matrix.rows[k][k]) * matrix.rows[k];
+    }
+  }
+  return determinant;
 }
 
-// Skalarprodukt zweier Vektoren:
-// a-> * b-> = (a1 a2 a3) * (b1 b2 b3)
-template <class FLOAT_TYPE, size_t N>
-FLOAT_TYPE operator*(Vector<FLOAT_TYPE, N> vector1, const Vector<FLOAT_TYPE, N> vector2) {
-    FLOAT_TYPE scalar_product = 0.0;
-    for (size_t i = 0u; i < N; i++) {
-        scalar_product += vector1[i] * vector2[i];
+// Gauss-Jordan elimination of the left R x R part, all row operations are applied to
+// the identity, too. For an affine R x (R + 1) Matrix (A | t) the eliminated Matrix is
+// (I | A^-1 t) and the identity becomes (A^-1 | 0), so the inverse is (A^-1 | -A^-1 t).
+template <class FLOAT_TYPE, size_t R, size_t C>
+Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::inverse() const requires is_affine {
+  Matrix<FLOAT_TYPE, R, C> matrix = *this;
+  Matrix<FLOAT_TYPE, R, C> inverse = identity();
+  for (size_t k = 0; k < R; k++) {
+    size_t pivot = k;
+    for (size_t i = k + 1; i < R; i++) {
+      if (std::fabs(matrix.rows[i][k]) > std::fabs(matrix.rows[pivot][k])) {
+        pivot = i;
+      }
+    }
+    std::swap(matrix.rows[pivot], matrix.rows[k]);
+    std::swap(inverse.rows[pivot], inverse.rows[k]);
+
+    FLOAT_TYPE factor = 1.0 / matrix.rows[k][k];
+    matrix.rows[k] *= factor;
+    inverse.rows[k] *= factor;
+    for (size_t i = 0; i < R; i++) {
+      if (i != k) {
+        factor = matrix.rows[i][k];
+        matrix.rows[i] -= factor * matrix.rows[k];
+        inverse.rows[i] -= factor * inverse.rows[k];
+      }
     }
-    return scalar_product;
+  }
+  if constexpr (C == R + 1u) {
+    for (size_t i = 0; i < R; i++) {
+      inverse.rows[i][R] = -matrix.rows[i][R];
+    }
+  }
+  return inverse;
 }
 
+template <class FLOAT_TYPE, size_t R, size_t C>
+Vector<FLOAT_TYPE, Matrix<FLOAT_TYPE, R, C>::D> Matrix<FLOAT_TYPE, R, C>::transform_point(Vector<FLOAT_TYPE, D> point) const requires is_affine {
+  Vector<FLOAT_TYPE, C> homogeneous;
+  for (size_t j = 0; j < D; j++) {
+    homogeneous[j] = point[j];
+  }
+  homogeneous[D] = 1.0;
+  Vector<FLOAT_TYPE, D> transformed;
+  for (size_t i = 0; i < D; i++) {
+    transformed[i] = rows[i] * homogeneous;
+  }
+  return transformed;
+}
 
+template <class FLOAT_TYPE, size_t R, size_t C>
+Vector<FLOAT_TYPE, Matrix<FLOAT_TYPE, R, C>::D> Matrix<FLOAT_TYPE, R, C>::transform_direction(Vector<FLOAT_TYPE, D> direction) const requires is_affine {
+  Vector<FLOAT_TYPE, C> homogeneous;
+  for (size_t j = 0; j < D; j++) {
+    homogeneous[j] = direction[j];
+  }
+  Vector<FLOAT_TYPE, D> transformed;
+  for (size_t i = 0; i < D; i++) {
+    transformed[i] = rows[i] * homogeneous;
+  }
+  return transformed;
+}
 
+// the columns are extracted once, then each point is the sum of the columns weighted by its
+// components, i.e. D multiplications and additions of whole Vectors per point
+template <class FLOAT_TYPE, size_t R, size_t C>
+void Matrix<FLOAT_TYPE, R, C>::transform_points(std::span<const Vector<FLOAT_TYPE, D>> points, std::span<Vector<FLOAT_TYPE, D>> transformed) const requires is_affine {
+  assert(transformed.size() >= points.size());
+  std::array<Vector<FLOAT_TYPE, D>, C> columns;
+  for (size_t j = 0; j < C; j++) {
+    for (size_t i = 0; i < D; i++) {
+      columns[j][i] = rows[i][j];
+    }
+  }
+  for (size_t p = 0; p < points.size(); p++) {
+    Vector<FLOAT_TYPE, D> point = points[p];
+    Vector<FLOAT_TYPE, D> result = columns[D];
+    for (size_t j = 0; j < D; j++) {
+      result += point[j] * columns[j];
+    }
+    transformed[p] = result;
+  }
+}
 
-
-
-
-template <class FLOAT_TYPE, size_t N>
-void Vector<FLOAT_TYPE, N>::normalize() {
-  *this /= length(); //  +/- INFINITY if length is (near to) zero
+template <class FLOAT_TYPE, size_t R, size_t C>
+void Matrix<FLOAT_TYPE, R, C>::transform_directions(std::span<const Vector<FLOAT_TYPE, D>> directions, std::span<Vector<FLOAT_TYPE, D>> transformed) const requires is_affine {
+  assert(transformed.size() >= directions.size());
+  std::array<Vector<FLOAT_TYPE, D>, D> columns;
+  for (size_t j = 0; j < D; j++) {
+    for (size_t i = 0; i < D; i++) {
+      columns[j][i] = rows[i][j];
+    }
+  }
+  for (size_t p = 0; p < directions.size(); p++) {
+    Vector<FLOAT_TYPE, D> direction = directions[p];
+    Vector<FLOAT_TYPE, D> result;
+    for (size_t j = 0; j < D; j++) {
+      result += direction[j] * columns[j];
+    }
+    transformed[p] = result;
+  }
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
-  assert(0.99999 < normal.square_of_length() && normal.square_of_length()  < 1.000001); 
-  return *this - static_cast<FLOAT_TYPE>(2.0) * (*this * normal ) * normal;
+// row i of the product is the sum of the rows of right weighted by row i of left
+template <class FLOAT_TYPE, size_t R, size_t K, size_t C>
+Matrix<FLOAT_TYPE, R, C> operator*(const Matrix<FLOAT_TYPE, R, K> & left, const Matrix<FLOAT_TYPE, K, C> & right) {
+  Matrix<FLOAT_TYPE, R, C> product;
+  for (size_t i = 0; i < R; i++) {
+    for (size_t k = 0; k < K; k++) {
+      product[i] += left[i][k] * right[k];
+    }
+  }
+  return product;
 }
 
-template <class FLOAT_TYPE, size_t N>
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::angle(size_t axis_1, size_t axis_2) const {
-  Vector<FLOAT_TYPE, N> normalized = (1.0f / length()) * *this;
-  return atan2( normalized[axis_2], normalized[axis_1] );
+template <class FLOAT_TYPE, size_t R>
+Matrix<FLOAT_TYPE, R, R + 1u> operator*(const Matrix<FLOAT_TYPE, R, R + 1u> & left, const Matrix<FLOAT_TYPE, R, R + 1u> & right) {
+  Matrix<FLOAT_TYPE, R, R + 1u> product;
+  for (size_t i = 0; i < R; i++) {
+    for (size_t k = 0; k < R; k++) {
+      product[i] += left[i][k] * right[k];
+    }
+    product[i][R] += left[i][R]; // the implicit row (0, ..., 0, 1) of right
+  }
+  return product;
 }
 
+template <class FLOAT_TYPE, size_t R, size_t C>
+Vector<FLOAT_TYPE, R> operator*(const Matrix<FLOAT_TYPE, R, C> & matrix, const Vector<FLOAT_TYPE, C> value) {
+  Vector<FLOAT_TYPE, R> product;
+  for (size_t i = 0; i < R; i++) {
+    product[i] = matrix[i] * value;
+  }
+  return product;
+}
 
 
 // -------------------------------
@@ -194,7 +275,6 @@ inline float random_float(float min, float max) {
 }
 
 
-
 /*
 static Vector3df random() {
     return Vector3df{random_float(), random_float(), random_float()};
@@ -0,0 +1,116 @@
+#include "math.h"
+#include "bench.h"
+
+// microbenchmarks of the Vector operations, see bench.h
+
+namespace {
+
+// b has length 1, as get_reflective needs a normal
+struct Vector_Pairs {
+  std::vector<Vector3df> a, b;
+};
+
+Vector_Pairs generate_vector_pairs(size_t size, size_t) {
+  Vector_Pairs pairs;
+  for (size_t i = 0; i < size; i++) {
+    pairs.a.push_back(random_vector<3>(10.0f));
+    pairs.b.push_back(random_direction<3>());
+  }
+  return pairs;
+}
+
+// runs operation(a[i], b[i]) for all pairs of the data set
+template <class OPERATION>
+void over_vector_pairs(benchmark::State & state, OPERATION operation) {
+  const Vector_Pairs & pairs = data_set<Vector_Pairs>("vector_pairs", state, generate_vector_pairs);
+  const size_t size = pairs.a.size();
+  for (auto _ : state) {
+    for (size_t i = 0; i < size; i++) {
+      auto result = operation(pairs.a[i], pairs.b[i]);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  report_operations(state, size);
+}
+
+void vector_sum(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return Vector3df(a + b); });
+}
+
+void vector_difference(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return Vector3df(a - b); });
+}
+
+void vector_scalar_multiplication(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return Vector3df(b[0] * a); });
+}
+
+void vector_multiply_add(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return Vector3df(a + 0.5f * b); });
+}
+
+void vector_scalar_product(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return a * b; });
+}
+
+void vector_cross_product(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return a.cross_product(b); });
+}
+
+void vector_square_of_length(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df) { return a.square_of_length(); });
+}
+
+void vector_length(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df) { return a.length(); });
+}
+
+void vector_normalize(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df) { a.normalize(); return a; });
+}
+
+void vector_get_reflective(benchmark::State & state) {
+  over_vector_pairs(state, [](Vector3df a, Vector3df b) { return a.get_reflective(b); });
+}
+
+std::vector<float> generate_angles(size_t size, size_t) {
+  std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+  std::vector<float> angles;
+  for (size_t i = 0; i < size; i++) {
+    angles.push_back(distribution(random_generator()));
+  }
+  return angles;
+}
+
+void vector_from_angle(benchmark::State & state) {
+  const std::vector<float> & angles = data_set<std::vector<float>>("angles", state, generate_angles);
+  for (auto _ : state) {
+    for (float angle : angles) {
+      Vector2df direction(angle);
+      benchmark::DoNotOptimize(direction);
+    }
+  }
+  report_operations(state, angles.size());
+}
+
+}
+
+int main(int argc, char ** argv) {
+  const size_t pair_bytes = 2 * sizeof(Vector3df);
+  register_benchmark("vector_sum", vector_sum, pair_bytes);
+  register_benchmark("vector_difference", vector_difference, pair_bytes);
+  register_benchmark("vector_scalar_multiplication", vector_scalar_multiplication, pair_bytes);
+  register_benchmark("vector_multiply_add", vector_multiply_add, pair_bytes);
+  register_benchmark("vector_scalar_product", vector_scalar_product, pair_bytes);
+  register_benchmark("vector_cross_product", vector_cross_product, pair_bytes);
+  register_benchmark("vector_square_of_length", vector_square_of_length, pair_bytes);
+  register_benchmark("vector_length", vector_length, pair_bytes);
+  register_benchmark("vector_normalize", vector_normalize, pair_bytes);
+  register_benchmark("vector_get_reflective", vector_get_reflective, pair_bytes);
+  register_benchmark("vector_from_angle", vector_from_angle, sizeof(float));
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
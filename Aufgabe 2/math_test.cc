@@ -297,6 +297,37 @@ TEST(VECTOR, ScalarVectorProduct3df_3) {
   EXPECT_NEAR(20.0, vector1 * vector2, 0.00001);
 }
 
+TEST(VECTOR, ScalarVectorProduct4df) {
+  Vector4df vector1 = {1.0, -2.0, 3.0, 4.0};
+  Vector4df vector2 = {2.0,  1.0, 1.0, 0.5};
+  
+  EXPECT_NEAR(5.0, vector1 * vector2, 0.00001);
+}
+
+TEST(VECTOR, ExpressionChain3df) {
+  Vector3df a = {1.0, 2.0, 3.0};
+  Vector3df b = {0.5, 0.0, -1.0};
+  Vector3df c = {2.0, 2.0, 2.0};
+  Vector3df result = a + 2.0f * b - 0.5f * (a - c);
+  
+  EXPECT_NEAR(2.5, result[0], 0.00001);
+  EXPECT_NEAR(2.0, result[1], 0.00001);
+  EXPECT_NEAR(0.5, result[2], 0.00001);
+  EXPECT_NEAR(0.5, (a - b - c) * Vector3df({1.0, 1.0, 1.0}), 0.00001);
+  EXPECT_NEAR(std::sqrt(2.0), (a - b - c + b).length(), 0.00001);
+}
+
+TEST(VECTOR, Normalize3dfScaledByZero) {
+  Vector3df vector = {0.0, 3.0, 4.0};
+  vector *= 0.0f;
+  vector += Vector3df{0.0, 3.0, 4.0};
+  vector.normalize();
+  
+  EXPECT_NEAR(1.0, vector.length(), 0.00001);
+  EXPECT_NEAR(0.6, vector[1], 0.00001);
+  EXPECT_NEAR(0.8, vector[2], 0.00001);
+}
+
 
 TEST(VECTOR, CrossVectorProduct1) {
   Vector3df vector1 = {1.0, 0.0, 0.0};
@@ -320,7 +351,7 @@ TEST(VECTOR, CrossVectorProduct2) {
   EXPECT_NEAR(3.0,  vector2[1], 0.00001);
   EXPECT_NEAR(0.0, vector2[2], 0.00001);
   EXPECT_NEAR(6.0, cross[0], 0.00001);
-  EXPECT_NEAR(-6.0,  cross[1], 0.00001);
+  EXPECT_NEAR(6.0,  cross[1], 0.00001);
   EXPECT_NEAR(-3.0, cross[2], 0.00001);
 }
 
@@ -336,7 +367,7 @@ TEST(VECTOR, CrossVectorProduct3) {
   EXPECT_NEAR(0.0,  vector2[1], 0.00001);
   EXPECT_NEAR(-2.0, vector2[2], 0.00001);
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(10.0,  cross[1], 0.00001);
+  EXPECT_NEAR(-10.0,  cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -353,7 +384,7 @@ TEST(VECTOR, CrossVectorProduct4) {
   EXPECT_NEAR(0.0,  vector2[1], 0.00001);
   EXPECT_NEAR(-2.0, vector2[2], 0.00001);
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(-10.0,  cross[1], 0.00001);
+  EXPECT_NEAR(10.0,  cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -376,7 +407,7 @@ TEST(VECTOR, CrossVectorProduct5) {
 
   
   EXPECT_NEAR(0.0,  cross[0], 0.00001);
-  EXPECT_NEAR(10.0, cross[1], 0.00001);
+  EXPECT_NEAR(-10.0, cross[1], 0.00001);
   EXPECT_NEAR(0.0,  cross[2], 0.00001);
 }
 
@@ -386,7 +417,7 @@ TEST(VECTOR, CrossVectorProduct6) {
   Vector3df cross = vector1.cross_product(vector2);
   
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(1.0, cross[1], 0.00001);
+  EXPECT_NEAR(-1.0, cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -499,4 +530,103 @@ EXPECT_NEAR(1.0, cross[2], 0.00001);
 
 
 
+TEST(VECTOR, Constexpr3df) {
+constexpr Vector3df vector1 = {3.0, 0.0, 4.0};
+constexpr Vector3df vector2 = {1.0, 2.0, 3.0};
+constexpr Vector3df sum = vector1 + vector2;
+constexpr float dot = vector1 * vector2;
+constexpr float length = vector1.length();
+static_assert(sum[0] == 4.0f && sum[1] == 2.0f && sum[2] == 7.0f);
+static_assert(dot == 15.0f);
+static_assert(length > 4.9999f && length < 5.0001f); // exact unless MATH_FAST_APPROXIMATIONS is defined
+
+EXPECT_NEAR(5.0, length, 0.00001);
+EXPECT_NEAR(15.0, dot, 0.00001);
+}
+
+
+TEST(FAST_MATH, ReciprocalSquareRoot) {
+for (float x = 1e-6f; x < 1e6f; x *= 1.37f) {
+  EXPECT_NEAR(1.0, fast_reciprocal_square_root(x) * std::sqrt(x), 1e-6);
+}
+for (double x = 1e-6; x < 1e6; x *= 1.37) {
+  EXPECT_NEAR(1.0, fast_reciprocal_square_root(x) * std::sqrt(x), 1e-6);
+}
+static_assert(fast_reciprocal_square_root(4.0f) > 0.49999f && fast_reciprocal_square_root(4.0f) < 0.50001f);
+}
+
+TEST(FAST_MATH, SinCos) {
+for (float x = -100.0f; x < 100.0f; x += 0.01f) {
+  EXPECT_NEAR(std::sin(x), fast_sin<float>(x), 1e-6);
+  EXPECT_NEAR(std::cos(x), fast_cos<float>(x), 1e-6);
+}
+}
+
+TEST(MATRIX, Product3x3df) {
+Matrix3x3df matrix1 = { {1.0, 2.0, 3.0}, {0.0, 1.0, 4.0}, {5.0, 6.0, 0.0} };
+Matrix3x3df identity = Matrix3x3df::identity();
+Matrix3x3df product = matrix1 * identity;
+Vector3df value = matrix1 * Vector3df{1.0, 1.0, 1.0};
+
+for (size_t i = 0; i < 3; i++) {
+  for (size_t j = 0; j < 3; j++) {
+    EXPECT_NEAR(matrix1[i][j], product[i][j], 0.00001);
+  }
+}
+EXPECT_NEAR(6.0, value[0], 0.00001);
+EXPECT_NEAR(5.0, value[1], 0.00001);
+EXPECT_NEAR(11.0, value[2], 0.00001);
+EXPECT_NEAR(1.0, matrix1.determinant(), 0.0001);
+}
+
+TEST(MATRIX, Inverse4x4df) {
+Matrix4x4df matrix = { {2.0, 0.0, 1.0, 3.0}, {1.0, 1.0, 0.0, -1.0}, {0.0, 3.0, 1.0, 2.0}, {1.0, 0.0, 0.0, 1.0} };
+Matrix4x4df product = matrix * matrix.inverse();
+
+for (size_t i = 0; i < 4; i++) {
+  for (size_t j = 0; j < 4; j++) {
+    EXPECT_NEAR(i == j ? 1.0 : 0.0, product[i][j], 0.0001);
+  }
+}
+}
+
+TEST(MATRIX, InverseAffine2x3df) {
+Matrix2x3df transformation = Matrix2x3df::translation({3.0, -2.0}) * Matrix2x3df::rotation(0.5) * Matrix2x3df::scaling({2.0, 4.0});
+Vector2df point = {1.0, 2.0};
+Vector2df transformed = transformation.transform_point(point);
+Vector2df back = transformation.inverse().transform_point(transformed);
+
+EXPECT_NEAR(1.0, back[0], 0.00001);
+EXPECT_NEAR(2.0, back[1], 0.00001);
+}
+
+TEST(MATRIX, Rotation2x3df) {
+Matrix2x3df rotation = Matrix2x3df::rotation(PI / 2.0);
+Vector2df point = rotation.transform_point({1.0, 0.0});
+Vector2df direction = (Matrix2x3df::translation({5.0, 5.0}) * rotation).transform_direction({1.0, 0.0});
+
+EXPECT_NEAR(0.0, point[0], 0.00001);
+EXPECT_NEAR(1.0, point[1], 0.00001);
+EXPECT_NEAR(0.0, direction[0], 0.00001);
+EXPECT_NEAR(1.0, direction[1], 0.00001);
+}
+
+TEST(MATRIX, TransformPoints4x4df) {
+Vector3df axis = {1.0, 2.0, 2.0};
+axis.normalize();
+Matrix4x4df transformation = Matrix4x4df::translation({1.0, 2.0, 3.0}) * Matrix4x4df::rotation(axis, 1.0);
+std::array<Vector3df, 3> points = { Vector3df{1.0, 0.0, 0.0}, Vector3df{0.0, -2.0, 5.0}, Vector3df{3.0, 1.0, -1.0} };
+std::array<Vector3df, 3> transformed;
+transformation.transform_points(points, transformed);
+
+for (size_t p = 0; p < points.size(); p++) {
+  Vector3df expected = transformation.transform_point(points[p]);
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(expected[i], transformed[p][i], 0.00001);
+  }
+}
+EXPECT_NEAR(points[1].length(), (transformed[1] - transformation.transform_point({0.0, 0.0, 0.0})).length(), 0.0001);
+}
+
+
 }
@@ -1,9 +1,15 @@
 
 #include "math.h"
 #include "geometry.h"
+#include "acceleration.h"
+#include "light_tree.h"
 #include "math.tcc"
+#include "acceleration.tcc"
 #include <vector>
+#include <variant>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <SDL2/SDL.h>
 
 
@@ -12,18 +18,6 @@
 // haengen hoechstens von den vorhergehenden Datenstrukturen ab, aber nicht umgekehrt.
 
 
-// verschiedene Materialdefinition, z.B. Mattes Schwarz, Mattes Rot, Reflektierendes Weiss, ...
-// im wesentlichen Variablen, die mit Konstruktoraufrufen initialisiert werden.
-#define MATTE_WHITE material{{0.8f, 0.8f, 0.8f}, 0.25f}
-#define MATTE_RED material{{0.8f, 0.3f, 0.3f}, 0.25f}
-#define MATTE_GREEN material{{0.3f, 0.8f, 0.3f}, 0.25f}
-#define MATTE_BLUE material{{0.3f, 0.3f, 0.8f}, 0.25f}
-#define MATTE_BLACK material{{0.2f, 0.2f, 0.2f}, 0.25f}
-
-#define MIRROR material{{0.0f, 0.0f, 0.0f}, 0.25f, 1.0f, 0.9f, false}
-#define GLASS material{{1.0f, 1.0f, 1.0f}, 0.25f, 1.52f, 0.9f, true}
-
-
 // Die folgenden Werte zur konkreten Objekten, Lichtquellen und Funktionen, wie Lambertian-Shading
 // oder die Suche nach einem Sehstrahl für das dem Augenpunkt am nächsten liegenden Objekte,
 // können auch zusammen in eine Datenstruktur für die gesammte zu
@@ -45,74 +39,128 @@ struct material{
     bool is_transmissive = false;
 };
 
+// verschiedene Materialdefinition, z.B. Mattes Schwarz, Mattes Rot, Reflektierendes Weiss, ...
+// im wesentlichen Konstanten, die schon zur Compile-Zeit initialisiert werden.
+constexpr material MATTE_WHITE = {{0.8f, 0.8f, 0.8f}, 0.25f};
+constexpr material MATTE_RED = {{0.8f, 0.3f, 0.3f}, 0.25f};
+constexpr material MATTE_GREEN = {{0.3f, 0.8f, 0.3f}, 0.25f};
+constexpr material MATTE_BLUE = {{0.3f, 0.3f, 0.8f}, 0.25f};
+constexpr material MATTE_BLACK = {{0.2f, 0.2f, 0.2f}, 0.25f};
+
+constexpr material MIRROR = {{0.0f, 0.0f, 0.0f}, 0.25f, 1.0f, 0.9f, false};
+constexpr material GLASS = {{1.0f, 1.0f, 1.0f}, 0.25f, 1.52f, 0.9f, true};
+
 // Ein "Objekt", z.B. eine Kugel oder ein Dreieck, und dem zugehörigen Material der Oberfläche.
 // Im Prinzip ein Wrapper-Objekt, das mindestens Material und geometrisches Objekt zusammenfasst.
-// Kugel und Dreieck finden Sie in geometry.h/tcc
+// Kugel, Ebene, Quader und Dreieck finden Sie in geometry.h/tcc
 struct hitable{
-    Sphere3df sphere = {{0.0f, 0.0f, 0.0f}, -1.0f};
+    std::variant<Sphere3df, Plane3df, Box3df> geometry = Sphere3df{{0.0f, 0.0f, 0.0f}, -1.0f};
     material mat = MATTE_BLACK;
+
+    // Schnitt mit der jeweiligen Geometrie, t ist 0 wenn kein Schnittpunkt existiert
+    float intersects(const Ray3df &ray) const {
+        return std::visit([&ray](const auto &shape) -> float { return shape.intersects(ray); }, geometry);
+    }
+
+    bool intersects(const Ray3df &ray, Intersection_Context<float, 3> &context) const {
+        return std::visit([&](const auto &shape) -> bool { return shape.intersects(ray, context); }, geometry);
+    }
+
+    AABB3df get_bounding_box() const {
+        return std::visit([](const auto &shape) -> AABB3df { return shape.get_bounding_box(); }, geometry);
+    }
 };
 
-// Punktförmige "Lichtquellen" können einfach als Vector3df implementiert werden mit weisser Farbe,
-// bei farbigen Lichtquellen müssen die entsprechenden Daten in Objekt zusammengefaßt werden
-// Bei mehreren Lichtquellen können diese in einen std::vector gespeichert werden.
-struct light{
-    Vector3df pos;
-    float intensity;
+// Die Cornelbox aufgebaut aus den Objekten, als Konstante bereits zur Compile-Zeit berechnet
+constexpr hitable CORNELL_BOX[] = {
+    {Plane3df{{0, -10, 0}, {0, 1, 0}}, MATTE_WHITE}, // Boden
+    {Plane3df{{0, 10, 0}, {0, -1, 0}}, MATTE_WHITE}, // Decke
+    {Plane3df{{0, 0, -50}, {0, 0, 1}}, MATTE_WHITE}, // Wand hinten
+    //{Plane3df{{0, 0, 1}, {0, 0, -1}}, MATTE_WHITE}, // Wand vorne
+    {Plane3df{{-10, 0, 0}, {1, 0, 0}}, MATTE_RED}, // Wand links
+    {Plane3df{{10, 0, 0}, {-1, 0, 0}}, MATTE_GREEN}, // Wand rechts
+
+    {Sphere3df{{-5.0f, -6.0f, -24.5f}, 3.5f}, MATTE_BLUE},
+
+    {Sphere3df{{-3, -6.5f, -36.5f}, 4}, MIRROR},
+    {Sphere3df{{4, -6.5f, -32.0f}, 4}, GLASS},
 };
 
-bool hit_anything(Ray3df to_light, std::vector<hitable> &world){
-    for (auto obj : world){
-        float t = obj.sphere.intersects(to_light);
-        if (0 < t && t < 1){
-            return true;
-        }
+// Die Szene: alle Objekte in einer Beschleunigungsstruktur (acceleration.h), die den nächsten
+// Schnittpunkt eines Sehstrahls (closest_hit) bzw. irgendeinen Schnittpunkt eines Schattenstrahls
+// (any_hit) findet. Welche Struktur verwendet wird, wird zur Laufzeit in main() gewählt.
+using scene = AccelerationStructure<float, 3u, hitable>;
+
+// Versatz der Sekundärstrahlen von der Oberfläche (gegen Schattenakne)
+// Mit Ebenen statt riesiger Kugeln als Wände reicht ein kleiner Wert
+constexpr float RAY_OFFSET = 0.001f;
+
+// Punktförmige "Lichtquellen" mit Position und Intensität (light_tree.h)
+// Bei mehreren Lichtquellen werden diese in einem LightTree gespeichert.
+using light = PointLight3df;
+
+// Bis zu dieser Anzahl Lichtquellen werden alle Lichtquellen ausgewertet, darüber werden
+// so viele Lichtquellen pro Schnittpunkt aus dem LightTree gezogen.
+constexpr size_t MAX_LIGHT_SAMPLES = 8;
+
+
+// Beitrag einer einzelnen Lichtquelle für den Punkt origin mit Normale normal: Kosinus des
+// Einfallswinkels mit quadratischem Abfall über den Abstand, wie ihn der LightTree beim Ziehen schätzt.
+// Lichtquellen hinter der Oberfläche liefern 0, ohne einen Schattenstrahl zu verfolgen
+float direct_light(const light &light, Vector3df origin, Vector3df normal, const scene &world){
+    Vector3df to_light_direction = light.position - origin;
+    float cos_angle = normal * to_light_direction;
+    if (cos_angle <= 0.0f){
+        return 0.0f;
+    }
+    // Überprüfen, ob der Strahl zum Licht ein Objekt trifft
+    if (world.any_hit({origin, to_light_direction}, 1.0f)){
+        return 0.0f;
     }
-    return false;
+    float distance = to_light_direction.length();
+    return light.intensity * cos_angle / (distance * distance * distance);
 }
 
-
 // Sie benötigen eine Implementierung von Lambertian-Shading, z.B. als Funktion
 // Benötigte Werte können als Parameter übergeben werden, oder wenn diese Funktion eine Objektmethode eines
 // Szene-Objekts ist, dann kann auf die Werte teilweise direkt zugegriffen werden.
 // Bei mehreren Lichtquellen muss der resultierende diffuse Farbanteil durch die Anzahl Lichtquellen geteilt werden.
 // Lambertian Shading-Funktion
-color lambertian(hitable closest, Intersection_Context<float, 3> context, std::vector<hitable> &world, std::vector<light> &lights){
-    // Überprüfen, ob es ein gültiges closest hitable-Objekt ist
-    if (closest.sphere.radius != -1){
-        // Initialisierung der Lichtintensität
-        float total_light_intensity = 0.0f;
+color lambertian(const hitable &closest, Intersection_Context<float, 3> context, const scene &world, const LightTree3df &lights){
+    // Initialisierung der Lichtintensität
+    float total_light_intensity = 0.0f;
+
+    // Ursprung der Schattenstrahlen mit leichtem Offset vom Schnittpunkt (gegen Schattenakne)
+    Vector3df shadow_origin = context.intersection + RAY_OFFSET * context.normal;
 
+    if (lights.size() <= MAX_LIGHT_SAMPLES){
         // Iteration über alle Lichtquellen in der Szene
-        for (const auto &light : lights){
-            // Berechnung der Richtung zum Licht und Normalisierung
-            Vector3df to_light_direction = light.pos - context.intersection;
-            Vector3df to_light_normalized = to_light_direction;
-            to_light_normalized.normalize();
-
-            // Erzeugen eines Strahls zum Licht mit leichtem Offset vom Schnittpunkt (gegen Schattenakne)
-            Ray3df to_light_ray = {context.intersection + 0.08f * to_light_normalized, 0.92f * to_light_direction};
-
-            // Überprüfen, ob der Strahl das closest hitable-Objekt trifft
-            if (!hit_anything(to_light_ray, world)){
-                // Berechnung der Lichtintensität durch Lambertian Shading
-                total_light_intensity += light.intensity * std::max(0.0f, context.normal * to_light_normalized);
+        for (const auto &light : lights.get_lights()){
+            total_light_intensity += direct_light(light, shadow_origin, context.normal, world);
+        }
+    }
+    else{
+        // Stichprobe von MAX_LIGHT_SAMPLES Lichtquellen, gewichtet mit 1 / pdf,
+        // liefert im Mittel die Summe über alle Lichtquellen
+        for (size_t i = 0; i < MAX_LIGHT_SAMPLES; i++){
+            float pdf;
+            const light *sampled = lights.sample(shadow_origin, context.normal, random_float(), pdf);
+            if (sampled != nullptr){
+                total_light_intensity += direct_light(*sampled, shadow_origin, context.normal, world) / (pdf * MAX_LIGHT_SAMPLES);
             }
         }
+    }
 
-        // Durchschnittliche Lichtintensität über alle Lichtquellen
+    // Durchschnittliche Lichtintensität über alle Lichtquellen
+    if (lights.size() > 0){
         total_light_intensity /= lights.size();
-
-        // Berechnung der finalen Farbe mit Lambertian Shading
-        return (closest.mat.const_light + total_light_intensity) * closest.mat.col;
-    }
-    else{
-        // Rückgabe von Schwarz für ungültige closest hitable-Objekte
-        return {0.0f, 0.0f, 0.0f};
     }
+
+    // Berechnung der finalen Farbe mit Lambertian Shading
+    return (closest.mat.const_light + total_light_intensity) * closest.mat.col;
 }
 
-float schlick_approximation(Vector3df inbound, Vector3df normal, hitable obj){
+float schlick_approximation(Vector3df inbound, Vector3df normal, const hitable &obj){
     // Berechnung des Winkels zwischen dem einfallenden Strahl und der Normalen
     float cos_x = -1.0f * (normal * inbound);
 
@@ -142,7 +190,7 @@ float schlick_approximation(Vector3df inbound, Vector3df normal, hitable obj){
     return r0 + (1.0f - r0) * x * x * x * x * x;
 }
 
-bool refract(Ray3df in, Ray3df &out, hitable object, Intersection_Context<float, 3> context){
+bool refract(Ray3df in, Ray3df &out, const hitable &object, Intersection_Context<float, 3> context){
     Vector3df normal = context.normal;
     float n1 = 1.0f; // Brechungsindex des Vakuums
     float n2 = object.mat.density; // Brechungsindex des Materials
@@ -165,13 +213,13 @@ bool refract(Ray3df in, Ray3df &out, hitable object, Intersection_Context<float,
     // Berechnet die Richtung des gebrochenen Strahls
     out.direction = ratio_n1_n2 * in.direction + (ratio_n1_n2 * cos_theta - cos_phi) * normal;
     // Setzt den Ursprung des gebrochenen Strahls
-    out.origin = context.intersection + 0.08f * out.direction;
+    out.origin = context.intersection + RAY_OFFSET * out.direction;
     return true;
 }
 
 
 // Die rekursive raytracing-Methode. Am besten ab einer bestimmten Rekursionstiefe (z.B. als Parameter übergeben) abbrechen.
-color ray_color(Ray3df ray, int depth, std::vector<hitable> &world, std::vector<light> &lights){
+color ray_color(Ray3df ray, int depth, const scene &world, const LightTree3df &lights){
     // Überprüfe die Tiefe der Rekursion
     if (depth <= 0)
         return {0.0f, 0.0f, 0.0f};
@@ -179,34 +227,28 @@ color ray_color(Ray3df ray, int depth, std::vector<hitable> &world, std::vector<
 // Für einen Sehstrahl aus allen Objekte, dasjenige finden, das dem Augenpunkt am nächsten liegt.
 // Am besten einen Zeiger auf das Objekt zurückgeben. Wenn dieser nullptr ist, dann gibt es kein sichtbares Objekt.
     // Finde das nächstgelegene Objekt und seinen Treffpunkt
-    hitable closest;
-    float closest_t = std::numeric_limits<float>::max();
     Intersection_Context<float, 3> context;
-
-    for (auto obj : world){
-        Intersection_Context<float, 3> temp_context;
-        if (obj.sphere.intersects(ray, temp_context) && temp_context.t < closest_t){
-            closest = obj;
-            closest_t = temp_context.t;
-            context = temp_context;
-        }
-    }
+    const hitable *closest = world.closest_hit(ray, context);
 
     color col = {0, 0, 0};
 
+    // Kein sichtbares Objekt: Schwarz
+    if (closest == nullptr)
+        return col;
+
     // Berechne den Schlick-Reflexionskoeffizienten
-    float reflectivity = closest.mat.reflectivity;
-    float transparency = closest.mat.is_transmissive ? 1.0f - reflectivity : 0.0f;
+    float reflectivity = closest->mat.reflectivity;
+    float transparency = closest->mat.is_transmissive ? 1.0f - reflectivity : 0.0f;
 
     if (reflectivity > 0.0f){
         // Reflektion
-        Ray3df reflected_ray = {context.intersection + 0.08f * context.normal, 0.92f * ray.direction.get_reflective(context.normal)};
+        Ray3df reflected_ray = {context.intersection + RAY_OFFSET * context.normal, ray.direction.get_reflective(context.normal)};
         color reflection = reflectivity * ray_color(reflected_ray, depth - 1, world, lights);
 
         if (transparency > 0.0f){
             // Transmission
             Ray3df refracted_ray;
-            if (refract(ray, refracted_ray, closest, context)){
+            if (refract(ray, refracted_ray, *closest, context)){
                 color transmission = transparency * ray_color(refracted_ray, depth - 1, world, lights);
                 col += 0.5f * (reflection + transmission);
             }
@@ -222,13 +264,13 @@ color ray_color(Ray3df ray, int depth, std::vector<hitable> &world, std::vector<
     else if (transparency > 0.0f){
         // Nur Transmission
         Ray3df refracted_ray;
-        if (refract(ray, refracted_ray, closest, context)){
+        if (refract(ray, refracted_ray, *closest, context)){
             col += transparency * ray_color(refracted_ray, depth - 1, world, lights);
         }
     }
     else{
         // Lambertian-Shading
-        col += lambertian(closest, context, world, lights);
+        col += lambertian(*closest, context, world, lights);
     }
 
     return col;
@@ -239,8 +281,11 @@ color ray_color(Ray3df ray, int depth, std::vector<hitable> &world, std::vector<
 // Eine "Kamera", die von einem Augenpunkt aus in eine Richtung senkrecht auf ein Rechteck (das Bild) zeigt.
 // Für das Rechteck muss die Auflösung oder alternativ die Pixelbreite und -höhe bekannt sein.
 // Für ein Pixel mit Bildkoordinate kann ein Sehstrahl erzeugt werden.
+// Die Kamera liegt in Kamerakoordinaten im Ursprung und schaut in Richtung -z, die affine
+// Transformation camera (Kamera- nach Weltkoordinaten) legt Position und Blickrichtung fest.
 
-Vector3df get_ray_direction(int pos_v, int pos_u, int image_width, int image_height, float aspect_ratio, float focal_length, Vector3df cam_center){
+// Richtung des Sehstrahls für ein Pixel in Kamerakoordinaten (nicht normiert)
+Vector3df get_ray_direction(int pos_v, int pos_u, int image_width, int image_height, float aspect_ratio, float focal_length){
     image_height = static_cast<int>(image_width / aspect_ratio);
     image_height = (image_height < 1) ? 1 : image_height;
 
@@ -257,26 +302,31 @@ Vector3df get_ray_direction(int pos_v, int pos_u, int image_width, int image_hei
     Vector3df pixel_delta_v = 1.0f/image_height * viewport_v;
 
     // Calculate the location of the upper left pixel.
-    Vector3df viewport_upper_left = cam_center - Vector3df{0, 0, focal_length} - 0.5f * viewport_u - 0.5f * viewport_v;
-
-    // Calculate the location of the current pixel.
-    Vector3df pixel_position = viewport_upper_left + static_cast<float>(pos_u) * pixel_delta_u + static_cast<float>(pos_v) * pixel_delta_v;
+    Vector3df viewport_upper_left = Vector3df{0, 0, -focal_length} - 0.5f * viewport_u - 0.5f * viewport_v;
 
-    // Berechne die Richtung des Strahls vom Kamerastandpunkt zur Pixelposition
-    Vector3df ray_direction = pixel_position - cam_center;
-    ray_direction.normalize();
+    // Calculate the location of the current pixel, the direction from the camera at the origin.
+    Vector3df ray_direction = viewport_upper_left + static_cast<float>(pos_u) * pixel_delta_u + static_cast<float>(pos_v) * pixel_delta_v;
 
     return ray_direction;
 }
 
 
 // - für jeden einzelnen Pixel Farbe bestimmen
-void render_sdl2(SDL_Renderer *pRenderer, int image_width, int image_height, int max_depth, std::vector<hitable> &world, std::vector<light> &lights, Vector3df cam_center, float focal_length, float aspect_ratio) {
+// Die Richtungen einer Bildzeile werden in einem Aufruf in Weltkoordinaten transformiert.
+void render_sdl2(SDL_Renderer *pRenderer, int image_width, int image_height, int max_depth, const scene &world, const LightTree3df &lights, const Matrix3x4df &camera, float focal_length, float aspect_ratio) {
+    Vector3df cam_center = camera.transform_point({0.0f, 0.0f, 0.0f});
+    std::vector<Vector3df> ray_directions(image_width);
+
     for (int v = 0; v < image_height; v++) {
+        // Berechne die Richtungen der Strahlen für die aktuelle Bildzeile
         for (int u = 0; u < image_width; u++) {
+            ray_directions[u] = get_ray_direction(v, u, image_width, image_height, aspect_ratio, focal_length);
+        }
+        camera.transform_directions(ray_directions, ray_directions);
 
-            // Berechne die Richtung des Strahls für die aktuelle Pixelposition
-            Vector3df ray_direction = get_ray_direction(v, u, image_width, image_height, aspect_ratio, focal_length, cam_center);
+        for (int u = 0; u < image_width; u++) {
+            Vector3df ray_direction = ray_directions[u];
+            ray_direction.normalize();
 
             // Erstelle einen Strahl für die aktuelle Pixelposition
             Ray3df ray = {cam_center, ray_direction};
@@ -284,6 +334,11 @@ void render_sdl2(SDL_Renderer *pRenderer, int image_width, int image_height, int
             // Berechne die Farbe für den Strahl
             color pixel_color = ray_color(ray, max_depth, world, lights);
 
+            // Farbanteile über 1 abschneiden (z.B. durch gewichtete Lichtstichproben), sonst läuft Uint8 über
+            for (size_t i = 0; i < 3; i++){
+                pixel_color[i] = std::min(1.0f, pixel_color[i]);
+            }
+
             // Setze die Renderfarbe basierend auf den RGB-Werten der berechneten Pixelfarbe
             SDL_SetRenderDrawColor(pRenderer, static_cast<Uint8>(pixel_color[0] * 255), static_cast<Uint8>(pixel_color[1] * 255), static_cast<Uint8>(pixel_color[2] * 255), 255);
 
@@ -328,6 +383,8 @@ int main(void){
     int max_depth = 10;
 
     Vector3df cam_center = {0.0f, 0.0f, 0.0f};
+    // Kamera- nach Weltkoordinaten, z.B. mit Matrix3x4df::rotation für eine gedrehte Kamera
+    Matrix3x4df camera = Matrix3x4df::translation(cam_center);
     float focal_length = 2.0f;
     float aspect_ratio = 16.0f / 9.0f;
     int image_height = image_width / aspect_ratio;
@@ -335,29 +392,39 @@ int main(void){
 
     // Die Cornelbox aufgebaut aus den Objekten
     // Am besten verwendet man hier einen std::vector< ... > von Objekten.
-    std::vector<hitable> world;
+    std::vector<hitable> world(std::begin(CORNELL_BOX), std::end(CORNELL_BOX));
     std::vector<light> lights;
 
-    world.push_back({{{0, -100000, 0}, 99990}, MATTE_WHITE}); // Boden
-    world.push_back({{{0, 100000, 0}, 99990}, MATTE_WHITE}); // Decke
-    world.push_back({{{0, 0, -100000}, 99950}, MATTE_WHITE}); // Wand hinten
-    //world.push_back({{{0, 0, 100000}, 99999}, MATTE_WHITE}); // Wand vorne
-    world.push_back({{{-100000, 0, 0}, 99990}, MATTE_RED}); // Wand links
-    world.push_back({{{100000, 0, 0}, 99990}, MATTE_GREEN}); // Wand rechts
-
-    world.push_back({{{-5.0f, -6.0f, -24.5f}, 3.5f}, MATTE_BLUE});
+    // Viele Lichtquellen über die Umgebungsvariable RAYTRACER_LIGHTS=many: ein Raster von 32 x 32
+    // Lichtquellen unter der Decke, die aus dem LightTree gezogen werden. Sonst eine Lichtquelle
+    const char *light_setup = std::getenv("RAYTRACER_LIGHTS");
+    if (light_setup != nullptr && std::strcmp(light_setup, "many") == 0){
+        for (int i = 0; i < 32; i++){
+            for (int k = 0; k < 32; k++){
+                lights.push_back({{-9.0f + 18.0f * i / 31.0f, 9.0f, -49.0f + 29.0f * k / 31.0f}, 300.0f});
+            }
+        }
+    }
+    else{
+        lights.push_back({{-1.0f, 8.0f, -40.0f}, 300.0f});
+    }
 
-    world.push_back({{{-3, -6.5f, -36.5f}, 4}, MIRROR});
-    world.push_back({{{4, -6.5f, -32.0f}, 4}, GLASS});
+    LightTree3df light_bvh(lights);
 
-    lights.push_back({{-1.0f, 8.0f, -40.0f}, 1.0f});
+    // Beschleunigungsstruktur über die Umgebungsvariable RAYTRACER_ACCELERATION wählbar: kdtree (Standard) oder list
+    const char *acceleration = std::getenv("RAYTRACER_ACCELERATION");
+    AccelerationStructureType acceleration_type = AccelerationStructureType::kd_tree;
+    if (acceleration != nullptr && std::strcmp(acceleration, "list") == 0){
+        acceleration_type = AccelerationStructureType::list;
+    }
+    std::unique_ptr<scene> world_structure = make_acceleration_structure<float, 3u>(acceleration_type, world);
 
 
 
     SDL_Window *sdl_screen = create_screen(image_width, image_height);
     SDL_Renderer *renderer = SDL_CreateRenderer(sdl_screen, -1, SDL_RENDERER_ACCELERATED);
 
-    render_sdl2(renderer, image_width, image_height, max_depth, world, lights, cam_center, focal_length, aspect_ratio);
+    render_sdl2(renderer, image_width, image_height, max_depth, *world_structure, light_bvh, camera, focal_length, aspect_ratio);
 
     SDL_RenderPresent(renderer);
 